@@ -0,0 +1,87 @@
+#ifndef ABF_H
+#define ABF_H
+
+#pragma once
+#include "LSCM.h"
+#include "UVChart.h"
+
+/**
+ * @struct ABFOptions
+ * @brief Solver settings of the angle based flattening.
+ */
+struct ABFOptions {
+    unsigned int maxIterations = 5;  ///< Newton step limit; fewer steps trade angle distortion for time
+    double tolerance = 1e-3;  ///< Root mean square of the Lagrangian gradient at which Newton stops
+    double linearTolerance = 1e-6;  ///< Relative residual of the reduced system solved in every step
+    double layoutTolerance = 1e-5;  ///< Relative residual of the final layout, which starts close to the solution
+    LSCMOptions lscm;  ///< Settings of the LSCM warm start and multigrid use
+};
+
+/**
+ * @struct AngleDistortion
+ * @brief Deviation of the texture space corner angles from the surface angles.
+ */
+struct AngleDistortion {
+    double mean = 0.0;  ///< Mean absolute deviation in degrees
+    double max = 0.0;  ///< Largest absolute deviation in degrees
+};
+
+/**
+ * @struct ABFReport
+ * @brief Statistics of one chart flattening.
+ */
+struct ABFReport {
+    LSCMReport initial;  ///< LSCM warm start
+    LSCMReport layout;  ///< Layout of the optimized angles
+    AngleDistortion initialDistortion;  ///< Angle distortion of the LSCM warm start
+    AngleDistortion distortion;  ///< Angle distortion of the result
+    unsigned int newtonIterations = 0;  ///< Newton steps taken
+    unsigned int linearIterations = 0;  ///< Conjugate gradient iterations of all Newton steps
+    double gradientNorm = 0.0;  ///< Final root mean square of the Lagrangian gradient
+    bool converged = false;  ///< True if the gradient tolerance was reached
+    bool applied = false;  ///< False if the chart kept the LSCM result (closed chart or failed solve)
+    double angleMs = 0.0;  ///< Time spent optimizing the angles
+};
+
+/**
+ * @class ABF
+ * @brief Angle Based Flattening with the ABF++ solver (Sheffer et al. 2005).
+ *
+ * Finds the planar corner angles closest to the surface angles, in the
+ * relative sense sum w (alpha - beta)^2 with w = 1 / beta^2, subject to the
+ * triangle (angles sum to pi), planarity (angles around an interior vertex
+ * sum to 2 pi) and reconstruction (sine law around an interior vertex)
+ * constraints. The reconstruction constraint is used in its logarithmic
+ * form, sum log sin(next) = sum log sin(previous), whose derivatives do not
+ * depend on the vertex valence.
+ *
+ * Every Newton step eliminates the angles and the triangle multipliers,
+ * which couple only within a triangle, and solves the reduced 2 x 2 block
+ * per vertex system of the vertex multipliers with conjugate gradients. The
+ * iteration starts from the angles of the LSCM layout, which already satisfy
+ * all constraints, and the final layout is the LSCM fit of the optimized
+ * angles warm-started from the same layout.
+ */
+class ABF {
+public:
+    /**
+     * @brief Computes low angle distortion texture coordinates for a chart.
+     *
+     * Closed charts, and charts where the optimization fails or does not
+     * improve on it, keep the LSCM layout.
+     *
+     * @param chart Chart to parameterize; its uvs are overwritten.
+     * @param options Solver settings.
+     * @return Statistics of the solve.
+     */
+    static ABFReport parameterize(UVChart& chart, const ABFOptions& options = ABFOptions());
+
+    /**
+     * @brief Measures the angle distortion of a chart layout (multithreaded).
+     * @param chart Chart with texture coordinates.
+     * @return The distortion; zero for charts without triangles.
+     */
+    static AngleDistortion angleDistortion(const UVChart& chart);
+};
+
+#endif // ABF_H
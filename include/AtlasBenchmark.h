@@ -0,0 +1,35 @@
+#ifndef ATLAS_BENCHMARK_H
+#define ATLAS_BENCHMARK_H
+
+#pragma once
+#include "AtlasPacker.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class AtlasBenchmark
+ * @brief Times the atlas packer on many synthetic charts.
+ *
+ * The charts are fans of random size, aspect and orientation with every
+ * third rim vertex pulled in, so they are concave the way segmented charts
+ * usually are. The same seeded set is packed once with the skyline packer
+ * alone and once with raster compaction; no mesh or GL context is needed.
+ */
+class AtlasBenchmark {
+public:
+    /**
+     * @brief Packs the charts with both packers and prints a comparison.
+     * @param chartCount Charts generated.
+     * @param options Atlas size and padding; raster packing is overridden per run.
+     * @return One report per packer, skyline first.
+     */
+    static std::vector<AtlasReport> run(size_t chartCount, const AtlasOptions& options);
+
+private:
+    /**
+     * @brief Generates the synthetic charts, the same for every call.
+     */
+    static std::vector<UVChart> makeCharts(size_t chartCount);
+};
+
+#endif // ATLAS_BENCHMARK_H
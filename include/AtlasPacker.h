@@ -0,0 +1,80 @@
+#ifndef ATLAS_PACKER_H
+#define ATLAS_PACKER_H
+
+#pragma once
+#include "UVChart.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct AtlasOptions
+ * @brief Target and packing settings of a texture atlas.
+ */
+struct AtlasOptions {
+    unsigned int resolution = 1024;  ///< Width and height of the atlas in texels
+    unsigned int padding = 2;  ///< Minimum gap in texels between charts and to the atlas border
+    bool rotateCharts = true;  ///< Align charts with their smallest bounding rectangle and allow quarter turns
+    bool rasterPacking = false;  ///< Slide the packed charts together by their rasterized shapes (denser, slower)
+};
+
+/**
+ * @struct AtlasReport
+ * @brief Statistics of one atlas packing.
+ */
+struct AtlasReport {
+    unsigned int resolution = 0;  ///< Width and height of the atlas the charts were packed into
+    float texelsPerUnit = 0.0f;  ///< Scale from chart units to atlas texels, the same for all charts
+    double utilization = 0.0;  ///< Fraction of the atlas area covered by chart triangles
+    size_t rotatedCharts = 0;  ///< Charts placed with a quarter turn
+    unsigned int attempts = 0;  ///< Packing passes of the scale search
+    double packMs = 0.0;  ///< Time spent packing
+};
+
+/**
+ * @class AtlasPacker
+ * @brief Packs parameterized charts into a single square texture atlas.
+ *
+ * Every chart is first turned to its minimum-area bounding rectangle
+ * (rotating calipers over the convex hull of its texture coordinates).
+ * The bounding rectangles, grown by the padding, are then placed with a
+ * bottom-left skyline packer that tries both quarter turns of every chart,
+ * largest charts first. With raster packing the placed charts are also
+ * rasterized conservatively and slid down and left against the texels
+ * already covered, so concave charts interlock.
+ *
+ * All charts share one scale, so their relative texel density is kept; a
+ * bisection over that scale finds the largest one whose skyline packing
+ * still fits the atlas. Raster packing then bisects only a little above it,
+ * since every raster pass costs far more than a skyline pass. Chart
+ * preparation and rasterization run on the thread pool.
+ */
+class AtlasPacker {
+public:
+    /**
+     * @brief Packs charts into the atlas.
+     * @param charts Parameterized charts; their uvs are replaced by atlas
+     *        coordinates in [0,1].
+     * @param options Atlas size and packing settings.
+     * @return Statistics of the packing.
+     */
+    static AtlasReport pack(std::vector<UVChart>& charts, const AtlasOptions& options = AtlasOptions());
+
+    /**
+     * @brief Packs charts into the smallest atlas that reaches a texel density.
+     *
+     * Power-of-two resolutions are tried from the smallest one that could
+     * hold the chart area at the target density upwards, up to the limit,
+     * whose packing is kept even if it falls short.
+     *
+     * @param charts Parameterized charts; their uvs are replaced by atlas
+     *        coordinates in [0,1].
+     * @param options Packing settings; the resolution is chosen here.
+     * @param texelsPerUnit Texels per chart space unit the atlas must reach.
+     * @param maxResolution Largest resolution to try.
+     * @return Statistics of the kept packing, including its resolution.
+     */
+    static AtlasReport packAtDensity(std::vector<UVChart>& charts, const AtlasOptions& options, float texelsPerUnit,
+                                     unsigned int maxResolution);
+};
+
+#endif // ATLAS_PACKER_H
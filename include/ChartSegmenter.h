@@ -0,0 +1,61 @@
+#ifndef CHART_SEGMENTER_H
+#define CHART_SEGMENTER_H
+
+#pragma once
+#include "PositionArray.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct SegmentationOptions
+ * @brief Thresholds of the chart segmentation.
+ */
+struct SegmentationOptions {
+    float maxConeAngle = 60.0f;  ///< Largest angle in degrees between a face normal and the average normal of its chart
+    float creaseAngle = 75.0f;  ///< Edges whose faces bend by more than this many degrees are always cut
+};
+
+/**
+ * @struct Segmentation
+ * @brief Result of the chart segmentation.
+ */
+struct Segmentation {
+    std::vector<unsigned int> chartOfFace;  ///< Chart of every triangle
+    size_t chartCount = 0;  ///< Number of charts
+    size_t componentCount = 0;  ///< Pieces left after cutting the crease and non-manifold edges
+    size_t seamEdges = 0;  ///< Edges between two charts or on an open border
+    size_t discSplits = 0;  ///< Charts that were split again to reach disc topology
+};
+
+/**
+ * @class ChartSegmenter
+ * @brief Splits a triangle mesh into disc-shaped charts for unwrapping.
+ *
+ * Works on the face adjacency graph. Non-manifold edges, edges whose two
+ * faces disagree on orientation and crease edges are cut first, and the
+ * remaining connected components are segmented independently (in
+ * parallel). Within a component, charts grow from seed faces over the
+ * flattest neighbors first, as long as every face stays within a normal
+ * cone around the average normal of the chart, so the seams settle on
+ * high-curvature edges. Charts that are not topological discs (holes,
+ * vertices where the chart touches itself) are split in two by growing from
+ * two distant faces, until every chart is a disc.
+ *
+ * Apart from the priority queue of the region growing, every pass is linear
+ * in the face count; the labels do not depend on the thread count.
+ */
+class ChartSegmenter {
+public:
+    /**
+     * @brief Segments a triangle mesh into charts.
+     * @param positions Vertex positions.
+     * @param indices Triangle list.
+     * @param options Segmentation thresholds.
+     * @return The chart of every triangle; charts are numbered by component
+     *         and, within a component, in the order they were grown.
+     */
+    static Segmentation segment(const PositionArray& positions, const std::vector<unsigned int>& indices,
+                                const SegmentationOptions& options = SegmentationOptions());
+};
+
+#endif // CHART_SEGMENTER_H
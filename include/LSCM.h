@@ -0,0 +1,90 @@
+#ifndef LSCM_H
+#define LSCM_H
+
+#pragma once
+#include "SparseMatrix.h"
+#include "UVChart.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct LSCMOptions
+ * @brief Solver settings of the LSCM parameterization.
+ */
+struct LSCMOptions {
+    double tolerance = 1e-4;  ///< Relative residual at which conjugate gradients stops (the distortion no longer improves below it)
+    unsigned int maxIterations = 2000;  ///< Conjugate gradient iteration limit per chart
+    bool multigrid = true;  ///< Precondition large charts with algebraic multigrid instead of Jacobi
+};
+
+/**
+ * @struct LSCMReport
+ * @brief Statistics of one chart parameterization.
+ */
+struct LSCMReport {
+    SolverReport solver;  ///< Conjugate gradient outcome
+    size_t unknowns = 0;  ///< Rows of the normal equations (2 per vertex)
+    size_t nonZeros = 0;  ///< Stored entries of the normal equations
+    size_t multigridLevels = 0;  ///< Levels of the multigrid preconditioner (0 for Jacobi)
+    double assemblyMs = 0.0;  ///< Time spent building the sparse system
+    double solveMs = 0.0;  ///< Time spent in conjugate gradients
+};
+
+/**
+ * @class LSCM
+ * @brief Least Squares Conformal Maps (Levy et al. 2002).
+ *
+ * Minimizes the conformal energy sum_T area(T) |grad v - rot90(grad u)|^2
+ * over the chart with two vertices pinned. The normal equations are
+ * assembled directly in CSR form (one 2x2 block per vertex pair sharing a
+ * triangle) in parallel per vertex, and solved with conjugate gradients
+ * warm-started from a planar projection of the chart. Large charts use a
+ * smoothed aggregation multigrid preconditioner, which keeps the iteration
+ * count nearly constant as the chart grows; small ones use Jacobi.
+ *
+ * The chart should be a topological disc; closed charts flatten with large
+ * distortion and should be cut first.
+ */
+class LSCM {
+public:
+    /**
+     * @brief Computes conformal texture coordinates for a chart.
+     *
+     * Chart-space UVs keep roughly the scale of the input positions.
+     * Charts without a non-degenerate triangle get the planar projection.
+     *
+     * @param chart Chart to parameterize; its uvs are overwritten.
+     * @param options Solver settings.
+     * @return Statistics of the solve.
+     */
+    static LSCMReport parameterize(UVChart& chart, const LSCMOptions& options = LSCMOptions());
+
+    /**
+     * @brief Computes the layout whose triangles best match prescribed
+     *        corner angles (the reconstruction step of angle based flattening).
+     *
+     * The triangle shapes come from the angles instead of the positions;
+     * the current chart.uvs are the starting point and provide the pins
+     * (the planar projection is used if they are missing).
+     *
+     * @param chart Chart to parameterize; its uvs are overwritten.
+     * @param angles Three angles per triangle in radians, in corner order.
+     * @param options Solver settings.
+     * @return Statistics of the solve.
+     */
+    static LSCMReport parameterizeAngles(UVChart& chart, const std::vector<double>& angles,
+                                         const LSCMOptions& options = LSCMOptions());
+
+    /**
+     * @brief Projects a chart onto the plane perpendicular to its
+     *        area-weighted average normal.
+     *
+     * Used as the starting point of the solvers; charts whose normals cancel
+     * out (closed surfaces) are projected along their thinnest axis instead.
+     *
+     * @param chart Chart to project; its uvs are overwritten.
+     */
+    static void projectToPlane(UVChart& chart);
+};
+
+#endif // LSCM_H
@@ -0,0 +1,52 @@
+#ifndef LAYOUT_BENCHMARK_H
+#define LAYOUT_BENCHMARK_H
+
+#pragma once
+#include "Mesh.h"
+#include "Shader.h"
+#include <string>
+#include <vector>
+
+/**
+ * @struct LayoutBenchmarkResult
+ * @brief Timings of one vertex buffer layout.
+ */
+struct LayoutBenchmarkResult {
+    VertexLayout layout = VertexLayout::Interleaved;  ///< Layout measured
+    bool loaded = false;  ///< Whether the mesh could be loaded with this layout
+    double drawGpuMs = 0.0;  ///< GPU time of one static draw
+    double drawMs = 0.0;  ///< Wall time of one static draw, synchronized
+    double updateMs = 0.0;  ///< Wall time of one UV update followed by a draw, synchronized
+    double updateMB = 0.0;  ///< Buffer bytes the driver has to rewrite per UV update
+};
+
+/**
+ * @class LayoutBenchmark
+ * @brief Compares the interleaved and split vertex layouts on one mesh.
+ *
+ * The mesh is loaded once per layout and drawn with the given shader into the
+ * current framebuffer, first unchanged, then with its UVs scrolled every frame
+ * the way a dynamic UV edit or animation would. Every frame ends with
+ * glFinish so the wall time includes the upload and the draw it feeds.
+ */
+class LayoutBenchmark {
+public:
+    /**
+     * @brief Measures both layouts and prints a comparison.
+     * @param filename Model to load.
+     * @param options Load options; the layout is overridden per run.
+     * @param shader Shader the draws use.
+     * @param frames Frames measured per test.
+     * @return One result per layout, interleaved first.
+     */
+    static std::vector<LayoutBenchmarkResult> run(const std::string& filename, const MeshLoadOptions& options,
+                                                  const Shader& shader, unsigned int frames = 240);
+
+private:
+    /**
+     * @brief Draws the mesh once with the decode constants it needs.
+     */
+    static void draw(const Mesh& mesh, const Shader& shader);
+};
+
+#endif // LAYOUT_BENCHMARK_H
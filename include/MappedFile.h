@@ -0,0 +1,70 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a file on disk.
+ *
+ * The file contents are exposed as a contiguous byte range without copying
+ * them into a user-space buffer, so parsers can tokenize the data in place.
+ * The mapping is released when the object is destroyed.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Constructs an empty mapping.
+     */
+    MappedFile();
+
+    /**
+     * @brief Unmaps the file if one is mapped.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps a file into memory for reading.
+     *
+     * Any previously mapped file is released first. An empty file is opened
+     * successfully and reports a size of zero.
+     *
+     * @param filename Path to the file to map.
+     * @return True if the file was mapped, false otherwise.
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Releases the current mapping, if any.
+     */
+    void close();
+
+    /**
+     * @brief Gets a pointer to the first byte of the mapped file.
+     * @return Pointer to the mapped bytes, or nullptr if nothing is mapped.
+     */
+    const char* data() const { return mappedData; }
+
+    /**
+     * @brief Gets the size of the mapped file in bytes.
+     * @return The number of mapped bytes.
+     */
+    size_t size() const { return mappedSize; }
+
+private:
+    const char* mappedData;  ///< Start of the mapped view
+    size_t mappedSize;  ///< Size of the mapped view in bytes
+#ifdef _WIN32
+    void* fileHandle;  ///< Win32 file handle
+    void* mappingHandle;  ///< Win32 file mapping handle
+#else
+    int fileDescriptor;  ///< POSIX file descriptor
+#endif
+};
+
+#endif // MAPPED_FILE_H
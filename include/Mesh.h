@@ -4,9 +4,46 @@
 #pragma once
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include "AtlasPacker.h"
+#include "MeshTopology.h"
+#include "MeshletBuilder.h"
+#include "NormalGenerator.h"
+#include "PositionArray.h"
+#include "TexelDensity.h"
+#include "UVMetrics.h"
+#include "UVSmoother.h"
+#include "VertexFormat.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <string>
 
+class MeshCache;
+
+/**
+ * @struct MeshLoadOptions
+ * @brief Optional processing steps applied by Mesh::loadFromFile.
+ */
+struct MeshLoadOptions {
+    bool optimizeIndices = false;  ///< Weld duplicates and reorder triangles/vertices for the GPU caches
+    unsigned int vertexCacheSize = 16;  ///< Post-transform cache size targeted by the optimizer
+    bool useMeshCache = true;  ///< Load from / write to a binary cache next to the model file
+    bool retainCpuData = true;  ///< Keep CPU-side vertex/index copies after upload (false keeps only the GPU buffers); restored on first use for cache loads
+    VertexFormat vertexFormat;  ///< Encoding of the uploaded vertices (full float by default)
+    bool strictMath = false;  ///< Procedural UVs use std::atan2/std::asin instead of the SIMD approximations
+    std::string uvProjection = "auto";  ///< UVProjectorRegistry name for procedural UVs, "auto" to detect from the shape or "best" to measure
+    bool forceProceduralUVs = false;  ///< Replace texture coordinates present in the file with procedural ones
+    NormalOptions normals;  ///< Smooth normals for files without vn records
+    AtlasOptions atlas;  ///< Atlas of the chart based procedural UVs
+    UVSmoothingOptions uvSmoothing;  ///< Relaxation of the "segmented" procedural UVs
+    TexelDensityOptions texelDensity;  ///< Texel density of the chart based and "segmented" procedural UVs
+    bool measureUVs = false;  ///< Measure and log the distortion of freshly generated UVs (needs retainCpuData, skipped for cache loads)
+    UVMetricsOptions uvMetrics;  ///< Reference resolution of the UV measurement
+    bool buildTopology = false;  ///< Build the half-edge topology of the final buffers (needs retainCpuData)
+    MeshletOptions meshlets;  ///< Clusters of the final index buffer for culling in the renderer
+};
+
 /**
  * @class Mesh
  * @brief Represents a 3D mesh with vertex, UV, normal, and index data.
@@ -37,9 +74,61 @@ public:
      * normals, and indices.
      *
      * @param filename Path to the 3D model file.
+     * @param options Optional processing steps to run after loading.
      * @return True if the mesh is successfully loaded, false otherwise.
      */
-    bool loadFromFile(const std::string& filename);
+    bool loadFromFile(const std::string& filename, const MeshLoadOptions& options = MeshLoadOptions());
+
+    /**
+     * @brief Replaces the texture coordinates with a procedural projection
+     *        without reloading the mesh.
+     *
+     * Projects the retained positions again and rewrites only the UV bytes
+     * of every vertex in the existing VBO through a mapped range. Chart
+     * based projectors ("lscm", "abf") cut seams, which changes the vertex
+     * and index counts; the existing buffers are then refilled as a whole.
+     * Seams cut by an earlier projection stay cut. With a tangent encoding
+     * the tangents are generated again and the buffers are refilled as a
+     * whole too. The mesh cache is not updated.
+     *
+     * @param projection UVProjectorRegistry name, "auto" or "best".
+     * @param options Projection, measurement and topology settings; the
+     *        file and buffer options are ignored.
+     * @return False if the CPU-side data was not retained.
+     */
+    bool regenerateUVs(const std::string& projection, const MeshLoadOptions& options = MeshLoadOptions());
+
+    /**
+     * @brief Replaces the texture coordinates, e.g. for editing or animation.
+     *
+     * Only the texture coordinates are written to the GPU: with the split
+     * layout their own VBO is refilled, interleaved ones are written into a
+     * mapped range of the shared VBO between the other attributes. Tangents
+     * keep following the previous UVs; regenerateUVs() recomputes them.
+     *
+     * @param texcoords One texture coordinate per vertex.
+     * @return False if the count does not match or the CPU-side data was not retained.
+     */
+    bool updateUVs(const std::vector<glm::vec2>& texcoords);
+
+    /**
+     * @brief Restores the CPU-side streams of a mesh loaded from the cache.
+     *
+     * Cache loads only upload the mapped buffers and keep the mapping; the
+     * streams are decoded from it (lossy for quantized formats) when
+     * something first needs them. regenerateUVs() and updateUVs() call this
+     * themselves.
+     *
+     * @return True if the CPU-side data is available.
+     */
+    bool loadCpuData();
+
+    /**
+     * @brief Gets the CPU-side texture coordinates.
+     * @return One per vertex; empty unless MeshLoadOptions::retainCpuData was
+     *         set (for cache loads, until loadCpuData() was called).
+     */
+    const std::vector<glm::vec2>& getUVs() const { return uvs; }
 
     /**
      * @brief Binds the mesh's Vertex Array Object (VAO) for rendering.
@@ -68,23 +157,231 @@ public:
      */
     unsigned int getIndexCount() const { return indexCount; }
 
+    /**
+     * @brief Gets the encoding of the vertex buffer.
+     * @return The vertex format the mesh was uploaded with.
+     */
+    const VertexFormat& getVertexFormat() const { return vertexFormat; }
+
+    /**
+     * @brief Gets the constants the vertex shader needs to decode quantized attributes.
+     * @return The decode constants of the vertex buffer.
+     */
+    const VertexDecode& getVertexDecode() const { return vertexDecode; }
+
+    /**
+     * @brief Gets the size of the vertex buffer on the GPU.
+     * @return Vertex buffer size in bytes.
+     */
+    size_t getVertexBufferBytes() const { return static_cast<size_t>(vertexCount) * vertexFormat.stride(); }
+
+    /**
+     * @brief Gets the half-edge topology of the CPU-side buffers.
+     * @return The topology; empty unless MeshLoadOptions::buildTopology was
+     *         set or the "segmented" projector built it for its relaxation.
+     */
+    const MeshTopology& getTopology() const { return topology; }
+
+    /**
+     * @brief Gets the quality of the texture coordinates after loading.
+     * @return The report; empty unless MeshLoadOptions::measureUVs was set and the mesh was not loaded from the cache.
+     */
+    const UVMetricsReport& getUVMetrics() const { return uvMetrics; }
+
+    /**
+     * @brief Gets the clusters of the index buffer with their culling bounds.
+     *
+     * The bounding spheres are padded by the position quantization error of
+     * the vertex format, so they hold the positions as the GPU sees them.
+     * The meshlets are kept when the CPU-side data is released.
+     *
+     * @return Meshlets in index buffer order; empty unless MeshletOptions::build was set.
+     */
+    const std::vector<Meshlet>& getMeshlets() const { return meshlets; }
+
 private:
-    GLuint VAO, VBO, EBO;  ///< OpenGL buffer IDs for vertex data and indices
+    GLuint VAO, VBO, EBO;  ///< OpenGL buffer IDs for vertex data (positions only with the split layout) and indices
+    GLuint texcoordVBO, normalVBO, tangentVBO;  ///< Texture coordinate, normal and tangent streams of the split layout, 0 otherwise
     unsigned int vertexCount;  ///< Number of vertices in the mesh
     unsigned int indexCount;  ///< Number of indices in the mesh (if indexed)
 
-    std::vector<glm::vec3> vertices;  ///< List of vertex positions
+    PositionArray vertices;  ///< Vertex positions (structure-of-arrays)
     std::vector<glm::vec2> uvs;  ///< List of texture coordinates (UV mapping)
     std::vector<glm::vec3> normals;  ///< List of normal vectors for shading
+    std::vector<glm::vec4> tangents;  ///< Tangents with the bitangent sign in w (only with a tangent encoding)
     std::vector<unsigned int> indices;  ///< List of indices for indexed rendering
+    MeshTopology topology;  ///< Half-edge connectivity of vertices/indices over welded positions, cleared when they change
+    std::vector<Meshlet> meshlets;  ///< Clusters of consecutive triangles of indices
+    UVMetricsReport uvMetrics;  ///< Distortion of uvs over the mesh
+
+    VertexFormat vertexFormat;  ///< Encoding of the vertex buffer
+    VertexDecode vertexDecode;  ///< Decode constants for quantized attributes
+    std::unique_ptr<MeshCache> cachedData;  ///< Cache the CPU-side streams are restored from, open until then
+
+    /**
+     * @brief Welds duplicate vertices and reorders the index and vertex buffers.
+     *
+     * Runs a bitwise weld, Tipsify triangle reordering, cluster sorting for
+     * overdraw and a vertex fetch reorder, then logs ACMR/ATVR before and after.
+     *
+     * @param cacheSize Post-transform cache size to optimize for.
+     */
+    void optimizeBuffers(unsigned int cacheSize);
+
+    /**
+     * @brief Generates procedural UVs for all vertices with a UVProjector.
+     *
+     * The projection runs on the thread pool in vertex spans. With strictMath
+     * the result is bitwise identical to a serial evaluation; otherwise the
+     * vectorized trigonometry of MeshKernels is used (error below 3e-7 rad).
+     * Chart based projectors cut seams, which appends duplicated vertices
+     * and rewrites the indices.
+     *
+     * @param options Load options: the projector's registry name ("auto"
+     *        to pick one from the shape statistics, "best" to run the
+     *        per-vertex projectors and keep the best measured one), strict
+     *        math, and the atlas and relaxation settings.
+     * @param minBounds Minimum corner of the model's bounding box.
+     * @param maxBounds Maximum corner of the model's bounding box.
+     * @return Name of the projector that was used.
+     */
+    std::string generateProceduralUVs(const MeshLoadOptions& options, const glm::vec3& minBounds,
+                                      const glm::vec3& maxBounds);
+
+    /**
+     * @brief Generates MikkTSpace tangents for the current UVs and normals.
+     *
+     * Vertices shared by mirrored UV regions are duplicated, which appends
+     * vertices and rewrites the indices.
+     */
+    void generateTangents();
+
+    /**
+     * @brief Builds the half-edge topology from the current vertices and
+     *        indices unless it is already up to date, and logs its edge counts.
+     */
+    void buildTopology();
+
+    /**
+     * @brief Partitions the current indices into meshlets and pads their
+     *        spheres by the position quantization error of the vertex
+     *        format, then logs their statistics.
+     * @param options Vertex and triangle limits.
+     */
+    void buildMeshlets(const MeshletOptions& options);
+
+    /**
+     * @brief Measures the distortion of the current UVs, detects overlapping triangles with measureOverlap and logs both.
+     * @param options Reference resolution of the measurement.
+     */
+    void measureUVs(const UVMetricsOptions& options);
+
+    /**
+     * @brief Derives the quantization ranges of the vertex format from the
+     *        current position and UV bounds.
+     */
+    void computeVertexDecode();
+
+    /**
+     * @brief Derives only the UV quantization range from the current UVs,
+     *        keeping the position encoding.
+     */
+    void computeTexcoordDecode();
+
+    /**
+     * @brief Gets the bounds of the current UVs.
+     * @param uvMin Receives the minimum, 0 without UVs.
+     * @param uvMax Receives the maximum, 0 without UVs.
+     */
+    void texcoordBounds(glm::vec2& uvMin, glm::vec2& uvMax) const;
+
+    /**
+     * @brief Interleaves a range of the CPU-side streams into the VBO layout.
+     * @param destination Receives vertexFormat.stride() bytes per vertex.
+     * @param first First vertex to write.
+     * @param count Number of vertices to write.
+     */
+    void fillVertexData(unsigned char* destination, size_t first, size_t count) const;
+
+    /**
+     * @brief Encodes a range of one CPU-side stream, tightly packed.
+     * @param attribute Attribute location (0 position, 1 UV, 2 normal, 3 tangent).
+     * @param destination Receives vertexFormat.attributeSize(attribute) bytes per vertex.
+     * @param first First vertex to write.
+     * @param count Number of vertices to write.
+     */
+    void fillAttributeData(unsigned int attribute, unsigned char* destination, size_t first, size_t count) const;
+
+    /** @brief VBO of an attribute: VBO when interleaved, else the attribute's stream. */
+    GLuint attributeBuffer(unsigned int attribute) const {
+        return attribute == 0 || vertexFormat.layout == VertexLayout::Interleaved ? VBO
+             : attribute == 1 ? texcoordVBO : attribute == 2 ? normalVBO : tangentVBO;
+    }
 
     /**
      * @brief Initializes OpenGL buffers and configures vertex attributes.
      *
-     * This function creates the VAO, VBO, and EBO, then sets up
-     * the vertex attributes needed for rendering.
+     * This function creates the VAO, the VBO (one per attribute with the
+     * split layout) and the EBO, uploads vertexCount vertices and indexCount
+     * indices, then sets up the vertex attributes needed for rendering.
+     *
+     * @param vertexData Interleaved vertex data in vertexFormat, or nullptr to
+     *        encode the CPU-side streams directly into the mapped VBOs.
+     * @param indexData Triangle list indices.
+     */
+    void setupMesh(const unsigned char* vertexData, const unsigned int* indexData);
+
+    /**
+     * @brief (Re)allocates a VBO for vertexCount vertices and fills it
+     *        through a mapping, or through a staging block if that fails.
+     * @param buffer VBO to fill; left bound to GL_ARRAY_BUFFER.
+     * @param vertexBytes Bytes per vertex.
+     * @param fill fill(destination, first, count) encodes a vertex range.
+     */
+    void writeBuffer(GLuint buffer, size_t vertexBytes,
+                     const std::function<void(unsigned char*, size_t, size_t)>& fill);
+
+    /**
+     * @brief (Re)allocates the VBOs of the vertex layout for vertexCount
+     *        vertices and encodes the CPU-side streams into them.
+     */
+    void writeVertexBuffers();
+
+    /**
+     * @brief Rewrites the texture coordinates of every vertex on the GPU,
+     *        leaving positions and normals as they are.
+     * @return False if the interleaved VBO could not be mapped; nothing was
+     *         written then.
+     */
+    bool writeTexcoords();
+
+    /**
+     * @brief Frees the CPU-side vertex and index streams and the topology.
+     *
+     * The GPU buffers, the vertex/index counts and the meshlets are kept;
+     * an open cache mapping is closed.
+     */
+    void releaseCpuData();
+
+    /**
+     * @brief Restores the mesh from its binary cache if it is up to date.
+     *
+     * Uploads the mapped buffers and takes the meshlets stored with them.
+     * The CPU-side streams are only decoded for buildTopology; otherwise
+     * loadCpuData() restores them on first use while the mapping is kept.
+     *
+     * @param filename Path to the source model.
+     * @param options Load options the cache must have been built with.
+     * @return True if the mesh was loaded from the cache, false otherwise.
+     */
+    bool loadFromCache(const std::string& filename, const MeshLoadOptions& options);
+
+    /**
+     * @brief Fingerprints the load options that affect the processed buffers.
+     * @param options Load options.
+     * @return Key stored in and compared against the cache header.
      */
-    void setupMesh();
+    static uint64_t cacheKey(const MeshLoadOptions& options);
 
     /**
      * @brief Releases OpenGL resources used by the mesh.
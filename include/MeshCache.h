@@ -0,0 +1,142 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#pragma once
+#include "MappedFile.h"
+#include "MeshletBuilder.h"
+#include "VertexFormat.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @class MeshCache
+ * @brief Versioned binary cache of a fully processed mesh.
+ *
+ * A cache file stores a fixed header followed by the interleaved vertex
+ * blob (the layout uploaded by Mesh::setupMesh, in the mesh's VertexFormat)
+ * and the index blob, plus the constants needed to decode quantized
+ * attributes and the meshlets of the index buffer. It lives
+ * next to the source model and is only accepted if the source file's size
+ * and modification time and the processing options still match, so edits to
+ * the model or a change of load options transparently trigger a rebuild.
+ *
+ * Opening a cache maps it read-only; the blobs can be handed to OpenGL
+ * straight from the mapping.
+ */
+class MeshCache {
+public:
+    /**
+     * @brief Produces interleaved vertices on demand: writer(destination, first, count).
+     */
+    using VertexWriter = std::function<void(unsigned char*, size_t, size_t)>;
+
+    static const uint32_t kVersion = 7;  ///< Bumped whenever the file layout or the processing changes
+
+    /**
+     * @brief Constructs an empty, unopened cache.
+     */
+    MeshCache();
+
+    /**
+     * @brief Gets the path of the cache file that belongs to a model.
+     * @param sourcePath Path to the source model.
+     * @return The cache file path.
+     */
+    static std::string cachePathFor(const std::string& sourcePath);
+
+    /**
+     * @brief Maps the cache for a model if it exists and is up to date.
+     *
+     * Besides the header, every index is checked against the vertex count
+     * (multithreaded) and every meshlet against the index count, so a
+     * corrupt cache is rebuilt rather than read out of bounds.
+     *
+     * @param sourcePath Path to the source model.
+     * @param optionsKey Fingerprint of the processing options the cache must have been built with.
+     * @param format Expected vertex format.
+     * @return True if a valid cache was mapped, false otherwise.
+     */
+    bool open(const std::string& sourcePath, uint64_t optionsKey, const VertexFormat& format);
+
+    /**
+     * @brief Writes a cache file for a model.
+     *
+     * The data is written to a temporary file that is renamed into place,
+     * so a concurrent reader never sees a partial cache. Vertices are
+     * requested from the writer in bounded blocks, so no full interleaved
+     * copy of the mesh has to exist in memory.
+     *
+     * @param sourcePath Path to the source model.
+     * @param optionsKey Fingerprint of the processing options.
+     * @param vertexWriter Fills blocks of interleaved vertex data.
+     * @param format Vertex format produced by the writer.
+     * @param decode Constants needed to decode the quantized attributes.
+     * @param vertexCount Number of vertices.
+     * @param indexData Triangle list indices.
+     * @param indexCount Number of indices.
+     * @param meshletData Meshlets of the indices, may be null if meshletCount is 0.
+     * @param meshletCount Number of meshlets.
+     * @return True if the cache was written, false otherwise.
+     */
+    static bool write(const std::string& sourcePath, uint64_t optionsKey,
+                      const VertexWriter& vertexWriter, const VertexFormat& format,
+                      const VertexDecode& decode, size_t vertexCount,
+                      const unsigned int* indexData, size_t indexCount,
+                      const Meshlet* meshletData, size_t meshletCount);
+
+    /**
+     * @brief Gets the mapped interleaved vertex data.
+     * @return Pointer into the mapping, valid while the cache is open.
+     */
+    const unsigned char* vertexData() const { return vertices; }
+
+    /**
+     * @brief Gets the decode constants stored with the vertex blob.
+     * @return The decode constants.
+     */
+    const VertexDecode& vertexDecode() const { return decode; }
+
+    /**
+     * @brief Gets the number of cached vertices.
+     * @return The vertex count.
+     */
+    size_t vertexCount() const { return cachedVertexCount; }
+
+    /**
+     * @brief Gets the mapped index data.
+     * @return Pointer into the mapping, valid while the cache is open.
+     */
+    const unsigned int* indexData() const { return indices; }
+
+    /**
+     * @brief Gets the number of cached indices.
+     * @return The index count.
+     */
+    size_t indexCount() const { return cachedIndexCount; }
+
+    /**
+     * @brief Gets the mapped meshlets.
+     * @return Pointer into the mapping, valid while the cache is open.
+     */
+    const Meshlet* meshletData() const { return meshlets; }
+
+    /**
+     * @brief Gets the number of cached meshlets.
+     * @return The meshlet count, 0 if none were built.
+     */
+    size_t meshletCount() const { return cachedMeshletCount; }
+
+private:
+    MappedFile file;  ///< Mapping of the cache file
+    const unsigned char* vertices;  ///< Vertex blob inside the mapping
+    const unsigned int* indices;  ///< Index blob inside the mapping
+    const Meshlet* meshlets;  ///< Meshlet blob inside the mapping
+    size_t cachedVertexCount;  ///< Number of vertices in the blob
+    size_t cachedIndexCount;  ///< Number of indices in the blob
+    size_t cachedMeshletCount;  ///< Number of meshlets in the blob
+    VertexDecode decode;  ///< Decode constants of the vertex blob
+};
+
+#endif // MESH_CACHE_H
@@ -0,0 +1,139 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#pragma once
+#include "PositionArray.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct VertexCacheStats
+ * @brief Post-transform vertex cache efficiency of an index buffer.
+ */
+struct VertexCacheStats {
+    float acmr;  ///< Average cache miss ratio: transformed vertices per triangle (0.5 is ideal for large grids)
+    float atvr;  ///< Average transform to vertex ratio: transformed vertices per unique vertex (1.0 is ideal)
+};
+
+/**
+ * @class MeshOptimizer
+ * @brief Index and vertex buffer reordering for GPU-friendly triangle lists.
+ *
+ * The passes operate on plain triangle lists and express vertex changes as
+ * remap tables (remap[oldVertex] = newVertex), so the caller decides how its
+ * vertex streams are stored and applies the remap to each of them.
+ */
+class MeshOptimizer {
+public:
+    /**
+     * @brief Simulates a FIFO post-transform cache over an index buffer.
+     * @param indices Triangle list indices.
+     * @param vertexCount Number of vertices referenced by the indices.
+     * @param cacheSize Number of cache entries to simulate.
+     * @return The ACMR and ATVR of the index order, zero without a whole triangle.
+     */
+    static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                               unsigned int cacheSize = 16);
+
+    /**
+     * @brief Finds vertices whose attributes are bitwise identical.
+     *
+     * Catches duplicates that index-based welding cannot see, e.g. OBJ files
+     * that repeat the same "v" or "vt" record.
+     *
+     * @param positions Vertex positions.
+     * @param uvs Texture coordinates (may be empty).
+     * @param normals Vertex normals (may be empty).
+     * @param remap Receives the new index of every vertex. Kept vertices stay in order.
+     * @return Number of vertices after welding.
+     */
+    static size_t buildWeldRemap(const PositionArray& positions,
+                                 const std::vector<glm::vec2>& uvs,
+                                 const std::vector<glm::vec3>& normals,
+                                 std::vector<unsigned int>& remap);
+
+    /**
+     * @brief Reorders triangles for post-transform cache locality (Tipsify).
+     *
+     * Linear-time fan-based ordering from Sander, Nehab and Barczak,
+     * "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw".
+     *
+     * @param indices Triangle list indices, reordered in place.
+     * @param vertexCount Number of vertices referenced by the indices.
+     * @param cacheSize Target cache size.
+     * @param clusters If not null, receives the first triangle of every cluster
+     *        (runs that start after a cache-breaking jump), for optimizeOverdraw.
+     */
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount,
+                                    unsigned int cacheSize = 16, std::vector<size_t>* clusters = nullptr);
+
+    /**
+     * @brief Sorts triangle clusters so outward-facing ones are drawn first.
+     *
+     * Clusters are ordered by decreasing occlusion potential (dot product of
+     * the cluster's offset from the mesh centroid with its average normal).
+     * Triangle order inside a cluster is kept, so cache efficiency is mostly
+     * preserved while early depth rejection improves.
+     *
+     * @param indices Triangle list indices, reordered in place.
+     * @param positions Vertex positions.
+     * @param clusters First triangle of every cluster, as produced by optimizeVertexCache.
+     */
+    static void optimizeOverdraw(std::vector<unsigned int>& indices, const PositionArray& positions,
+                                 const std::vector<size_t>& clusters);
+
+    /**
+     * @brief Numbers vertices in order of first use by the index buffer.
+     *
+     * Unreferenced vertices are dropped.
+     *
+     * @param indices Triangle list indices.
+     * @param vertexCount Number of vertices.
+     * @param remap Receives the new index of every vertex, or ~0u for dropped vertices.
+     * @return Number of vertices after reordering.
+     */
+    static size_t buildFetchRemap(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                  std::vector<unsigned int>& remap);
+
+    /**
+     * @brief Rewrites an index buffer through a remap table.
+     * @param indices Indices to rewrite in place.
+     * @param remap Table produced by buildWeldRemap or buildFetchRemap.
+     */
+    static void remapIndices(std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap);
+
+    /**
+     * @brief Moves the elements of a vertex stream to their remapped slots.
+     * @param stream Per-vertex data; resized to newCount. Empty streams are left alone.
+     * @param remap Table produced by buildWeldRemap or buildFetchRemap.
+     * @param newCount Vertex count returned together with the remap.
+     */
+    template <typename T, typename Allocator>
+    static void remapStream(std::vector<T, Allocator>& stream, const std::vector<unsigned int>& remap, size_t newCount) {
+        if (stream.empty()) {
+            return;
+        }
+        std::vector<T, Allocator> remapped(newCount);
+        for (size_t i = 0; i < remap.size() && i < stream.size(); i++) {
+            if (remap[i] != ~0u) {
+                remapped[remap[i]] = stream[i];
+            }
+        }
+        stream.swap(remapped);
+    }
+
+    /**
+     * @brief Moves structure-of-arrays positions to their remapped slots.
+     * @param positions Positions; resized to newCount.
+     * @param remap Table produced by buildWeldRemap or buildFetchRemap.
+     * @param newCount Vertex count returned together with the remap.
+     */
+    static void remapStream(PositionArray& positions, const std::vector<unsigned int>& remap, size_t newCount) {
+        remapStream(positions.x, remap, newCount);
+        remapStream(positions.y, remap, newCount);
+        remapStream(positions.z, remap, newCount);
+    }
+};
+
+#endif // MESH_OPTIMIZER_H
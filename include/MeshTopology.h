@@ -0,0 +1,123 @@
+#ifndef MESH_TOPOLOGY_H
+#define MESH_TOPOLOGY_H
+
+#pragma once
+#include "PositionArray.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct TopologyStats
+ * @brief Counts gathered while building a MeshTopology.
+ */
+struct TopologyStats {
+    size_t weldedVertices = 0;  ///< Distinct positions
+    size_t edges = 0;  ///< Undirected edges between distinct positions
+    size_t borderEdges = 0;  ///< Edges used by a single triangle
+    size_t nonManifoldEdges = 0;  ///< Edges used by more than two triangles or twice in the same direction
+    size_t degenerateEdges = 0;  ///< Half-edges whose two ends weld to the same position
+    double buildMs = 0.0;  ///< Time spent building
+};
+
+/**
+ * @class MeshTopology
+ * @brief Half-edge connectivity of a triangle list over welded positions.
+ *
+ * Half-edge h runs from corner h % 3 to the next corner of triangle h / 3,
+ * so faces, next and previous half-edges are implicit and only the twins
+ * are stored (a corner table). Vertices are welded by bitwise equal
+ * position first, so seams split by texture coordinates or normals stay
+ * connected. Everything is kept in flat int32 arrays.
+ *
+ * Both the welding and the edge pairing are hash passes: items are
+ * partitioned by hash into buckets that are then resolved independently on
+ * the thread pool, so the build is linear in the triangle count and its
+ * result does not depend on the number of threads.
+ */
+class MeshTopology {
+public:
+    static const int32_t kBorder = -1;  ///< Twin of a half-edge on an open border
+    static const int32_t kNonManifold = -2;  ///< Twin of a half-edge on a non-manifold or degenerate edge
+
+    /**
+     * @brief Builds the topology of a triangle list (multithreaded).
+     * @param positions Vertex positions.
+     * @param indices Triangle list; at most 2^31 - 1 indices.
+     * @return The topology; empty if the index count is out of range.
+     */
+    static MeshTopology build(const PositionArray& positions, const std::vector<unsigned int>& indices);
+
+    /** @brief Frees all arrays. */
+    void clear();
+
+    /** @brief True if nothing has been built. */
+    bool empty() const { return twins.empty(); }
+
+    /** @brief Number of half-edges, three per triangle. */
+    size_t halfEdgeCount() const { return twins.size(); }
+
+    /** @brief Number of triangles. */
+    size_t faceCount() const { return twins.size() / 3; }
+
+    /** @brief Number of welded vertices. */
+    size_t vertexCount() const { return outgoing.size(); }
+
+    /** @brief Number of mesh vertices the topology was built over. */
+    size_t meshVertexCount() const { return welded.size(); }
+
+    /** @brief Triangle of a half-edge. */
+    static int32_t face(int32_t h) { return h / 3; }
+
+    /** @brief Next half-edge in the same triangle. */
+    static int32_t next(int32_t h) { return h % 3 == 2 ? h - 2 : h + 1; }
+
+    /** @brief Previous half-edge in the same triangle. */
+    static int32_t prev(int32_t h) { return h % 3 == 0 ? h + 2 : h - 1; }
+
+    /** @brief Opposite half-edge in the neighboring triangle, kBorder or kNonManifold. */
+    int32_t twin(int32_t h) const { return twins[h]; }
+
+    /** @brief Welded vertex a half-edge starts at. */
+    int32_t origin(int32_t h) const { return origins[h]; }
+
+    /** @brief Welded vertex a half-edge ends at. */
+    int32_t target(int32_t h) const { return origins[next(h)]; }
+
+    /** @brief Welded vertex of a mesh vertex. */
+    int32_t weldedVertex(size_t meshVertex) const { return welded[meshVertex]; }
+
+    /**
+     * @brief Gets a half-edge leaving a welded vertex.
+     *
+     * A border half-edge is preferred, so walking nextAroundVertex() from
+     * it visits the whole fan of a manifold border vertex.
+     *
+     * @param vertex Welded vertex.
+     * @return The lowest such half-edge, or -1 for vertices no triangle uses.
+     */
+    int32_t outgoingHalfEdge(int32_t vertex) const { return outgoing[vertex]; }
+
+    /**
+     * @brief Steps to the next half-edge leaving the same vertex.
+     * @param h Half-edge leaving a vertex.
+     * @return twin(prev(h)), negative when the fan ends at a border or a
+     *         non-manifold edge.
+     */
+    int32_t nextAroundVertex(int32_t h) const { return twins[prev(h)]; }
+
+    /** @brief True if a half-edge has no twin on an open border. */
+    bool isBorder(int32_t h) const { return twins[h] == kBorder; }
+
+    /** @brief Gets the counts gathered by build(). */
+    const TopologyStats& stats() const { return statistics; }
+
+private:
+    std::vector<int32_t> twins;  ///< Twin of every half-edge
+    std::vector<int32_t> origins;  ///< Welded start vertex of every half-edge
+    std::vector<int32_t> welded;  ///< Welded vertex of every mesh vertex
+    std::vector<int32_t> outgoing;  ///< One half-edge leaving every welded vertex
+    TopologyStats statistics;  ///< Counts of the last build
+};
+
+#endif // MESH_TOPOLOGY_H
@@ -0,0 +1,94 @@
+#ifndef MESHLET_BUILDER_H
+#define MESHLET_BUILDER_H
+
+#pragma once
+#include "PositionArray.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct MeshletOptions
+ * @brief Cluster partitioning of the index buffer for culling.
+ */
+struct MeshletOptions {
+    bool build = true;  ///< Build meshlets after loading; they are stored in the mesh cache
+    unsigned int maxVertices = 64;  ///< Distinct vertices per meshlet, at most 256
+    unsigned int maxTriangles = 124;  ///< Triangles per meshlet
+};
+
+/**
+ * @struct Meshlet
+ * @brief A run of consecutive triangles of the index buffer and its culling bounds.
+ *
+ * The normal cone holds every triangle facing of the meshlet: seen from a
+ * point p, all of them face away if
+ * dot(normalize(coneApex - p), coneAxis) >= coneCutoff. Facing assumes
+ * counter-clockwise front faces, as in OpenGL by default; for clockwise
+ * models the cone describes their back sides.
+ */
+struct Meshlet {
+    uint32_t firstIndex;  ///< First index of the run in the index buffer
+    uint32_t triangleCount;  ///< Triangles in the run
+    uint32_t vertexCount;  ///< Distinct vertices the run references
+    float radius;  ///< Radius of the bounding sphere
+    glm::vec3 center;  ///< Center of the bounding sphere
+    float coneCutoff;  ///< Sine of the widest normal to axis angle; above 1 if the normals spread too far to cull
+    glm::vec3 coneApex;  ///< Point on or behind the plane of every triangle
+    glm::vec3 coneAxis;  ///< Unit mean of the triangle normals
+};
+
+/**
+ * @struct MeshletReport
+ * @brief Statistics of one meshlet build.
+ */
+struct MeshletReport {
+    size_t meshlets = 0;  ///< Meshlets built
+    size_t cullableCones = 0;  ///< Meshlets with a usable normal cone
+    double averageTriangles = 0.0;  ///< Mean triangles per meshlet
+    double averageVertices = 0.0;  ///< Mean distinct vertices per meshlet
+    double buildMs = 0.0;  ///< Time spent building
+};
+
+/**
+ * @class MeshletBuilder
+ * @brief Splits a triangle list into small clusters with bounding spheres
+ *        and normal cones.
+ *
+ * Meshlets are cut from the existing triangle order: a meshlet takes the
+ * next triangles until one more would exceed the vertex or triangle limit.
+ * Every meshlet is therefore a contiguous index range that can be drawn
+ * directly with glMultiDrawElements, and the vertex cache order produced by
+ * MeshOptimizer, which already keeps neighbouring triangles together, is
+ * left untouched.
+ *
+ * The index buffer is scanned in fixed blocks, one task per block, each
+ * block starting a new meshlet; the bounds are computed per meshlet
+ * afterwards. The result does not depend on the thread count.
+ */
+class MeshletBuilder {
+public:
+    /**
+     * @brief Partitions a triangle list into meshlets (multithreaded).
+     * @param positions Vertex positions.
+     * @param indices Triangle list indices.
+     * @param meshlets Receives the meshlets in index buffer order.
+     * @param options Vertex and triangle limits.
+     * @return Statistics of the build.
+     */
+    static MeshletReport build(const PositionArray& positions, const std::vector<unsigned int>& indices,
+                               std::vector<Meshlet>& meshlets, const MeshletOptions& options);
+
+private:
+    /**
+     * @brief Computes the bounding sphere and normal cone of a meshlet.
+     * @param positions Vertex positions.
+     * @param indices Triangle list indices.
+     * @param meshlet Meshlet whose index range is set; receives its bounds.
+     */
+    static void computeBounds(const PositionArray& positions, const std::vector<unsigned int>& indices,
+                              Meshlet& meshlet);
+};
+
+#endif // MESHLET_BUILDER_H
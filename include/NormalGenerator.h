@@ -0,0 +1,65 @@
+#ifndef NORMAL_GENERATOR_H
+#define NORMAL_GENERATOR_H
+
+#pragma once
+#include "PositionArray.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct NormalOptions
+ * @brief Normal generation for models without vn records.
+ */
+struct NormalOptions {
+    bool generate = true;  ///< Generate smooth normals when the file has none (otherwise every normal is +Y)
+    float creaseAngle = 60.0f;  ///< Faces meeting at a sharper angle (degrees) get separate vertices; 180 smooths all
+};
+
+/**
+ * @struct NormalReport
+ * @brief Statistics of one normal generation.
+ */
+struct NormalReport {
+    size_t triangles = 0;  ///< Triangles accumulated
+    size_t degenerateTriangles = 0;  ///< Triangles without area, which contribute nothing
+    size_t creaseVertices = 0;  ///< Vertices duplicated so both sides of a crease keep their own normal
+    double generateMs = 0.0;  ///< Time spent generating
+};
+
+/**
+ * @class NormalGenerator
+ * @brief Smooth vertex normals from triangle geometry.
+ *
+ * Every corner contributes its face normal weighted by the triangle area and
+ * the corner angle, so neither the tessellation density nor long thin
+ * triangles bias the result. Corners are gathered per shared position rather
+ * than per vertex, so UV seams stay smooth; only faces meeting beyond the
+ * crease angle are kept apart, and vertices whose corners land on both sides
+ * of a crease are duplicated.
+ *
+ * The corners are sorted by position with a stable parallel partition into
+ * position ranges followed by a counting sort inside each range, so every
+ * position is resolved by one task without atomics and the result does not
+ * depend on the thread count.
+ */
+class NormalGenerator {
+public:
+    /**
+     * @brief Generates normals for a triangle list (multithreaded).
+     * @param positions Vertex positions.
+     * @param positionIds Shared position of every vertex; vertices with the same id are smoothed together.
+     * @param positionCount Number of distinct position ids.
+     * @param indices Triangle list indices; corners moved to duplicated vertices are rewritten.
+     * @param normals Receives one normal per vertex, duplicated vertices appended.
+     * @param sourceVertices Receives the original vertex of every duplicated vertex.
+     * @param options Crease angle.
+     * @return Statistics of the generation.
+     */
+    static NormalReport generate(const PositionArray& positions, const std::vector<unsigned int>& positionIds,
+                                 size_t positionCount, std::vector<unsigned int>& indices,
+                                 std::vector<glm::vec3>& normals, std::vector<unsigned int>& sourceVertices,
+                                 const NormalOptions& options);
+};
+
+#endif // NORMAL_GENERATOR_H
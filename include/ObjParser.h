@@ -0,0 +1,106 @@
+#ifndef OBJ_PARSER_H
+#define OBJ_PARSER_H
+
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ObjCorner
+ * @brief Indices of a single face corner into the OBJ attribute pools.
+ *
+ * Indices are 0-based. An attribute that the face does not reference
+ * (e.g. the texture coordinate in "f 1//1") is stored as -1.
+ */
+struct ObjCorner {
+    int position;  ///< Index into ObjData::positions
+    int texcoord;  ///< Index into ObjData::texcoords, or -1
+    int normal;  ///< Index into ObjData::normals, or -1
+};
+
+/**
+ * @struct ObjData
+ * @brief Raw geometry read from a Wavefront OBJ file.
+ *
+ * The attribute pools are stored exactly as they appear in the file.
+ * Faces are flattened into a triangle list of corners, three per triangle.
+ */
+struct ObjData {
+    std::vector<glm::vec3> positions;  ///< "v" records
+    std::vector<glm::vec2> texcoords;  ///< "vt" records
+    std::vector<glm::vec3> normals;  ///< "vn" records
+    std::vector<ObjCorner> corners;  ///< Triangle corners, three per triangle
+
+    bool hasTexcoords;  ///< True if any corner references a texture coordinate
+    bool hasNormals;  ///< True if any corner references a normal
+
+    ObjData() : hasTexcoords(false), hasNormals(false) {}
+
+    /**
+     * @brief Empties all pools while keeping their capacity.
+     */
+    void clear();
+};
+
+/**
+ * @class ObjParser
+ * @brief Fast Wavefront OBJ reader.
+ *
+ * The file is memory mapped and tokenized in place: numbers are scanned
+ * directly out of the mapped bytes without building per-line strings or
+ * streams, so the only allocations are the growth of the output pools.
+ *
+ * Faces with more than three corners are triangulated while loading:
+ * convex polygons are fanned, concave ones are ear clipped in their
+ * best-fit plane, and winding order is kept.
+ *
+ * Large inputs are split into newline-aligned chunks that are parsed on
+ * the shared ThreadPool and merged in file order. Relative (negative) face
+ * indices are rebased during the merge, so the result is identical to a
+ * single-threaded parse.
+ */
+class ObjParser {
+public:
+    /**
+     * @brief Maps and parses an OBJ file.
+     *
+     * @param filename Path to the OBJ file.
+     * @param out Receives the parsed geometry. Previous contents are discarded.
+     * @param multithreaded Parse chunks of large files in parallel.
+     * @return True if the file could be read and parsed, false otherwise.
+     */
+    static bool parseFile(const std::string& filename, ObjData& out, bool multithreaded = true);
+
+    /**
+     * @brief Parses OBJ text that is already in memory.
+     *
+     * The range does not need to be null-terminated.
+     *
+     * @param begin First byte of the OBJ text.
+     * @param end One past the last byte of the OBJ text.
+     * @param out Receives the parsed geometry. Previous contents are discarded.
+     * @param multithreaded Parse chunks of large inputs in parallel.
+     * @return True if every face references valid attributes, false otherwise.
+     */
+    static bool parse(const char* begin, const char* end, ObjData& out, bool multithreaded = true);
+
+    /**
+     * @brief Collapses identical face corners into shared vertices.
+     *
+     * Corners are identified by their (position, texcoord, normal) index
+     * triple using an open-addressing hash table, so every distinct triple
+     * becomes one vertex and the triangle list becomes an index buffer.
+     * Unique corners are listed in order of first use.
+     *
+     * @param corners Triangle corners, e.g. ObjData::corners.
+     * @param uniqueCorners Receives one corner per distinct index triple.
+     * @param indices Receives, for each input corner, its index into uniqueCorners.
+     */
+    static void weldCorners(const std::vector<ObjCorner>& corners,
+                            std::vector<ObjCorner>& uniqueCorners,
+                            std::vector<unsigned int>& indices);
+};
+
+#endif // OBJ_PARSER_H
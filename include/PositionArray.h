@@ -0,0 +1,95 @@
+#ifndef POSITION_ARRAY_H
+#define POSITION_ARRAY_H
+
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+/**
+ * @brief Minimal allocator returning storage aligned to Alignment bytes.
+ */
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* pointer, size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+/**
+ * @brief Float array aligned for 256-bit vector loads.
+ */
+using AlignedFloatVector = std::vector<float, AlignedAllocator<float, 32>>;
+
+/**
+ * @struct PositionArray
+ * @brief Vertex positions stored as structure-of-arrays.
+ *
+ * Each coordinate lives in its own 32-byte aligned array so the bulk passes
+ * in MeshKernels can process 4 or 8 vertices per instruction. Single
+ * vertices are still accessible as glm::vec3 by value.
+ */
+struct PositionArray {
+    AlignedFloatVector x;  ///< X coordinates
+    AlignedFloatVector y;  ///< Y coordinates
+    AlignedFloatVector z;  ///< Z coordinates
+
+    /** @brief Number of positions. */
+    size_t size() const { return x.size(); }
+
+    /** @brief True if there are no positions. */
+    bool empty() const { return x.empty(); }
+
+    /** @brief Resizes all three coordinate arrays. */
+    void resize(size_t count) {
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+    }
+
+    /** @brief Gets position i. */
+    glm::vec3 operator[](size_t i) const { return glm::vec3(x[i], y[i], z[i]); }
+
+    /** @brief Sets position i. */
+    void set(size_t i, const glm::vec3& position) {
+        x[i] = position.x;
+        y[i] = position.y;
+        z[i] = position.z;
+    }
+
+    /** @brief Frees all storage. */
+    void release() {
+        AlignedFloatVector().swap(x);
+        AlignedFloatVector().swap(y);
+        AlignedFloatVector().swap(z);
+    }
+};
+
+#endif // POSITION_ARRAY_H
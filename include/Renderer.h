@@ -15,6 +15,7 @@
 
 #include <memory>  
 #include <string>  
+#include <vector>
 
 /**
  * @class Renderer
@@ -45,6 +46,10 @@ public:
 
     /**
      * @brief Renders a mesh using the specified shader and texture.
+     *
+     * Meshes with meshlets are culled per meshlet and drawn with one
+     * glMultiDrawElements call over the surviving index ranges.
+     *
      * @param mesh The 3D mesh to be rendered.
      * @param shader The shader program used for rendering.
      * @param texture The texture applied to the mesh.
@@ -67,6 +72,13 @@ public:
      */
     void processInput();
 
+    /**
+     * @brief Takes the UV projection picked in the UI since the last call.
+     * @param projection Receives the UVProjectorRegistry name.
+     * @return True if a projection was requested.
+     */
+    bool takeProjectionRequest(std::string& projection);
+
 private:
     /**
      * @brief Callback function for handling window resizing.
@@ -112,16 +124,43 @@ private:
 
     // UI state
     bool showUI; ///< Flag to toggle UI display.
+    int projectionChoice; ///< Index into the projection list of the UV Mapping panel.
+    std::string requestedProjection; ///< Projection to regenerate the UVs with, empty if none.
+
+    // Cluster culling
+    bool frustumCulling;  ///< Skip meshlets whose bounding sphere is outside the view frustum
+    bool coneCulling;  ///< Skip meshlets whose normal cone faces away from the camera; off by default as it hides back faces and assumes counter-clockwise front faces
+    std::vector<GLsizei> drawCounts;  ///< Index counts of the ranges drawn this frame
+    std::vector<const void*> drawOffsets;  ///< Byte offsets of the ranges drawn this frame
+    size_t visibleMeshlets;  ///< Meshlets that survived culling this frame
+    size_t drawnTriangles;  ///< Triangles submitted this frame
+
+    // Performance statistics
+    GLuint timerQueries[2];  ///< Ping-ponged GL_TIME_ELAPSED queries around the mesh draw
+    bool timerQueryIssued[2];  ///< Whether the matching query holds a pending result
+    unsigned int frameIndex;  ///< Frame counter selecting the active timer query
+    float cpuFrameMs;  ///< CPU time spent in render() before the buffer swap (smoothed)
+    float gpuDrawMs;  ///< GPU time of the mesh draw call (smoothed)
 
     /**
      * @brief Updates the camera view matrix based on position and angles.
      */
     void updateCamera();
 
+    /**
+     * @brief Culls the meshlets of a mesh and fills drawCounts/drawOffsets
+     *        with the surviving index ranges, merging adjacent ones.
+     * @param mesh The mesh being rendered; must have meshlets.
+     * @param modelViewProjection Transform from model to clip space.
+     * @param modelCamera Camera position in model space.
+     */
+    void cullMeshlets(const Mesh& mesh, const glm::mat4& modelViewProjection, const glm::vec3& modelCamera);
+
     /**
      * @brief Renders the graphical user interface (UI).
+     * @param mesh The mesh being rendered, for the vertex format statistics.
      */
-    void renderUI();
+    void renderUI(const Mesh& mesh);
 };
 
 #endif // RENDERER_H
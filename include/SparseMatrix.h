@@ -0,0 +1,116 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct SparseMatrix
+ * @brief Sparse matrix in compressed sparse row (CSR) form.
+ *
+ * Row r owns the entries [rowOffsets[r], rowOffsets[r + 1]) of columnIndices
+ * and values; the column indices of a row are sorted and unique.
+ */
+struct SparseMatrix {
+    size_t rows = 0;  ///< Number of rows
+    size_t columns = 0;  ///< Number of columns
+    std::vector<size_t> rowOffsets;  ///< rows + 1 offsets into columnIndices/values
+    std::vector<uint32_t> columnIndices;  ///< Column of every stored entry
+    std::vector<double> values;  ///< Value of every stored entry
+
+    /** @brief Number of stored entries. */
+    size_t nonZeros() const { return values.size(); }
+
+    /**
+     * @brief Computes y = A * x (multithreaded over row blocks).
+     * @param x Input vector with columns elements.
+     * @param y Receives rows elements; must not alias x.
+     */
+    void multiply(const double* x, double* y) const;
+
+    /**
+     * @brief Extracts the main diagonal.
+     * @param diagonal Receives min(rows, columns) elements (zero where no entry is stored).
+     */
+    void diagonal(std::vector<double>& diagonal) const;
+
+    /**
+     * @brief Builds a zero-filled matrix with one dense blockSize x blockSize
+     *        block per pair of adjacent nodes (multithreaded).
+     *
+     * Node n owns the rows and columns [blockSize * n, blockSize * (n + 1)).
+     * Row blockSize * n + r starts at blockSize^2 * neighborOffsets[n] +
+     * r * blockSize * degree(n), so the block of the k-th neighbor starts at
+     * column entry blockSize * k of every row of the node.
+     *
+     * @param neighborOffsets nodes + 1 offsets into neighbors.
+     * @param neighbors Sorted unique neighbors of every node, the node itself included.
+     * @param blockSize Rows per node.
+     * @return The square matrix pattern.
+     */
+    static SparseMatrix blockPattern(const std::vector<size_t>& neighborOffsets,
+                                     const std::vector<unsigned int>& neighbors, unsigned int blockSize);
+};
+
+/**
+ * @class Preconditioner
+ * @brief Approximate inverse M^-1 of a system matrix used to speed up
+ *        conjugate gradients. Must be symmetric positive definite.
+ */
+class Preconditioner {
+public:
+    virtual ~Preconditioner() = default;
+
+    /**
+     * @brief Computes result = M^-1 residual.
+     * @param residual Input vector.
+     * @param result Receives the preconditioned vector; must not alias residual.
+     */
+    virtual void apply(const double* residual, double* result) const = 0;
+};
+
+/**
+ * @struct SolverReport
+ * @brief Outcome of an iterative solve.
+ */
+struct SolverReport {
+    unsigned int iterations = 0;  ///< Iterations performed
+    double relativeResidual = 0.0;  ///< |b - A x| / |b| of the returned solution
+    bool converged = false;  ///< True if the tolerance was reached within the iteration limit
+};
+
+/**
+ * @class SparseSolver
+ * @brief Iterative solvers for sparse linear systems.
+ *
+ * Matrix products and vector updates run on the thread pool. Dot products
+ * are summed per fixed-size block and merged in block order, so the
+ * iterates do not depend on the number of threads.
+ */
+class SparseSolver {
+public:
+    /**
+     * @brief Solves A x = b with preconditioned conjugate gradients.
+     *
+     * A must be symmetric positive (semi-)definite. Without a preconditioner
+     * the Jacobi (diagonal) preconditioner is used, and rows with a zero
+     * diagonal are left at their initial value.
+     *
+     * @param matrix Square system matrix.
+     * @param rhs Right-hand side b.
+     * @param solution Initial guess on entry (zeros if its size does not
+     *        match), solution on return.
+     * @param tolerance Stop once |b - A x| <= tolerance * |b|.
+     * @param maxIterations Iteration limit.
+     * @param preconditioner Preconditioner to use, or nullptr for Jacobi.
+     * @return Iteration count and final residual.
+     */
+    static SolverReport conjugateGradient(const SparseMatrix& matrix, const std::vector<double>& rhs,
+                                          std::vector<double>& solution, double tolerance,
+                                          unsigned int maxIterations,
+                                          const Preconditioner* preconditioner = nullptr);
+};
+
+#endif // SPARSE_MATRIX_H
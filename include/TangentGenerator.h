@@ -0,0 +1,64 @@
+#ifndef TANGENT_GENERATOR_H
+#define TANGENT_GENERATOR_H
+
+#pragma once
+#include "PositionArray.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct TangentReport
+ * @brief Statistics of one tangent generation.
+ */
+struct TangentReport {
+    size_t triangles = 0;  ///< Triangles processed
+    size_t degenerateTriangles = 0;  ///< Triangles without area, which take the tangents of their vertices
+    size_t textureDegenerateTriangles = 0;  ///< Triangles without UV area, which join any neighbouring group
+    size_t splitVertices = 0;  ///< Vertices duplicated because their corners ended up in different groups
+    double generateMs = 0.0;  ///< Time spent generating
+};
+
+/**
+ * @class TangentGenerator
+ * @brief Per-vertex tangent frames following MikkTSpace.
+ *
+ * Reproduces the default MikkTSpace result (genTangSpaceDefault: no angular
+ * splitting) so tangent space normal maps baked by other tools line up:
+ *  - every triangle gets its UV derivative direction and orientation (sign
+ *    of its UV area);
+ *  - around every vertex, the triangles connected through shared edges that
+ *    agree in orientation form a group; triangles without UV area join any
+ *    group next to them;
+ *  - a group's tangent is the sum of its triangles' directions projected
+ *    onto the vertex normal plane, weighted by the corner angle measured in
+ *    that plane, and its bitangent sign is the group orientation.
+ *
+ * Vertices with corners in several groups (mirrored UVs meeting at a
+ * vertex) are duplicated. Unlike the reference, triangles without UV area
+ * adopt their orientation at every vertex separately, so their corners do
+ * not depend on the order in which other vertices were visited; only the
+ * grouping of such triangles can differ.
+ *
+ * Vertices are resolved independently, one position range per task, in
+ * the corner order of the index buffer, so the result does not depend on
+ * the thread count.
+ */
+class TangentGenerator {
+public:
+    /**
+     * @brief Generates tangents for a triangle list (multithreaded).
+     * @param positions Vertex positions.
+     * @param normals Unit vertex normals.
+     * @param uvs Texture coordinates.
+     * @param indices Triangle list indices; corners moved to duplicated vertices are rewritten.
+     * @param tangents Receives one tangent per vertex (xyz unit, w bitangent sign), duplicates appended.
+     * @param sourceVertices Receives the original vertex of every duplicated vertex.
+     * @return Statistics of the generation.
+     */
+    static TangentReport generate(const PositionArray& positions, const std::vector<glm::vec3>& normals,
+                                  const std::vector<glm::vec2>& uvs, std::vector<unsigned int>& indices,
+                                  std::vector<glm::vec4>& tangents, std::vector<unsigned int>& sourceVertices);
+};
+
+#endif // TANGENT_GENERATOR_H
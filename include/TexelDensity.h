@@ -0,0 +1,53 @@
+#ifndef TEXEL_DENSITY_H
+#define TEXEL_DENSITY_H
+
+#pragma once
+#include "UVChart.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct TexelDensityOptions
+ * @brief Texel density the chart based projections aim for.
+ */
+struct TexelDensityOptions {
+    bool equalize = true;  ///< Scale every chart so one texture unit is one surface unit before packing
+    float texelsPerUnit = 0.0f;  ///< Density the atlas must reach; 0 packs at the atlas resolution as given
+    unsigned int maxResolution = 8192;  ///< Largest atlas resolution the density target may choose
+};
+
+/**
+ * @struct TexelDensityReport
+ * @brief Statistics of one density equalization.
+ */
+struct TexelDensityReport {
+    size_t charts = 0;  ///< Charts scaled
+    size_t degenerateCharts = 0;  ///< Charts without surface or texture area, left as they were
+    double surfaceArea = 0.0;  ///< Surface area of all charts
+    double spreadBefore = 1.0;  ///< Largest over smallest chart density before, 1 is even
+    double equalizeMs = 0.0;  ///< Time spent equalizing
+};
+
+/**
+ * @class TexelDensity
+ * @brief Evens out the texel density of separately flattened charts.
+ *
+ * Every chart is flattened at its own scale, so packing the charts as they
+ * are gives some of them far more texels per unit of surface than others.
+ * Equalizing scales each chart about its texture space centroid by
+ * sqrt(surface area / texture area), after which texture units are surface
+ * units and the single scale the atlas packer applies is the texel density
+ * of the whole mesh.
+ */
+class TexelDensity {
+public:
+    /**
+     * @brief Scales every chart to one texture unit per surface unit
+     *        (multithreaded, one chart per task).
+     * @param charts Parameterized charts; their uvs are scaled in place.
+     * @return Statistics of the equalization.
+     */
+    static TexelDensityReport equalize(std::vector<UVChart>& charts);
+};
+
+#endif // TEXEL_DENSITY_H
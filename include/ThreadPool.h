@@ -0,0 +1,95 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads for fork-join data parallel work.
+ *
+ * Work is submitted as a number of independent tasks; the calling thread
+ * takes part in executing them and returns once all tasks have finished.
+ * Task boundaries depend only on the task count and grain size, never on
+ * the number of threads, so passes that write disjoint ranges produce the
+ * same output regardless of how many cores are available.
+ *
+ * Calls made from inside a running task execute serially on the calling
+ * thread, so nested parallel loops cannot deadlock the pool.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threadCount Total number of threads including the caller.
+     *        Zero selects std::thread::hardware_concurrency().
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+
+    /**
+     * @brief Stops and joins all worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Gets the process-wide pool shared by the mesh processing passes.
+     * @return Reference to the shared pool.
+     */
+    static ThreadPool& global();
+
+    /**
+     * @brief Gets the number of threads that execute tasks, including the caller.
+     * @return The thread count.
+     */
+    unsigned int size() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+    /**
+     * @brief Runs task(i) for every i in [0, taskCount) and waits for completion.
+     * @param taskCount Number of tasks.
+     * @param task Callable invoked once per task index.
+     */
+    void run(size_t taskCount, const std::function<void(size_t)>& task);
+
+    /**
+     * @brief Splits [0, count) into ranges of grainSize elements and processes them in parallel.
+     * @param count Number of elements.
+     * @param grainSize Number of elements per range (the last range may be shorter).
+     * @param body Callable invoked as body(begin, end) for each range.
+     */
+    void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+
+private:
+    std::vector<std::thread> workers;  ///< Worker threads (the caller is not included)
+    std::mutex mutex;  ///< Guards the job state below
+    std::mutex submitMutex;  ///< Serializes concurrent submissions from different threads
+    std::condition_variable jobAvailable;  ///< Signals workers that a job was posted
+    std::condition_variable jobFinished;  ///< Signals the submitter that all tasks completed
+
+    const std::function<void(size_t)>* currentTask;  ///< Task of the active job
+    size_t taskCount;  ///< Number of tasks in the active job
+    size_t nextTask;  ///< Next task index to hand out
+    size_t pendingTasks;  ///< Tasks not yet completed
+    size_t jobGeneration;  ///< Incremented for every posted job
+    bool stopping;  ///< Set when the pool is shutting down
+
+    /**
+     * @brief Main loop of a worker thread.
+     */
+    void workerLoop();
+
+    /**
+     * @brief Claims and executes tasks of the active job until none remain.
+     * @param lock Lock on mutex, held on entry and on return.
+     */
+    void drainTasks(std::unique_lock<std::mutex>& lock);
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,67 @@
+#ifndef UV_CHART_H
+#define UV_CHART_H
+
+#pragma once
+#include "PositionArray.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct UVChart
+ * @brief A connected patch of triangles that is parameterized on its own.
+ *
+ * Charts carry a local copy of their vertices so they can be flattened
+ * independently (and concurrently); vertices and faces map them back to
+ * the mesh. A mesh vertex on a seam belongs to several charts.
+ */
+struct UVChart {
+    std::vector<unsigned int> vertices;  ///< Mesh vertex index of every chart vertex
+    std::vector<unsigned int> faces;  ///< Mesh triangle index of every chart triangle
+    std::vector<glm::vec3> positions;  ///< Chart vertex positions
+    std::vector<unsigned int> indices;  ///< Triangle list in chart vertex indices
+    std::vector<glm::vec2> uvs;  ///< Chart-space texture coordinates, one per chart vertex
+
+    /** @brief Number of chart vertices. */
+    size_t vertexCount() const { return vertices.size(); }
+
+    /** @brief Number of chart triangles. */
+    size_t triangleCount() const { return indices.size() / 3; }
+
+    /**
+     * @brief Lists the triangle corners around every vertex.
+     * @param offsets Receives vertexCount() + 1 offsets into corners.
+     * @param corners Receives the corners (3 * triangle + slot) of every
+     *        vertex in triangle order.
+     */
+    void vertexCorners(std::vector<size_t>& offsets, std::vector<unsigned int>& corners) const;
+
+    /**
+     * @brief Lists the vertices sharing a triangle with every vertex, the
+     *        vertex itself included (multithreaded).
+     * @param cornerOffsets Offsets from vertexCorners.
+     * @param corners Corners from vertexCorners.
+     * @param offsets Receives vertexCount() + 1 offsets into neighbors.
+     * @param neighbors Receives the sorted neighbors of every vertex.
+     */
+    void vertexNeighbors(const std::vector<size_t>& cornerOffsets, const std::vector<unsigned int>& corners,
+                         std::vector<size_t>& offsets, std::vector<unsigned int>& neighbors) const;
+
+    /**
+     * @brief Builds the charts of a segmented mesh (multithreaded).
+     *
+     * Charts keep the triangle order of the mesh and number their vertices
+     * by mesh index, so the result is deterministic. Vertices not used by
+     * any triangle belong to no chart.
+     *
+     * @param positions Mesh vertex positions.
+     * @param indices Mesh triangle list.
+     * @param chartOfFace Chart of every triangle, in [0, chartCount).
+     * @param chartCount Number of charts.
+     * @return The charts, without texture coordinates.
+     */
+    static std::vector<UVChart> fromSegmentation(const PositionArray& positions, const std::vector<unsigned int>& indices,
+                                                 const std::vector<unsigned int>& chartOfFace, size_t chartCount);
+};
+
+#endif // UV_CHART_H
@@ -0,0 +1,93 @@
+#ifndef UV_METRICS_H
+#define UV_METRICS_H
+
+#pragma once
+#include "PositionArray.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct UVMetricsOptions
+ * @brief Settings of the UV quality measurement.
+ */
+struct UVMetricsOptions {
+    unsigned int resolution = 1024;  ///< Texture size the texel density and the overlap raster refer to
+    bool measureOverlap = true;  ///< Rasterize the wrapped UV triangles to estimate the overlap
+};
+
+/**
+ * @struct TriangleUVMetrics
+ * @brief Distortion of one triangle's texture mapping.
+ */
+struct TriangleUVMetrics {
+    float stretchL2 = 0.0f;  ///< Root mean square stretch (Sander et al.), 1 for an isometry at the mesh scale
+    float stretchLinf = 0.0f;  ///< Largest singular value of the mapping at the mesh scale
+    float angleDistortion = 0.0f;  ///< Mean absolute corner angle deviation in degrees
+    float areaRatio = 0.0f;  ///< Texture/surface area relative to the whole mesh, 1 is even
+    bool flipped = false;  ///< Texture space orientation against the dominant one
+};
+
+/**
+ * @struct UVMetricsReport
+ * @brief Aggregate quality of a mesh's texture coordinates.
+ *
+ * Stretch values are normalized by the overall texture/surface area ratio,
+ * so 1 is the optimum regardless of the UV scale.
+ */
+struct UVMetricsReport {
+    size_t triangles = 0;  ///< Triangles with a non-degenerate surface
+    size_t collapsedTriangles = 0;  ///< Triangles with zero texture space area
+    size_t flippedTriangles = 0;  ///< Triangles oriented against the dominant texture space orientation
+    double stretchL2 = 0.0;  ///< Surface area weighted L2 stretch
+    double stretchLinf = 0.0;  ///< Largest Linf stretch of any triangle
+    double angleDistortionMean = 0.0;  ///< Mean absolute corner angle deviation in degrees
+    double angleDistortionMax = 0.0;  ///< Largest corner angle deviation in degrees
+    double areaDistortion = 0.0;  ///< Surface area weighted mean of max(r, 1/r) over the area ratios r, 1 is even
+    double texelDensity = 0.0;  ///< Surface area weighted mean texels per unit length at the reference resolution
+    double texelDensityDeviation = 0.0;  ///< Standard deviation of the texel density over the surface
+    double coverage = 0.0;  ///< Fraction of the (wrapped) texture covered by triangles
+    double overlap = 0.0;  ///< Fraction of the covered texels covered more than once
+    double measureMs = 0.0;  ///< Time spent measuring
+};
+
+/**
+ * @class UVMetrics
+ * @brief Distortion and layout quality of per-vertex texture coordinates.
+ *
+ * Every pass runs over the triangle list on the thread pool and merges
+ * per-task partial sums in task order, so the report does not depend on the
+ * thread count. Texture coordinates are wrapped like GL_REPEAT for the
+ * overlap estimate, which samples texel centers at the reference
+ * resolution with a top-left fill rule, so triangles that only share an
+ * edge never count as overlapping.
+ */
+class UVMetrics {
+public:
+    /**
+     * @brief Measures texture coordinates of a triangle mesh (multithreaded).
+     * @param positions Vertex positions.
+     * @param indices Triangle list.
+     * @param uvs Texture coordinate of every vertex.
+     * @param options Reference resolution and overlap switch.
+     * @param perTriangle If not null, receives the metrics of every triangle.
+     * @return The aggregate report; empty if the UVs do not match the positions.
+     */
+    static UVMetricsReport measure(const PositionArray& positions, const std::vector<unsigned int>& indices,
+                                   const std::vector<glm::vec2>& uvs,
+                                   const UVMetricsOptions& options = UVMetricsOptions(),
+                                   std::vector<TriangleUVMetrics>* perTriangle = nullptr);
+
+    /**
+     * @brief Condenses a report into one number for comparing projections.
+     *
+     * The L2 stretch, scaled up by the overlap and the share of flipped and
+     * collapsed triangles; lower is better and 1 is perfect.
+     *
+     * @param report Report from measure().
+     * @return The score.
+     */
+    static double score(const UVMetricsReport& report);
+};
+
+#endif // UV_METRICS_H
@@ -0,0 +1,73 @@
+#ifndef UV_OVERLAP_H
+#define UV_OVERLAP_H
+
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct UVOverlapOptions
+ * @brief Settings of the overlap detection.
+ */
+struct UVOverlapOptions {
+    bool wrap = true;  ///< Treat texture coordinates as repeating (GL_REPEAT), so triangles overlap across periods
+    float minRelativeArea = 1e-6f;  ///< Intersections below this fraction of the smaller triangle are touching, not overlapping
+    size_t maxPairs = size_t(1) << 20;  ///< Overlapping pairs returned at most (all of them are counted)
+};
+
+/**
+ * @struct UVOverlapPair
+ * @brief Two triangles whose texture space areas intersect.
+ */
+struct UVOverlapPair {
+    uint32_t first;  ///< Lower triangle index
+    uint32_t second;  ///< Higher triangle index
+    float area;  ///< Area of the intersection in texture space
+};
+
+/**
+ * @struct UVOverlapReport
+ * @brief Result of one overlap detection.
+ */
+struct UVOverlapReport {
+    std::vector<UVOverlapPair> pairs;  ///< Overlapping pairs in grid cell order, at most maxPairs
+    size_t pairCount = 0;  ///< Overlapping pairs found
+    size_t overlappingTriangles = 0;  ///< Triangles in at least one overlapping pair
+    size_t candidatePairs = 0;  ///< Pairs whose bounding boxes met in a grid cell
+    double overlapArea = 0.0;  ///< Sum of the intersection areas of all pairs
+    unsigned int gridSize = 0;  ///< Cells per side of the acceleration grid
+    double detectMs = 0.0;  ///< Time spent detecting
+};
+
+/**
+ * @class UVOverlap
+ * @brief Finds intersecting triangles in texture space.
+ *
+ * Triangles are binned by bounding box into a uniform grid of about one
+ * triangle per cell; with wrapping the grid covers one period and is
+ * toroidal, every triangle being moved to the period of its lower bounding
+ * box corner first. Pairs sharing a cell are tested only in the cell that
+ * holds the lower corner of their bounding box intersection, so every pair
+ * is tested once. The test clips one triangle against the other and
+ * measures the intersection polygon in double precision, so triangles that
+ * only share an edge or a corner never count.
+ *
+ * Cells are tested in parallel and their pairs merged in cell order, so the
+ * result does not depend on the thread count.
+ */
+class UVOverlap {
+public:
+    /**
+     * @brief Detects overlapping texture space triangles (multithreaded).
+     * @param indices Triangle list.
+     * @param uvs Texture coordinate of every vertex.
+     * @param options Wrapping, touch tolerance and pair limit.
+     * @return The overlapping pairs and their total area.
+     */
+    static UVOverlapReport detect(const std::vector<unsigned int>& indices, const std::vector<glm::vec2>& uvs,
+                                  const UVOverlapOptions& options = UVOverlapOptions());
+};
+
+#endif // UV_OVERLAP_H
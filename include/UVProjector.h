@@ -0,0 +1,205 @@
+#ifndef UV_PROJECTOR_H
+#define UV_PROJECTOR_H
+
+#pragma once
+#include "AtlasPacker.h"
+#include "PositionArray.h"
+#include "TexelDensity.h"
+#include "UVSmoother.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @struct UVProjectionContext
+ * @brief Mesh data shared by all spans of one projection run.
+ */
+struct UVProjectionContext {
+    const PositionArray* positions = nullptr;  ///< Vertex positions
+    const std::vector<glm::vec3>* normals = nullptr;  ///< Vertex normals (optional, may be empty)
+    const std::vector<unsigned int>* indices = nullptr;  ///< Triangle list (optional, required by "lscm" and "abf")
+    MeshTopology* topology = nullptr;  ///< Caller's topology of positions/indices, built on first use if empty (optional)
+    glm::vec3 minBounds = glm::vec3(0.0f);  ///< Minimum corner of the bounding box of all positions
+    glm::vec3 maxBounds = glm::vec3(0.0f);  ///< Maximum corner of the bounding box of all positions
+    bool strictMath = false;  ///< Use std::atan2/std::asin instead of the SIMD approximations
+    AtlasOptions atlas;  ///< Atlas the chart based projectors ("lscm", "abf") pack their charts into
+    UVSmoothingOptions smoothing;  ///< Relaxation the "segmented" projector runs over its result
+    TexelDensityOptions texelDensity;  ///< Density the chart based projectors and "segmented" aim for
+};
+
+/**
+ * @struct ShapeStatistics
+ * @brief Coarse shape descriptors used to pick a projector automatically.
+ */
+struct ShapeStatistics {
+    glm::vec3 extents = glm::vec3(0.0f);  ///< Bounding box size
+    int longestAxis = 1;  ///< Axis with the largest extent
+    int shortestAxis = 1;  ///< Axis with the smallest extent
+    float flatness = 0.0f;  ///< Shortest extent / longest extent (0 for a plane)
+    float elongation = 1.0f;  ///< Longest extent / middle extent
+    float radialVariation = 0.0f;  ///< Std. deviation / mean of the distance to the centroid (0 for a sphere)
+};
+
+/**
+ * @struct UVSeamSplit
+ * @brief Vertices a projector duplicated to cut seams into the mesh.
+ *
+ * A vertex shared by several charts keeps its texture coordinate in the
+ * first chart; every other chart gets a copy of the vertex appended after
+ * the original ones.
+ */
+struct UVSeamSplit {
+    std::vector<unsigned int> sourceVertices;  ///< Original vertex of every appended vertex
+    std::vector<glm::vec2> uvs;  ///< Texture coordinate of every appended vertex
+    std::vector<unsigned int> indices;  ///< Triangle list referencing the appended vertices
+};
+
+/**
+ * @class UVProjector
+ * @brief Strategy interface for per-vertex UV projections.
+ *
+ * A projector maps any span of vertices independently, so a mesh (or any
+ * sub-mesh) can be split into spans that run in parallel. Whole-mesh
+ * information a projector needs (e.g. per-segment centers) is gathered once
+ * in prepare() before the spans are projected.
+ */
+class UVProjector {
+public:
+    virtual ~UVProjector() = default;
+
+    /**
+     * @brief Gets the registry name of the projector.
+     * @return The name, e.g. "spherical".
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Gathers whole-mesh data before projecting spans.
+     * @param context Mesh data of the run.
+     */
+    virtual void prepare(const UVProjectionContext& context) { (void)context; }
+
+    /**
+     * @brief Projects the vertices [first, first + count).
+     *
+     * Must be safe to call concurrently for disjoint spans after prepare().
+     *
+     * @param context Mesh data of the run.
+     * @param first First vertex of the span.
+     * @param count Number of vertices.
+     * @param uvs Receives count texture coordinates.
+     */
+    virtual void project(const UVProjectionContext& context, size_t first, size_t count, glm::vec2* uvs) const = 0;
+
+    /**
+     * @brief Post-processes the projected texture coordinates of all vertices.
+     *
+     * Runs after every span has been projected, for passes that need the
+     * neighbors of a vertex (e.g. relaxation across span boundaries).
+     *
+     * @param context Mesh data of the run.
+     * @param uvs Texture coordinates of all vertices, modified in place.
+     */
+    virtual void refine(const UVProjectionContext& context, std::vector<glm::vec2>& uvs) {
+        (void)context;
+        (void)uvs;
+    }
+
+    /**
+     * @brief Gets the seams cut by the last prepare().
+     *
+     * Chart based projectors cut the mesh along their seams; project()
+     * then covers the original vertices and the split adds the copies.
+     *
+     * @return The split, or nullptr if the vertices stay as they are.
+     */
+    virtual const UVSeamSplit* seamSplit() const { return nullptr; }
+
+    /**
+     * @brief Runs prepare(), projects all vertices on the thread pool and
+     *        runs refine().
+     * @param projector Projector to run.
+     * @param context Mesh data of the run.
+     * @param uvs Resized to the vertex count and filled.
+     */
+    static void projectAll(UVProjector& projector, const UVProjectionContext& context, std::vector<glm::vec2>& uvs);
+
+    /**
+     * @brief Runs several projectors and keeps the result with the best
+     *        UVMetrics::score().
+     *
+     * Candidates that cut seams are skipped, since their result needs a
+     * different vertex buffer. Each candidate's metrics are logged.
+     *
+     * @param candidates Registry names to try, in order; ties keep the earlier one.
+     * @param context Mesh data of the run; requires indices.
+     * @param uvs Receives the texture coordinates of the winner.
+     * @return Name of the winner, or an empty string if no candidate ran.
+     */
+    static std::string projectBest(const std::vector<std::string>& candidates, const UVProjectionContext& context,
+                                   std::vector<glm::vec2>& uvs);
+
+    /**
+     * @brief Measures the shape descriptors of a mesh (multithreaded).
+     * @param context Mesh data.
+     * @return The shape statistics.
+     */
+    static ShapeStatistics analyzeShape(const UVProjectionContext& context);
+
+    /**
+     * @brief Chooses the registered projector that suits a shape best.
+     * @param statistics Shape descriptors from analyzeShape.
+     * @return Name of the chosen projector.
+     */
+    static std::string detect(const ShapeStatistics& statistics);
+};
+
+/**
+ * @class UVProjectorRegistry
+ * @brief Name -> factory table of the available UV projectors.
+ *
+ * The built-in projectors ("planar", "box", "cylindrical", "spherical",
+ * "segmented", the legacy "hybrid" planar/cylindrical mapping, the
+ * "lscm" conformal unwrap and the "abf" angle based flattening) are
+ * registered on first use; more can be added at startup.
+ */
+class UVProjectorRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<UVProjector>()>;
+
+    /**
+     * @brief Gets the process-wide registry.
+     * @return The registry.
+     */
+    static UVProjectorRegistry& instance();
+
+    /**
+     * @brief Registers (or replaces) a projector.
+     * @param name Name used to select the projector.
+     * @param factory Creates a new projector instance.
+     */
+    void add(const std::string& name, Factory factory);
+
+    /**
+     * @brief Creates a projector by name.
+     * @param name Registry name.
+     * @return A new projector, or nullptr if the name is unknown.
+     */
+    std::unique_ptr<UVProjector> create(const std::string& name) const;
+
+    /**
+     * @brief Lists the registered names in registration order.
+     * @return The projector names.
+     */
+    std::vector<std::string> names() const;
+
+private:
+    UVProjectorRegistry();
+
+    std::vector<std::pair<std::string, Factory>> factories;  ///< Registered projectors
+};
+
+#endif // UV_PROJECTOR_H
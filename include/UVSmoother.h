@@ -0,0 +1,65 @@
+#ifndef UV_SMOOTHER_H
+#define UV_SMOOTHER_H
+
+#pragma once
+#include "MeshTopology.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct UVSmoothingOptions
+ * @brief Settings of the UV relaxation.
+ */
+struct UVSmoothingOptions {
+    unsigned int iterations = 16;  ///< Maximum Jacobi iterations (0 disables the relaxation)
+    float strength = 0.5f;  ///< Fraction of the way to the neighbor average moved per iteration
+    float seamThreshold = 0.25f;  ///< Edges whose UVs differ by more than this in u or v are seams
+    float tolerance = 1e-5f;  ///< Stops once no texture coordinate moves by more than this
+};
+
+/**
+ * @struct UVSmoothingReport
+ * @brief Statistics of one relaxation run.
+ */
+struct UVSmoothingReport {
+    unsigned int iterations = 0;  ///< Jacobi iterations run
+    float lastStep = 0.0f;  ///< Largest move of the last iteration
+    size_t freeVertices = 0;  ///< Welded vertices that were relaxed
+    size_t pinnedVertices = 0;  ///< Welded vertices on seams, borders or non-manifold fans
+    double smoothMs = 0.0;  ///< Time spent relaxing
+};
+
+/**
+ * @class UVSmoother
+ * @brief Seam-aware Laplacian relaxation of per-vertex texture coordinates.
+ *
+ * Works on the welded vertices of a MeshTopology: every free vertex moves
+ * towards the average UV of its one-ring (uniform weights). A vertex is
+ * pinned if its fan is open or non-manifold, if its copies carry different
+ * UVs, or if any edge around it jumps by more than the seam threshold, so
+ * both sides of a seam keep matching and wrapped coordinates are never
+ * averaged across the wrap. Pinned neighbors contribute the UV of the
+ * corner on the free vertex's side of the seam.
+ *
+ * Iterations are Jacobi sweeps on the thread pool between two preallocated
+ * buffers, so the result does not depend on the thread count and nothing is
+ * allocated per iteration.
+ */
+class UVSmoother {
+public:
+    /**
+     * @brief Relaxes texture coordinates in place (multithreaded).
+     * @param topology Topology of indices over the mesh positions.
+     * @param indices Triangle list the topology was built from.
+     * @param uvs Texture coordinate of every mesh vertex; free vertices are
+     *        overwritten with the relaxed UV of their welded vertex.
+     * @param options Iteration count, step and seam settings.
+     * @return Statistics of the run.
+     */
+    static UVSmoothingReport smooth(const MeshTopology& topology, const std::vector<unsigned int>& indices,
+                                    std::vector<glm::vec2>& uvs,
+                                    const UVSmoothingOptions& options = UVSmoothingOptions());
+};
+
+#endif // UV_SMOOTHER_H
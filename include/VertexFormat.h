@@ -0,0 +1,238 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Storage of vertex positions in the VBO.
+ */
+enum class PositionEncoding {
+    Float32,  ///< 3 x 32-bit float (12 bytes)
+    Half16,  ///< 3 x 16-bit float, padded to 8 bytes
+    Unorm16  ///< 3 x 16-bit unsigned normalized relative to the bounding box, padded to 8 bytes
+};
+
+/**
+ * @brief Storage of texture coordinates in the VBO.
+ */
+enum class TexcoordEncoding {
+    Float32,  ///< 2 x 32-bit float (8 bytes)
+    Unorm16  ///< 2 x 16-bit unsigned normalized relative to the UV bounds (4 bytes)
+};
+
+/**
+ * @brief Storage of vertex normals in the VBO.
+ */
+enum class NormalEncoding {
+    Float32,  ///< 3 x 32-bit float (12 bytes)
+    Octahedral16,  ///< Octahedral projection in 2 x 16-bit signed normalized (4 bytes)
+    Snorm1010102  ///< x, y, z in 10-bit signed normalized fields of one 32-bit word (4 bytes)
+};
+
+/**
+ * @brief Storage of vertex tangents in the VBO.
+ */
+enum class TangentEncoding {
+    None,  ///< No tangent attribute
+    Float32,  ///< xyz and bitangent sign as 4 x 32-bit float (16 bytes)
+    Snorm1010102  ///< xyz in 10-bit signed normalized fields, bitangent sign in the 2-bit w (4 bytes)
+};
+
+/**
+ * @brief Arrangement of the vertex attributes in GPU buffers.
+ */
+enum class VertexLayout {
+    Interleaved,  ///< One VBO, all attributes of a vertex next to each other
+    Split  ///< One VBO per attribute, so one stream can be updated alone
+};
+
+/**
+ * @struct VertexFormat
+ * @brief Per-attribute encodings and buffer layout of the vertex data.
+ *
+ * Attributes are numbered like their shader locations: 0 position,
+ * 1 texture coordinate, 2 normal, 3 tangent (only with a tangent encoding).
+ */
+struct VertexFormat {
+    static const unsigned int kAttributeCount = 4;  ///< Position, texture coordinate, normal and tangent
+
+    PositionEncoding position = PositionEncoding::Float32;  ///< Position encoding
+    TexcoordEncoding texcoord = TexcoordEncoding::Float32;  ///< Texture coordinate encoding
+    NormalEncoding normal = NormalEncoding::Float32;  ///< Normal encoding
+    TangentEncoding tangent = TangentEncoding::None;  ///< Tangent encoding, None leaves the attribute out
+    VertexLayout layout = VertexLayout::Interleaved;  ///< Buffer layout, not part of key() (caches are interleaved)
+
+    /**
+     * @brief The original 32-byte layout: float position, UV and normal.
+     */
+    static VertexFormat full();
+
+    /**
+     * @brief 16-byte layout: unorm16 position and UV, octahedral normal.
+     */
+    static VertexFormat compact();
+
+    /**
+     * @brief 16-byte layout: half-float position, unorm16 UV, 10:10:10:2 normal.
+     */
+    static VertexFormat half();
+
+    /**
+     * @brief Parses a format name ("full", "compact" or "half").
+     * @param name Format name.
+     * @param format Receives the format if the name is known.
+     * @return True if the name was recognized, false otherwise.
+     */
+    static bool fromName(const std::string& name, VertexFormat& format);
+
+    /**
+     * @brief Parses a tangent encoding name ("none", "float" or "packed").
+     * @param name Encoding name.
+     * @param encoding Receives the encoding if the name is known.
+     * @return True if the name was recognized, false otherwise.
+     */
+    static bool tangentFromName(const std::string& name, TangentEncoding& encoding);
+
+    /** @brief Byte offset of the texture coordinate inside a vertex. */
+    unsigned int texcoordOffset() const;
+
+    /** @brief Byte offset of the normal inside a vertex. */
+    unsigned int normalOffset() const;
+
+    /** @brief Byte offset of the tangent inside a vertex. */
+    unsigned int tangentOffset() const;
+
+    /** @brief Size of one vertex in bytes. */
+    unsigned int stride() const;
+
+    /** @brief Number of attributes stored: 4 with a tangent encoding, 3 otherwise. */
+    unsigned int attributeCount() const { return tangent == TangentEncoding::None ? 3 : 4; }
+
+    /** @brief Byte offset of an attribute inside an interleaved vertex. */
+    unsigned int attributeOffset(unsigned int attribute) const;
+
+    /** @brief Size of one attribute in bytes. */
+    unsigned int attributeSize(unsigned int attribute) const;
+
+    /** @brief Compact identifier, stable across runs (used as a cache key). */
+    uint32_t key() const;
+
+    /** @brief Human readable description, e.g. "unorm16/unorm16/oct16 (16 B)" or "float/float/float/snorm10 (36 B, split)". */
+    std::string describe() const;
+};
+
+/**
+ * @struct VertexDecode
+ * @brief Constants the vertex shader needs to reconstruct quantized attributes.
+ *
+ * position = stored * positionScale + positionOffset, likewise for UVs.
+ * For float encodings the scale is 1 and the offset 0.
+ */
+struct VertexDecode {
+    glm::vec3 positionOffset = glm::vec3(0.0f);  ///< Added after scaling the stored position
+    glm::vec3 positionScale = glm::vec3(1.0f);  ///< Multiplies the stored position
+    glm::vec2 uvOffset = glm::vec2(0.0f);  ///< Added after scaling the stored UV
+    glm::vec2 uvScale = glm::vec2(1.0f);  ///< Multiplies the stored UV
+    bool octahedralNormals = false;  ///< Normal attribute holds an octahedral (x, y) pair
+};
+
+/**
+ * @class VertexPacker
+ * @brief Encodes vertices into a VertexFormat and describes it to OpenGL.
+ */
+class VertexPacker {
+public:
+    /**
+     * @brief Prepares packing for a mesh with the given attribute ranges.
+     * @param format Target vertex format.
+     * @param positionMin Minimum corner of the position bounds.
+     * @param positionMax Maximum corner of the position bounds.
+     * @param uvMin Minimum of the texture coordinates.
+     * @param uvMax Maximum of the texture coordinates.
+     */
+    VertexPacker(const VertexFormat& format, const glm::vec3& positionMin, const glm::vec3& positionMax,
+                 const glm::vec2& uvMin, const glm::vec2& uvMax);
+
+    /**
+     * @brief Rebuilds a packer for data that was packed earlier with these decode constants.
+     * @param format Vertex format of the data.
+     * @param decode Decode constants of the data.
+     */
+    VertexPacker(const VertexFormat& format, const VertexDecode& decode);
+
+    /**
+     * @brief Encodes one vertex.
+     * @param position Vertex position.
+     * @param uv Texture coordinate.
+     * @param normal Unit normal.
+     * @param tangent Unit tangent and bitangent sign (ignored without a tangent encoding).
+     * @param destination Receives stride() bytes.
+     */
+    void pack(const glm::vec3& position, const glm::vec2& uv, const glm::vec3& normal, const glm::vec4& tangent,
+              unsigned char* destination) const;
+
+    /**
+     * @brief Encodes one position.
+     * @param position Vertex position.
+     * @param destination Receives attributeSize(0) bytes.
+     */
+    void packPosition(const glm::vec3& position, unsigned char* destination) const;
+
+    /**
+     * @brief Encodes one texture coordinate.
+     * @param uv Texture coordinate.
+     * @param destination Receives attributeSize(1) bytes.
+     */
+    void packTexcoord(const glm::vec2& uv, unsigned char* destination) const;
+
+    /**
+     * @brief Encodes one normal.
+     * @param normal Unit normal.
+     * @param destination Receives attributeSize(2) bytes.
+     */
+    void packNormal(const glm::vec3& normal, unsigned char* destination) const;
+
+    /**
+     * @brief Encodes one tangent.
+     * @param tangent Unit tangent in xyz, bitangent sign in w.
+     * @param destination Receives attributeSize(3) bytes.
+     */
+    void packTangent(const glm::vec4& tangent, unsigned char* destination) const;
+
+    /**
+     * @brief Decodes one vertex (lossy for quantized formats).
+     * @param source stride() bytes written by pack().
+     * @param position Receives the position.
+     * @param uv Receives the texture coordinate.
+     * @param normal Receives the normal.
+     * @param tangent Receives the tangent, (1, 0, 0, 1) without a tangent encoding.
+     */
+    void unpack(const unsigned char* source, glm::vec3& position, glm::vec2& uv, glm::vec3& normal,
+                glm::vec4& tangent) const;
+
+    /**
+     * @brief Configures one attribute location for the VBO currently bound to
+     *        GL_ARRAY_BUFFER; with the split layout that buffer holds only
+     *        this attribute, tightly packed.
+     * @param attribute Attribute location, below VertexFormat::attributeCount().
+     */
+    void setupAttribute(unsigned int attribute) const;
+
+    /** @brief The vertex format being packed. */
+    const VertexFormat& format() const { return vertexFormat; }
+
+    /** @brief Decode constants for the vertex shader. */
+    const VertexDecode& decode() const { return vertexDecode; }
+
+private:
+    VertexFormat vertexFormat;  ///< Target format
+    VertexDecode vertexDecode;  ///< Shader-side reconstruction constants
+    glm::vec3 positionInverseScale;  ///< 1 / positionScale, or 0 for flat axes
+    glm::vec2 uvInverseScale;  ///< 1 / uvScale, or 0 for flat axes
+};
+
+#endif // VERTEX_FORMAT_H
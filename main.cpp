@@ -1,10 +1,107 @@
 #include "Renderer.h"
+#include "AtlasBenchmark.h"
+#include "LayoutBenchmark.h"
 #include "Mesh.h"
 #include "Shader.h"
 #include "Texture.h"
+#include <cstdlib>
 #include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    // Command line options
+    MeshLoadOptions loadOptions;
+    TangentEncoding tangents = TangentEncoding::None;
+    bool splitStreams = false;
+    bool benchmarkLayouts = false;
+    bool benchmarkAtlas = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        const std::string formatFlag = "--vertex-format=";
+        const std::string projectionFlag = "--uv-projection=";
+        const std::string atlasFlag = "--atlas-resolution=";
+        const std::string paddingFlag = "--atlas-padding=";
+        const std::string smoothingFlag = "--uv-smoothing=";
+        const std::string densityFlag = "--texel-density=";
+        const std::string creaseFlag = "--crease-angle=";
+        const std::string tangentFlag = "--tangents=";
+        if (argument.compare(0, formatFlag.size(), formatFlag) == 0) {
+            if (!VertexFormat::fromName(argument.substr(formatFlag.size()), loadOptions.vertexFormat)) {
+                std::cerr << "Unknown vertex format '" << argument.substr(formatFlag.size())
+                          << "', expected full, compact or half" << std::endl;
+                return -1;
+            }
+        } else if (argument.compare(0, projectionFlag.size(), projectionFlag) == 0) {
+            loadOptions.uvProjection = argument.substr(projectionFlag.size());
+        } else if (argument == "--force-procedural-uvs") {
+            loadOptions.forceProceduralUVs = true;
+        } else if (argument.compare(0, atlasFlag.size(), atlasFlag) == 0) {
+            loadOptions.atlas.resolution =
+                static_cast<unsigned int>(std::strtoul(argument.c_str() + atlasFlag.size(), nullptr, 10));
+            if (loadOptions.atlas.resolution < 16) {
+                std::cerr << "Atlas resolution must be at least 16 texels" << std::endl;
+                return -1;
+            }
+        } else if (argument.compare(0, paddingFlag.size(), paddingFlag) == 0) {
+            loadOptions.atlas.padding =
+                static_cast<unsigned int>(std::strtoul(argument.c_str() + paddingFlag.size(), nullptr, 10));
+        } else if (argument == "--atlas-raster") {
+            loadOptions.atlas.rasterPacking = true;
+        } else if (argument.compare(0, smoothingFlag.size(), smoothingFlag) == 0) {
+            loadOptions.uvSmoothing.iterations =
+                static_cast<unsigned int>(std::strtoul(argument.c_str() + smoothingFlag.size(), nullptr, 10));
+        } else if (argument.compare(0, densityFlag.size(), densityFlag) == 0) {
+            loadOptions.texelDensity.texelsPerUnit = std::strtof(argument.c_str() + densityFlag.size(), nullptr);
+            if (!(loadOptions.texelDensity.texelsPerUnit >= 0.0f)) {
+                std::cerr << "Texel density must not be negative" << std::endl;
+                return -1;
+            }
+        } else if (argument.compare(0, creaseFlag.size(), creaseFlag) == 0) {
+            loadOptions.normals.creaseAngle = std::strtof(argument.c_str() + creaseFlag.size(), nullptr);
+            if (!(loadOptions.normals.creaseAngle >= 0.0f)) {
+                std::cerr << "Crease angle must not be negative" << std::endl;
+                return -1;
+            }
+        } else if (argument.compare(0, tangentFlag.size(), tangentFlag) == 0) {
+            if (!VertexFormat::tangentFromName(argument.substr(tangentFlag.size()), tangents)) {
+                std::cerr << "Unknown tangent encoding '" << argument.substr(tangentFlag.size())
+                          << "', expected none, float or packed" << std::endl;
+                return -1;
+            }
+        } else if (argument == "--measure-uvs") {
+            loadOptions.measureUVs = true;
+        } else if (argument == "--no-meshlets") {
+            loadOptions.meshlets.build = false;
+        } else if (argument == "--split-streams") {
+            splitStreams = true;
+        } else if (argument == "--benchmark-layouts") {
+            benchmarkLayouts = true;
+        } else if (argument == "--benchmark-atlas") {
+            benchmarkAtlas = true;
+        } else {
+            std::cerr << "Unknown argument " << argument << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--vertex-format=full|compact|half]"
+                      << " [--uv-projection=auto|best|planar|box|cylindrical|spherical|segmented|hybrid|lscm|abf]"
+                      << " [--force-procedural-uvs] [--atlas-resolution=N] [--atlas-padding=N] [--atlas-raster]"
+                      << " [--uv-smoothing=N] [--texel-density=X] [--crease-angle=DEG]"
+                      << " [--tangents=none|float|packed] [--measure-uvs] [--no-meshlets] [--split-streams]"
+                      << " [--benchmark-layouts] [--benchmark-atlas]" << std::endl;
+            return -1;
+        }
+    }
+
+    // Applied after parsing, --vertex-format replaces the whole format
+    loadOptions.vertexFormat.tangent = tangents;
+    if (splitStreams) {
+        loadOptions.vertexFormat.layout = VertexLayout::Split;
+    }
+
+    // Packs synthetic charts only, no window needed
+    if (benchmarkAtlas) {
+        AtlasBenchmark::run(10000, loadOptions.atlas);
+        return 0;
+    }
 
-int main() {
     // Exception handling
     try {
         Renderer renderer(800, 600);
@@ -13,9 +110,21 @@ int main() {
             return -1;
         }
 
+        if (benchmarkLayouts) {
+            std::cout << "Loading shaders..." << std::endl;
+            Shader shader;
+            if (!shader.loadFromFiles("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl")) {
+                std::cerr << "Failed to load shaders" << std::endl;
+                return -1;
+            }
+            LayoutBenchmark::run("assets/models/armadillo.obj", loadOptions, shader);
+            renderer.cleanup();
+            return 0;
+        }
+
         std::cout << "Loading mesh..." << std::endl;
         Mesh mesh;
-        if (!mesh.loadFromFile("assets/models/armadillo.obj")) {
+        if (!mesh.loadFromFile("assets/models/armadillo.obj", loadOptions)) {
             std::cerr << "Failed to load mesh" << std::endl;
             return -1;
         }
@@ -38,8 +147,12 @@ int main() {
         }
 
         std::cout << "Entering main render loop..." << std::endl;
+        std::string projection;
         while (!renderer.shouldClose()) {
             renderer.processInput();
+            if (renderer.takeProjectionRequest(projection)) {
+                mesh.regenerateUVs(projection, loadOptions);
+            }
             renderer.render(mesh, shader, texture);
         }
 
@@ -5,11 +5,13 @@ out vec4 FragColor; // Output color of the fragment
 in vec2 TexCoord;   // Texture coordinates
 in vec3 Normal;     // Normal vector in world space
 in vec3 FragPos;    // Fragment position in world space
+in vec4 Tangent;    // Tangent in world space, bitangent sign in w
 
 // Uniform variables
 uniform sampler2D texture1; // Texture sampler
 uniform vec3 lightPos;      // Light position in world space
 uniform vec3 viewPos;       // Camera position in world space
+uniform bool hasTangents = false; // Whether the mesh carries MikkTSpace tangents
 
 void main() {
     // Get texture color with all color channels
@@ -25,13 +27,17 @@ void main() {
     float detailNoise = sin(FragPos.x * 10.0) * sin(FragPos.y * 10.0) * sin(FragPos.z * 10.0) * 0.05;
     enhancedColor = mix(enhancedColor, enhancedColor * (1.0 + detailNoise), 0.7);
     
-    // Normal mapping simulation - perturb normal slightly based on texture coordinates
-    // This simulates the effect of a normal map for models without one
-    vec3 perturbedNormal = normalize(Normal + vec3(
-        sin(TexCoord.x * 50.0) * 0.03,
-        0.0,
-        sin(TexCoord.y * 50.0) * 0.03
-    ));
+    // Normal mapping of a procedural ripple given in tangent space
+    vec2 ripple = vec2(sin(TexCoord.x * 50.0), sin(TexCoord.y * 50.0)) * 0.03;
+    vec3 perturbedNormal;
+    if (hasTangents) {
+        // MikkTSpace decoding: bitangent and mapped normal from the unnormalized interpolated frame
+        vec3 bitangent = Tangent.w * cross(Normal, Tangent.xyz);
+        perturbedNormal = normalize(ripple.x * Tangent.xyz + ripple.y * bitangent + Normal);
+    } else {
+        // Without tangents the ripple can only be faked along the world axes
+        perturbedNormal = normalize(Normal + vec3(ripple.x, 0.0, ripple.y));
+    }
     
     // Ambient lighting
     float ambientStrength = 0.3;
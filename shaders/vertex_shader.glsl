@@ -2,27 +2,49 @@
 // Vertex attribute locations
 layout (location = 0) in vec3 aPos;      // Vertex position in object space
 layout (location = 1) in vec2 aTexCoord; // Texture coordinates
-layout (location = 2) in vec3 aNormal;   // Vertex normal in object space
+layout (location = 2) in vec3 aNormal;   // Vertex normal in object space (octahedral x, y when packed)
+layout (location = 3) in vec4 aTangent;  // MikkTSpace tangent in object space, bitangent sign in w (if present)
 
 // Outputs to fragment shader
 out vec2 TexCoord;  // Texture coordinates
 out vec3 Normal;     // Vertex normal in world space
 out vec3 FragPos;    // Fragment position in world space
+out vec4 Tangent;    // Vertex tangent in world space, bitangent sign in w
 
 // Transformation matrices
 uniform mat4 model;      // Model matrix (object to world space)
 uniform mat4 view;       // View matrix (world to camera space)
 uniform mat4 projection; // Projection matrix (camera to clip space)
 
+// Decoding of quantized vertex formats (identity for float attributes)
+uniform vec3 positionOffset = vec3(0.0);
+uniform vec3 positionScale = vec3(1.0);
+uniform vec2 uvOffset = vec2(0.0);
+uniform vec2 uvScale = vec2(1.0);
+uniform bool octahedralNormals = false;
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
 void main() {
+    vec3 position = aPos * positionScale + positionOffset;
+    vec3 normal = octahedralNormals ? decodeOctahedral(aNormal.xy) : aNormal;
+
     // Transform vertex position to world space
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    FragPos = vec3(model * vec4(position, 1.0));
 
     // Transform normal to world space using normal matrix
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = mat3(transpose(inverse(model))) * normal;
+
+    // Tangents transform like positions; the sign is passed through unchanged
+    Tangent = vec4(mat3(model) * aTangent.xyz, aTangent.w);
 
     // Pass through texture coordinates
-    TexCoord = aTexCoord;
+    TexCoord = aTexCoord * uvScale + uvOffset;
 
     // Transform vertex position to clip space
     gl_Position = projection * view * vec4(FragPos, 1.0);
@@ -0,0 +1,473 @@
+#include "ABF.h"
+#include "Multigrid.h"
+#include "SparseMatrix.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Triangles or vertices per parallel task
+const size_t kGrainSize = 1 << 12;
+
+// Surface angles are clamped to [kMinAngle, pi - kMinAngle] (one degree)
+const double kMinAngle = kPi / 180.0;
+
+// Reduced systems from this many vertices on use the multigrid preconditioner
+const size_t kMultigridVertices = 4096;
+
+// Conjugate gradient iteration limit of one Newton step
+const unsigned int kMaxLinearIterations = 1000;
+
+double millisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+/**
+ * Sums body(begin, end) over [0, count) on the thread pool. Block sums are
+ * merged in order, so the result does not depend on the thread count.
+ */
+template <typename Body>
+double parallelSum(size_t count, Body body) {
+    std::vector<double> partials((count + kGrainSize - 1) / kGrainSize, 0.0);
+    ThreadPool::global().parallelFor(count, kGrainSize, [&](size_t begin, size_t end) {
+        partials[begin / kGrainSize] = body(begin, end);
+    });
+    double sum = 0.0;
+    for (double partial : partials) {
+        sum += partial;
+    }
+    return sum;
+}
+
+/**
+ * Angle between the edges p -> a and p -> b, given as 2D or 3D double arrays.
+ */
+double cornerAngle(const double* p, const double* a, const double* b, int dimensions) {
+    double dot = 0.0, lengthA = 0.0, lengthB = 0.0;
+    for (int i = 0; i < dimensions; i++) {
+        dot += (a[i] - p[i]) * (b[i] - p[i]);
+        lengthA += (a[i] - p[i]) * (a[i] - p[i]);
+        lengthB += (b[i] - p[i]) * (b[i] - p[i]);
+    }
+    const double denominator = std::sqrt(lengthA * lengthB);
+    return denominator > 0.0 ? std::acos(std::max(-1.0, std::min(1.0, dot / denominator))) : 0.0;
+}
+
+/**
+ * Corner angles of triangle t on the surface (dimensions = 3) or in the
+ * chart layout (dimensions = 2).
+ */
+void triangleAngles(const UVChart& chart, size_t t, int dimensions, double* angles) {
+    double points[3][3] = {};
+    for (int k = 0; k < 3; k++) {
+        const unsigned int v = chart.indices[3 * t + k];
+        if (dimensions == 3) {
+            points[k][0] = chart.positions[v].x;
+            points[k][1] = chart.positions[v].y;
+            points[k][2] = chart.positions[v].z;
+        } else {
+            points[k][0] = chart.uvs[v].x;
+            points[k][1] = chart.uvs[v].y;
+        }
+    }
+    for (int k = 0; k < 3; k++) {
+        angles[k] = cornerAngle(points[k], points[(k + 1) % 3], points[(k + 2) % 3], dimensions);
+    }
+}
+
+/**
+ * Twice the signed area of triangle t in the chart layout.
+ */
+double signedArea(const UVChart& chart, size_t t) {
+    const glm::vec2& a = chart.uvs[chart.indices[3 * t]];
+    const glm::vec2& b = chart.uvs[chart.indices[3 * t + 1]];
+    const glm::vec2& c = chart.uvs[chart.indices[3 * t + 2]];
+    return (double(b.x) - a.x) * (double(c.y) - a.y) - (double(b.y) - a.y) * (double(c.x) - a.x);
+}
+
+/**
+ * Per-triangle view of the constraint Jacobian: row[r][k] is the derivative
+ * of the planarity (r = 0) or reconstruction (r = 1) constraint of the
+ * vertex in slot j by the angle of corner k. Rows of boundary vertices are 0.
+ */
+struct TriangleJacobian {
+    double row[3][2][3];
+};
+
+TriangleJacobian triangleJacobian(const bool* interior, const double* cotangents) {
+    TriangleJacobian jacobian = {};
+    for (int j = 0; j < 3; j++) {
+        if (!interior[j]) {
+            continue;
+        }
+        const int next = (j + 1) % 3;
+        const int previous = (j + 2) % 3;
+        jacobian.row[j][0][j] = 1.0;
+        jacobian.row[j][1][next] = cotangents[next];
+        jacobian.row[j][1][previous] = -cotangents[previous];
+    }
+    return jacobian;
+}
+
+} // namespace
+
+AngleDistortion ABF::angleDistortion(const UVChart& chart) {
+    AngleDistortion distortion;
+    const size_t triangleTotal = chart.uvs.size() == chart.vertexCount() ? chart.triangleCount() : 0;
+    const size_t taskCount = (triangleTotal + kGrainSize - 1) / kGrainSize;
+
+    // Sum, corner count and maximum per block, merged in block order
+    std::vector<double> partials(taskCount * 3, 0.0);
+    ThreadPool::global().parallelFor(triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+        double sum = 0.0, count = 0.0, largest = 0.0;
+        for (size_t t = begin; t < end; t++) {
+            double surface[3], layout[3];
+            triangleAngles(chart, t, 3, surface);
+            if (!(surface[0] > 0.0 && surface[1] > 0.0 && surface[2] > 0.0)) {
+                continue;
+            }
+            triangleAngles(chart, t, 2, layout);
+            for (int k = 0; k < 3; k++) {
+                const double deviation = std::fabs(layout[k] - surface[k]) * (180.0 / kPi);
+                sum += deviation;
+                largest = std::max(largest, deviation);
+            }
+            count += 3.0;
+        }
+        double* partial = &partials[(begin / kGrainSize) * 3];
+        partial[0] = sum;
+        partial[1] = count;
+        partial[2] = largest;
+    });
+    double sum = 0.0, count = 0.0;
+    for (size_t task = 0; task < taskCount; task++) {
+        sum += partials[3 * task];
+        count += partials[3 * task + 1];
+        distortion.max = std::max(distortion.max, partials[3 * task + 2]);
+    }
+    distortion.mean = count > 0.0 ? sum / count : 0.0;
+    return distortion;
+}
+
+ABFReport ABF::parameterize(UVChart& chart, const ABFOptions& options) {
+    ABFReport report;
+    report.initial = LSCM::parameterize(chart, options.lscm);
+    report.initialDistortion = report.distortion = angleDistortion(chart);
+    const size_t vertexTotal = chart.vertexCount();
+    const size_t triangleTotal = chart.triangleCount();
+    if (report.initial.unknowns == 0) {
+        return report;
+    }
+    auto angleStart = std::chrono::high_resolution_clock::now();
+    ThreadPool& pool = ThreadPool::global();
+    const std::vector<unsigned int>& indices = chart.indices;
+
+    std::vector<size_t> cornerOffsets, neighborOffsets;
+    std::vector<unsigned int> corners, neighbors;
+    chart.vertexCorners(cornerOffsets, corners);
+
+    // A vertex is interior if every neighbor on its fan appears exactly twice
+    // (once after and once before it); vertices of triangles with repeated
+    // indices are left unconstrained
+    std::vector<char> interior(vertexTotal, 0);
+    const double interiorTotal = parallelSum(vertexTotal, [&](size_t begin, size_t end) {
+        std::vector<unsigned int> ring;
+        double count = 0.0;
+        for (size_t v = begin; v < end; v++) {
+            ring.clear();
+            bool closed = cornerOffsets[v + 1] > cornerOffsets[v];
+            for (size_t k = cornerOffsets[v]; k < cornerOffsets[v + 1]; k++) {
+                const size_t t = corners[k] / 3;
+                const size_t j = corners[k] % 3;
+                const unsigned int next = indices[3 * t + (j + 1) % 3];
+                const unsigned int previous = indices[3 * t + (j + 2) % 3];
+                closed = closed && next != v && previous != v && next != previous;
+                ring.push_back(next);
+                ring.push_back(previous);
+            }
+            std::sort(ring.begin(), ring.end());
+            for (size_t i = 0; closed && i < ring.size(); i += 2) {
+                closed = ring[i] == ring[i + 1] && (i + 2 == ring.size() || ring[i + 2] != ring[i]);
+            }
+            interior[v] = closed ? 1 : 0;
+            count += closed ? 1.0 : 0.0;
+        }
+        return count;
+    });
+    if (interiorTotal == static_cast<double>(vertexTotal)) {
+        // Closed chart: the planarity constraints cannot all hold
+        return report;
+    }
+
+    // Surface angles, rescaled to sum to 2 pi around interior vertices, are
+    // the optimal angles; the LSCM layout angles are the starting point
+    std::vector<double> optimal(3 * triangleTotal), alpha(3 * triangleTotal);
+    pool.parallelFor(triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            double* beta = &optimal[3 * t];
+            triangleAngles(chart, t, 3, beta);
+            for (int k = 0; k < 3; k++) {
+                beta[k] = std::max(kMinAngle, std::min(kPi - kMinAngle, beta[k]));
+            }
+            double* start = &alpha[3 * t];
+            triangleAngles(chart, t, 2, start);
+            if (!(signedArea(chart, t) > 0.0) || !(start[0] > 0.0 && start[1] > 0.0 && start[2] > 0.0)) {
+                std::copy(beta, beta + 3, start);
+            }
+        }
+    });
+    std::vector<double> scale(vertexTotal, 1.0);
+    pool.parallelFor(vertexTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            if (!interior[v]) {
+                continue;
+            }
+            double sum = 0.0;
+            for (size_t k = cornerOffsets[v]; k < cornerOffsets[v + 1]; k++) {
+                sum += optimal[corners[k]];
+            }
+            scale[v] = 2.0 * kPi / sum;
+        }
+    });
+    pool.parallelFor(3 * triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) {
+            optimal[c] *= scale[indices[c]];
+        }
+    });
+    scale = std::vector<double>();
+
+    // Multipliers: one per triangle, and (planarity, reconstruction) per
+    // vertex, zero for boundary vertices
+    std::vector<double> triangleMultipliers(triangleTotal, 0.0), vertexMultipliers(2 * vertexTotal, 0.0);
+    std::vector<double> gradient(3 * triangleTotal), cotangents(3 * triangleTotal);
+    std::vector<double> triangleResidual(triangleTotal), vertexResidual(2 * vertexTotal, 0.0);
+    const double equationTotal = 4.0 * triangleTotal + 2.0 * interiorTotal;
+
+    // Evaluates the constraints and the angle gradient of the Lagrangian,
+    // and returns the root mean square of the whole gradient
+    auto evaluate = [&]() {
+        double sum = parallelSum(vertexTotal, [&](size_t begin, size_t end) {
+            double squares = 0.0;
+            for (size_t v = begin; v < end; v++) {
+                if (!interior[v]) {
+                    continue;
+                }
+                double planarity = -2.0 * kPi, reconstruction = 0.0;
+                for (size_t k = cornerOffsets[v]; k < cornerOffsets[v + 1]; k++) {
+                    const size_t base = corners[k] - corners[k] % 3;
+                    const size_t j = corners[k] % 3;
+                    planarity += alpha[corners[k]];
+                    reconstruction += std::log(std::sin(alpha[base + (j + 1) % 3])) -
+                                      std::log(std::sin(alpha[base + (j + 2) % 3]));
+                }
+                vertexResidual[2 * v] = planarity;
+                vertexResidual[2 * v + 1] = reconstruction;
+                squares += planarity * planarity + reconstruction * reconstruction;
+            }
+            return squares;
+        });
+        sum += parallelSum(triangleTotal, [&](size_t begin, size_t end) {
+            double squares = 0.0;
+            for (size_t t = begin; t < end; t++) {
+                const double residual = alpha[3 * t] + alpha[3 * t + 1] + alpha[3 * t + 2] - kPi;
+                triangleResidual[t] = residual;
+                squares += residual * residual;
+                for (int k = 0; k < 3; k++) {
+                    const size_t c = 3 * t + k;
+                    const unsigned int vertex = indices[c];
+                    const unsigned int before = indices[3 * t + (k + 2) % 3];
+                    const unsigned int after = indices[3 * t + (k + 1) % 3];
+                    cotangents[c] = 1.0 / std::tan(alpha[c]);
+
+                    // Corner k follows the vertex before it and precedes the one after it
+                    double g = 2.0 * (alpha[c] - optimal[c]) / (optimal[c] * optimal[c]) + triangleMultipliers[t];
+                    g += interior[vertex] ? vertexMultipliers[2 * vertex] : 0.0;
+                    g += interior[before] ? cotangents[c] * vertexMultipliers[2 * before + 1] : 0.0;
+                    g -= interior[after] ? cotangents[c] * vertexMultipliers[2 * after + 1] : 0.0;
+                    gradient[c] = g;
+                    squares += g * g;
+                }
+            }
+            return squares;
+        });
+        return std::sqrt(sum / equationTotal);
+    };
+
+    // Reduced system of the vertex multipliers, same pattern as LSCM
+    chart.vertexNeighbors(cornerOffsets, corners, neighborOffsets, neighbors);
+    SparseMatrix matrix = SparseMatrix::blockPattern(neighborOffsets, neighbors, 2);
+    std::vector<double> rhs(2 * vertexTotal), step(2 * vertexTotal);
+    std::vector<double> eliminated(3 * triangleTotal), triangleRhs(triangleTotal);
+    MultigridPreconditioner multigrid;
+    const bool useMultigrid = options.lscm.multigrid && vertexTotal >= kMultigridVertices;
+    bool valid = true;
+
+    while (true) {
+        report.gradientNorm = evaluate();
+        if (!std::isfinite(report.gradientNorm)) {
+            valid = false;
+            break;
+        }
+        if (report.gradientNorm <= options.tolerance) {
+            report.converged = true;
+            break;
+        }
+        if (report.newtonIterations >= options.maxIterations) {
+            break;
+        }
+
+        // The Hessian of the energy is diagonal, Lambda = 2 / beta^2, and every
+        // triangle constraint touches only its own three angles. With
+        // s = Lambda^-1 and D = sum s per triangle, eliminating both leaves
+        // J2 (S - s s^T / D) J2^T for the vertex multipliers (J2: vertex
+        // constraint Jacobian), with the right-hand side below.
+        pool.parallelFor(triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                double s[3], sum = 0.0, y = 0.0;
+                for (int k = 0; k < 3; k++) {
+                    s[k] = 0.5 * optimal[3 * t + k] * optimal[3 * t + k];
+                    sum += s[k];
+                    y += s[k] * gradient[3 * t + k];
+                }
+                triangleRhs[t] = triangleResidual[t] - y;
+                for (int k = 0; k < 3; k++) {
+                    eliminated[3 * t + k] = s[k] * (gradient[3 * t + k] + triangleRhs[t] / sum);
+                }
+            }
+        });
+        pool.parallelFor(vertexTotal, kGrainSize, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; v++) {
+                const unsigned int* first = neighbors.data() + neighborOffsets[v];
+                const size_t degree = neighborOffsets[v + 1] - neighborOffsets[v];
+                double* values[2] = { &matrix.values[matrix.rowOffsets[2 * v]],
+                                      &matrix.values[matrix.rowOffsets[2 * v + 1]] };
+                std::fill(values[0], values[0] + 2 * degree, 0.0);
+                std::fill(values[1], values[1] + 2 * degree, 0.0);
+                if (!interior[v]) {
+                    // Boundary multipliers stay zero
+                    const size_t self = std::lower_bound(first, first + degree, static_cast<unsigned int>(v)) - first;
+                    values[0][2 * self] = 1.0;
+                    values[1][2 * self + 1] = 1.0;
+                    rhs[2 * v] = rhs[2 * v + 1] = 0.0;
+                    continue;
+                }
+                double b[2] = { vertexResidual[2 * v], vertexResidual[2 * v + 1] };
+                for (size_t k = cornerOffsets[v]; k < cornerOffsets[v + 1]; k++) {
+                    const size_t t = corners[k] / 3;
+                    const size_t j = corners[k] % 3;
+                    bool inside[3];
+                    double s[3], sum = 0.0;
+                    for (int i = 0; i < 3; i++) {
+                        inside[i] = interior[indices[3 * t + i]] != 0;
+                        s[i] = 0.5 * optimal[3 * t + i] * optimal[3 * t + i];
+                        sum += s[i];
+                    }
+                    const TriangleJacobian jacobian = triangleJacobian(inside, &cotangents[3 * t]);
+
+                    // Rows of v times (S - s s^T / D)
+                    double weighted[2][3];
+                    for (int r = 0; r < 2; r++) {
+                        const double* row = jacobian.row[j][r];
+                        const double projection = (row[0] * s[0] + row[1] * s[1] + row[2] * s[2]) / sum;
+                        for (int m = 0; m < 3; m++) {
+                            weighted[r][m] = (row[m] - projection) * s[m];
+                        }
+                        b[r] -= row[0] * eliminated[3 * t] + row[1] * eliminated[3 * t + 1] +
+                                row[2] * eliminated[3 * t + 2];
+                    }
+                    for (int i = 0; i < 3; i++) {
+                        const unsigned int other = indices[3 * t + i];
+                        const size_t column = std::lower_bound(first, first + degree, other) - first;
+                        for (int r = 0; r < 2; r++) {
+                            for (int q = 0; q < 2; q++) {
+                                const double* row = jacobian.row[i][q];
+                                values[r][2 * column + q] +=
+                                    weighted[r][0] * row[0] + weighted[r][1] * row[1] + weighted[r][2] * row[2];
+                            }
+                        }
+                    }
+                }
+                rhs[2 * v] = b[0];
+                rhs[2 * v + 1] = b[1];
+            }
+        });
+
+        // The pattern is fixed and the values change little between steps, so
+        // the hierarchy of the first step stays a good preconditioner
+        std::fill(step.begin(), step.end(), 0.0);
+        if (useMultigrid && multigrid.levelCount() == 0) {
+            multigrid.build(matrix, 2);
+        }
+        const SolverReport solve = SparseSolver::conjugateGradient(matrix, rhs, step, options.linearTolerance,
+                                                                   kMaxLinearIterations,
+                                                                   useMultigrid ? &multigrid : nullptr);
+        report.linearIterations += solve.iterations;
+
+        // Back-substitute the triangle multipliers and the angles
+        pool.parallelFor(triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                bool inside[3];
+                double s[3], sum = 0.0;
+                for (int i = 0; i < 3; i++) {
+                    inside[i] = interior[indices[3 * t + i]] != 0;
+                    s[i] = 0.5 * optimal[3 * t + i] * optimal[3 * t + i];
+                    sum += s[i];
+                }
+                const TriangleJacobian jacobian = triangleJacobian(inside, &cotangents[3 * t]);
+
+                // h = J2^T step on the corners of t
+                double h[3] = { 0.0, 0.0, 0.0 };
+                for (int j = 0; j < 3; j++) {
+                    const unsigned int vertex = indices[3 * t + j];
+                    for (int k = 0; k < 3; k++) {
+                        h[k] += jacobian.row[j][0][k] * step[2 * vertex] + jacobian.row[j][1][k] * step[2 * vertex + 1];
+                    }
+                }
+                const double triangleStep = (triangleRhs[t] - s[0] * h[0] - s[1] * h[1] - s[2] * h[2]) / sum;
+                triangleMultipliers[t] += triangleStep;
+                for (int k = 0; k < 3; k++) {
+                    alpha[3 * t + k] -= s[k] * (gradient[3 * t + k] + triangleStep + h[k]);
+                }
+            }
+        });
+        for (size_t i = 0; i < vertexMultipliers.size(); i++) {
+            vertexMultipliers[i] += step[i];
+        }
+        report.newtonIterations++;
+
+        const bool inRange = parallelSum(3 * triangleTotal, [&](size_t begin, size_t end) {
+            double outside = 0.0;
+            for (size_t c = begin; c < end; c++) {
+                outside += alpha[c] > 0.0 && alpha[c] < kPi ? 0.0 : 1.0;
+            }
+            return outside;
+        }) == 0.0;
+        if (!inRange) {
+            valid = false;
+            break;
+        }
+    }
+    report.angleMs = millisecondsSince(angleStart);
+    if (!valid) {
+        return report;
+    }
+
+    // Lay out the optimized angles starting from the LSCM layout, and keep
+    // the LSCM layout if that is not an improvement
+    std::vector<glm::vec2> initialUVs = chart.uvs;
+    LSCMOptions layoutOptions = options.lscm;
+    layoutOptions.tolerance = options.layoutTolerance;
+    report.layout = LSCM::parameterizeAngles(chart, alpha, layoutOptions);
+    const AngleDistortion distortion = angleDistortion(chart);
+    if (!(distortion.mean < report.initialDistortion.mean)) {
+        chart.uvs.swap(initialUVs);
+        return report;
+    }
+    report.distortion = distortion;
+    report.applied = true;
+    return report;
+}
@@ -0,0 +1,69 @@
+#include "AtlasBenchmark.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace {
+
+// Rim vertices per chart fan
+const int kMinRim = 6;
+const int kMaxRim = 25;
+
+// Every this many rim vertices one is pulled in to make the chart concave
+const int kNotchEvery = 3;
+const float kNotchDepth = 0.4f;
+
+const float kTwoPi = 6.28318531f;
+
+} // namespace
+
+std::vector<AtlasReport> AtlasBenchmark::run(size_t chartCount, const AtlasOptions& options) {
+    std::vector<AtlasReport> reports;
+    for (bool raster : {false, true}) {
+        AtlasOptions runOptions = options;
+        runOptions.rasterPacking = raster;
+        std::vector<UVChart> charts = makeCharts(chartCount);
+        reports.push_back(AtlasPacker::pack(charts, runOptions));
+    }
+
+    std::cout << "Atlas benchmark, " << chartCount << " charts into " << options.resolution << "x"
+              << options.resolution << " texels:" << std::endl;
+    for (size_t r = 0; r < reports.size(); r++) {
+        const AtlasReport& report = reports[r];
+        std::cout << "  " << std::setw(7) << (r == 0 ? "skyline" : "raster") << std::fixed << std::setprecision(1)
+                  << ": " << report.packMs << " ms, " << report.attempts << " passes, " << report.utilization * 100.0
+                  << "% utilization" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+    return reports;
+}
+
+std::vector<UVChart> AtlasBenchmark::makeCharts(size_t chartCount) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<UVChart> charts(chartCount);
+    for (UVChart& chart : charts) {
+        const int rim = kMinRim + static_cast<int>(uniform(random) * (kMaxRim - kMinRim + 1));
+        const float size = 0.2f + 2.0f * uniform(random) * uniform(random);
+        const float angle = uniform(random) * kTwoPi;
+        chart.uvs.push_back(glm::vec2(0.0f));
+        for (int k = 0; k < rim; k++) {
+            const float theta = angle + kTwoPi * k / rim;
+            const float radius = size * (0.5f + uniform(random)) * (k % kNotchEvery == 0 ? kNotchDepth : 1.0f);
+            chart.uvs.push_back(
+                glm::vec2(radius * std::cos(theta), radius * std::sin(theta) * (0.3f + uniform(random))));
+        }
+        for (size_t v = 0; v < chart.uvs.size(); v++) {
+            chart.vertices.push_back(static_cast<unsigned int>(v));
+            chart.positions.push_back(glm::vec3(chart.uvs[v], 0.0f));
+        }
+        for (int k = 0; k < rim; k++) {
+            chart.indices.push_back(0);
+            chart.indices.push_back(static_cast<unsigned int>(k + 1));
+            chart.indices.push_back(static_cast<unsigned int>((k + 1) % rim + 1));
+            chart.faces.push_back(static_cast<unsigned int>(k));
+        }
+    }
+    return charts;
+}
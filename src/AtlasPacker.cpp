@@ -0,0 +1,681 @@
+#include "AtlasPacker.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+// Share of the atlas the chart rectangles are first assumed to cover
+const float kInitialFill = 0.7f;
+
+// Scale search: doublings/halvings to bracket the scale, then bisection steps
+const int kBracketSteps = 24;
+const int kBisectionSteps = 10;
+
+// Raster packing refines the skyline scale: largest gain searched, and bisection steps
+const float kRasterGain = 1.125f;
+const int kRasterBisectionSteps = 4;
+
+float cross(const glm::vec2& a, const glm::vec2& b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+/**
+ * Convex hull, counter-clockwise without collinear points (monotone chain).
+ */
+std::vector<glm::vec2> convexHull(std::vector<glm::vec2> points) {
+    std::sort(points.begin(), points.end(), [](const glm::vec2& a, const glm::vec2& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.size() < 3) {
+        return points;
+    }
+    std::vector<glm::vec2> hull(2 * points.size());
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        while (k >= 2 && cross(hull[k - 1] - hull[k - 2], points[i] - hull[k - 2]) <= 0.0f) {
+            k--;
+        }
+        hull[k++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = k + 1; i-- > 0;) {
+        while (k >= lower && cross(hull[k - 1] - hull[k - 2], points[i] - hull[k - 2]) <= 0.0f) {
+            k--;
+        }
+        hull[k++] = points[i];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+/**
+ * Direction of a side of the minimum-area bounding rectangle of a convex
+ * hull (rotating calipers; the optimal rectangle has a side on a hull edge).
+ */
+glm::vec2 minimumAreaAxis(const std::vector<glm::vec2>& hull) {
+    const size_t n = hull.size();
+    glm::vec2 best(1.0f, 0.0f);
+    if (n < 3) {
+        return best;
+    }
+    float bestArea = std::numeric_limits<float>::max();
+    size_t right = 0, top = 0, left = 0;  // Support points: max along u, max along v, min along u
+    for (size_t i = 0; i < n; i++) {
+        const glm::vec2 u = glm::normalize(hull[(i + 1) % n] - hull[i]);
+        const glm::vec2 v(-u.y, u.x);
+        if (i == 0) {
+            for (size_t k = 1; k < n; k++) {
+                right = glm::dot(u, hull[k]) > glm::dot(u, hull[right]) ? k : right;
+                top = glm::dot(v, hull[k]) > glm::dot(v, hull[top]) ? k : top;
+                left = glm::dot(u, hull[k]) < glm::dot(u, hull[left]) ? k : left;
+            }
+        } else {
+            // The support points only move forward as the edge turns
+            while (glm::dot(u, hull[(right + 1) % n]) > glm::dot(u, hull[right])) {
+                right = (right + 1) % n;
+            }
+            while (glm::dot(v, hull[(top + 1) % n]) > glm::dot(v, hull[top])) {
+                top = (top + 1) % n;
+            }
+            while (glm::dot(u, hull[(left + 1) % n]) < glm::dot(u, hull[left])) {
+                left = (left + 1) % n;
+            }
+        }
+        const float area = (glm::dot(u, hull[right]) - glm::dot(u, hull[left])) *
+                           (glm::dot(v, hull[top]) - glm::dot(v, hull[i]));
+        if (area < bestArea) {
+            bestArea = area;
+            best = u;
+        }
+    }
+    return best;
+}
+
+/**
+ * Chart frame: local = (dot(uv, axis), dot(uv, perp(axis))) - origin spans
+ * [0, size].
+ */
+struct ChartFrame {
+    glm::vec2 axis = glm::vec2(1.0f, 0.0f);
+    glm::vec2 origin = glm::vec2(0.0f);
+    glm::vec2 size = glm::vec2(0.0f);
+    double area = 0.0;  ///< Texture space area of the chart triangles
+
+    glm::vec2 local(const glm::vec2& uv) const {
+        return glm::vec2(glm::dot(uv, axis), axis.x * uv.y - axis.y * uv.x) - origin;
+    }
+};
+
+/**
+ * Position of a chart in the atlas. The content occupies [x, x + width) x
+ * [y, y + height) texels; a quarter turn maps local (x, y) to (size.y - y, x).
+ */
+struct Placement {
+    unsigned int x = 0, y = 0;
+    unsigned int width = 0, height = 0;
+    bool rotated = false;
+};
+
+/**
+ * Bottom-left skyline bin of unbounded height.
+ */
+class Skyline {
+public:
+    Skyline(unsigned int left, unsigned int right, unsigned int bottom) : right(right), top(bottom) {
+        nodes.push_back(Node{ left, bottom, right - left });
+    }
+
+    /**
+     * Finds the lowest spot for a w x h rectangle, leftmost on ties.
+     */
+    bool find(unsigned int w, unsigned int h, size_t& bestNode, unsigned int& bestX, unsigned int& bestY) const {
+        bool found = false;
+        unsigned int bestTop = std::numeric_limits<unsigned int>::max();
+        for (size_t i = 0; i < nodes.size(); i++) {
+            unsigned int y;
+            if (fits(i, w, y) && y + h < bestTop) {
+                bestTop = y + h;
+                bestNode = i;
+                bestX = nodes[i].x;
+                bestY = y;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    void add(size_t node, unsigned int w, unsigned int h, unsigned int y) {
+        const unsigned int x = nodes[node].x;
+        nodes.insert(nodes.begin() + node, Node{ x, y + h, w });
+        for (size_t i = node + 1; i < nodes.size() && nodes[i].x < x + w;) {
+            const unsigned int shrink = x + w - nodes[i].x;
+            if (shrink >= nodes[i].width) {
+                nodes.erase(nodes.begin() + i);
+            } else {
+                nodes[i].x += shrink;
+                nodes[i].width -= shrink;
+                break;
+            }
+        }
+        for (size_t i = 0; i + 1 < nodes.size();) {
+            if (nodes[i].y == nodes[i + 1].y) {
+                nodes[i].width += nodes[i + 1].width;
+                nodes.erase(nodes.begin() + i + 1);
+            } else {
+                i++;
+            }
+        }
+        top = std::max(top, y + h);
+    }
+
+    unsigned int height() const { return top; }
+
+private:
+    struct Node {
+        unsigned int x, y, width;
+    };
+
+    bool fits(size_t node, unsigned int w, unsigned int& y) const {
+        if (nodes[node].x + w > right) {
+            return false;
+        }
+        y = nodes[node].y;
+        for (unsigned int covered = 0; covered < w; node++) {
+            y = std::max(y, nodes[node].y);
+            covered += nodes[node].width;
+        }
+        return true;
+    }
+
+    std::vector<Node> nodes;  ///< Skyline segments from left to right
+    unsigned int right;  ///< Right edge of the bin
+    unsigned int top;  ///< Highest rectangle top
+};
+
+/**
+ * One bit per texel, rows padded to 64-bit words.
+ */
+struct BitImage {
+    unsigned int width = 0, height = 0, words = 0;
+    std::vector<uint64_t> bits;
+
+    void resize(unsigned int w, unsigned int h) {
+        width = w;
+        height = h;
+        words = (w + 63) / 64;
+        bits.resize(static_cast<size_t>(words) * h, 0);
+    }
+
+    const uint64_t* row(unsigned int y) const { return &bits[static_cast<size_t>(y) * words]; }
+    uint64_t* row(unsigned int y) { return &bits[static_cast<size_t>(y) * words]; }
+
+    /**
+     * True if any set bit of mask, placed at (x, y), is set here too.
+     */
+    bool overlaps(const BitImage& mask, unsigned int x, unsigned int y) const {
+        for (unsigned int r = 0; r < mask.height && y + r < height; r++) {
+            const uint64_t* target = row(y + r);
+            const uint64_t* source = mask.row(r);
+            for (unsigned int i = 0; i < mask.words; i++) {
+                if (source[i] == 0) {
+                    continue;
+                }
+                const unsigned int bit = x + 64 * i, word = bit >> 6, shift = bit & 63;
+                if (target[word] & (source[i] << shift)) {
+                    return true;
+                }
+                if (shift && word + 1 < words && (target[word + 1] & (source[i] >> (64 - shift)))) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void stamp(const BitImage& mask, unsigned int x, unsigned int y) {
+        if (y + mask.height > height) {
+            resize(width, y + mask.height);
+        }
+        for (unsigned int r = 0; r < mask.height; r++) {
+            uint64_t* target = row(y + r);
+            const uint64_t* source = mask.row(r);
+            for (unsigned int i = 0; i < mask.words; i++) {
+                const unsigned int bit = x + 64 * i, word = bit >> 6, shift = bit & 63;
+                target[word] |= source[i] << shift;
+                if (shift && word + 1 < words) {
+                    target[word + 1] |= source[i] >> (64 - shift);
+                }
+            }
+        }
+    }
+
+    /**
+     * Clears the set bits of mask, placed at (x, y).
+     */
+    void erase(const BitImage& mask, unsigned int x, unsigned int y) {
+        for (unsigned int r = 0; r < mask.height && y + r < height; r++) {
+            uint64_t* target = row(y + r);
+            const uint64_t* source = mask.row(r);
+            for (unsigned int i = 0; i < mask.words; i++) {
+                const unsigned int bit = x + 64 * i, word = bit >> 6, shift = bit & 63;
+                target[word] &= ~(source[i] << shift);
+                if (shift && word + 1 < words) {
+                    target[word + 1] &= ~(source[i] >> (64 - shift));
+                }
+            }
+        }
+    }
+};
+
+/**
+ * Rasterized chart: the texels its triangles touch (conservatively), and
+ * the same grown by the padding. Both cover the content plus a padding
+ * border on every side.
+ */
+struct ChartMask {
+    BitImage texels;
+    BitImage padded;
+};
+
+void rasterizeChart(const UVChart& chart, const ChartFrame& frame, const Placement& placement, float scale,
+                    unsigned int padding, ChartMask& mask) {
+    const unsigned int width = placement.width + 2 * padding, height = placement.height + 2 * padding;
+    mask.texels = BitImage();
+    mask.padded = BitImage();
+    mask.texels.resize(width, height);
+    mask.padded.resize(width, height);
+    auto toGrid = [&](const glm::vec2& uv) {
+        glm::vec2 p = frame.local(uv);
+        if (placement.rotated) {
+            p = glm::vec2(frame.size.y - p.y, p.x);
+        }
+        return p * scale + glm::vec2(static_cast<float>(padding));
+    };
+
+    for (size_t t = 0; t < chart.triangleCount(); t++) {
+        glm::vec2 q[3] = { toGrid(chart.uvs[chart.indices[3 * t]]), toGrid(chart.uvs[chart.indices[3 * t + 1]]),
+                           toGrid(chart.uvs[chart.indices[3 * t + 2]]) };
+        const float area = cross(q[1] - q[0], q[2] - q[0]);
+        if (area < 0.0f) {
+            std::swap(q[1], q[2]);
+        }
+        const glm::vec2 lo = glm::min(q[0], glm::min(q[1], q[2]));
+        const glm::vec2 hi = glm::max(q[0], glm::max(q[1], q[2]));
+        const unsigned int x0 = static_cast<unsigned int>(glm::clamp(std::floor(lo.x), 0.0f, width - 1.0f));
+        const unsigned int y0 = static_cast<unsigned int>(glm::clamp(std::floor(lo.y), 0.0f, height - 1.0f));
+        const unsigned int x1 = static_cast<unsigned int>(glm::clamp(std::floor(hi.x), 0.0f, width - 1.0f));
+        const unsigned int y1 = static_cast<unsigned int>(glm::clamp(std::floor(hi.y), 0.0f, height - 1.0f));
+
+        // The texel square touches the triangle if, for every edge, its
+        // corner farthest inside is on the inner side. Degenerate triangles
+        // cover their whole bounds
+        glm::vec2 edges[3];
+        float reach[3];
+        for (int k = 0; k < 3; k++) {
+            edges[k] = q[(k + 1) % 3] - q[k];
+            reach[k] = area != 0.0f ? 0.5f * (std::abs(edges[k].x) + std::abs(edges[k].y)) : 1.0f;
+            edges[k] = area != 0.0f ? edges[k] : glm::vec2(0.0f);
+        }
+        for (unsigned int y = y0; y <= y1; y++) {
+            uint64_t* row = mask.texels.row(y);
+            for (unsigned int x = x0; x <= x1; x++) {
+                const glm::vec2 center(x + 0.5f, y + 0.5f);
+                if (cross(edges[0], center - q[0]) + reach[0] > 0.0f &&
+                    cross(edges[1], center - q[1]) + reach[1] > 0.0f &&
+                    cross(edges[2], center - q[2]) + reach[2] > 0.0f) {
+                    row[x >> 6] |= uint64_t(1) << (x & 63);
+                }
+            }
+        }
+    }
+
+    // Grow by the padding: shift each row a texel at a time both ways, then merge the rows around
+    const unsigned int words = mask.texels.words;
+    std::vector<uint64_t> grown(mask.texels.bits);
+    std::vector<uint64_t> right(words), left(words);
+    for (unsigned int y = 0; y < height; y++) {
+        const uint64_t* source = mask.texels.row(y);
+        uint64_t* target = &grown[static_cast<size_t>(y) * words];
+        std::copy(source, source + words, right.begin());
+        std::copy(source, source + words, left.begin());
+        for (unsigned int step = 0; step < padding; step++) {
+            for (unsigned int i = words; i-- > 0;) {
+                right[i] = (right[i] << 1) | (i > 0 ? right[i - 1] >> 63 : 0);
+            }
+            for (unsigned int i = 0; i < words; i++) {
+                left[i] = (left[i] >> 1) | (i + 1 < words ? left[i + 1] << 63 : 0);
+                target[i] |= right[i] | left[i];
+            }
+        }
+    }
+    const uint64_t lastWord = width & 63 ? (uint64_t(1) << (width & 63)) - 1 : ~uint64_t(0);
+    for (unsigned int y = 0; y < height; y++) {
+        const unsigned int from = y > padding ? y - padding : 0, to = std::min(height - 1, y + padding);
+        uint64_t* target = mask.padded.row(y);
+        for (unsigned int r = from; r <= to; r++) {
+            const uint64_t* source = &grown[static_cast<size_t>(r) * words];
+            for (unsigned int i = 0; i < words; i++) {
+                target[i] |= source[i];
+            }
+        }
+        target[words - 1] &= lastWord;
+    }
+}
+
+/**
+ * One packing pass at a fixed scale.
+ */
+class PackingPass {
+public:
+    PackingPass(const std::vector<UVChart>& charts, const std::vector<ChartFrame>& frames,
+                const std::vector<size_t>& order, const AtlasOptions& options)
+        : charts(charts), frames(frames), order(order), options(options) {}
+
+    /**
+     * Places all charts; returns the top of the highest chart plus the
+     * padding, which must not exceed the resolution. Zero means a chart is
+     * wider than the atlas at this scale.
+     */
+    unsigned int run(float scale, std::vector<Placement>& placements) const {
+        const unsigned int resolution = options.resolution, padding = options.padding;
+        placements.assign(charts.size(), Placement());
+        for (size_t c = 0; c < charts.size(); c++) {
+            placements[c].width = std::max(1u, static_cast<unsigned int>(std::ceil(frames[c].size.x * scale)));
+            placements[c].height = std::max(1u, static_cast<unsigned int>(std::ceil(frames[c].size.y * scale)));
+        }
+
+        // Skyline over padded cells: the content plus the padding right and above
+        Skyline skyline(padding, resolution, padding);
+        for (size_t c : order) {
+            Placement& placement = placements[c];
+            size_t node = 0, turnedNode = 0;
+            unsigned int x = 0, y = 0, turnedX = 0, turnedY = 0;
+            const bool upright = skyline.find(placement.width + padding, placement.height + padding, node, x, y);
+            const bool turned =
+                options.rotateCharts && placement.width != placement.height &&
+                skyline.find(placement.height + padding, placement.width + padding, turnedNode, turnedX, turnedY);
+            if (!upright && !turned) {
+                return 0;
+            }
+            if (turned && (!upright || turnedY + placement.width < y + placement.height)) {
+                std::swap(placement.width, placement.height);
+                placement.rotated = true;
+                node = turnedNode;
+                x = turnedX;
+                y = turnedY;
+            }
+            placement.x = x;
+            placement.y = y;
+            skyline.add(node, placement.width + padding, placement.height + padding, y);
+        }
+        if (!options.rasterPacking) {
+            return skyline.height();
+        }
+        return compact(scale, skyline.height(), placements);
+    }
+
+private:
+    const std::vector<UVChart>& charts;
+    const std::vector<ChartFrame>& frames;
+    const std::vector<size_t>& order;
+    const AtlasOptions& options;
+
+    /**
+     * Slides every chart, in packing order, down and left against the
+     * rasterized charts before it. Charts not slid yet hold their skyline
+     * place, so no chart is pushed up and the packing never grows taller.
+     */
+    unsigned int compact(float scale, unsigned int height, std::vector<Placement>& placements) const {
+        const unsigned int resolution = options.resolution, padding = options.padding;
+        std::vector<ChartMask> masks(charts.size());
+        ThreadPool::global().run(charts.size(), [&](size_t c) {
+            rasterizeChart(charts[c], frames[c], placements[c], scale, padding, masks[c]);
+        });
+
+        // Masks start padding texels before the content. Skyline cells keep
+        // the padding between contents, so the pending texels never overlap
+        // and can be erased one chart at a time
+        BitImage atlas, pending;
+        atlas.resize(resolution, height + padding);
+        pending.resize(resolution, height + padding);
+        for (size_t c : order) {
+            pending.stamp(masks[c].texels, placements[c].x - padding, placements[c].y - padding);
+        }
+        auto blocked = [&](const ChartMask& mask, unsigned int x, unsigned int y) {
+            return atlas.overlaps(mask.texels, x, y) || pending.overlaps(mask.padded, x, y);
+        };
+        unsigned int top = padding;
+        for (size_t c : order) {
+            const ChartMask& mask = masks[c];
+            unsigned int x = placements[c].x - padding, y = placements[c].y - padding;
+            pending.erase(mask.texels, x, y);
+            while (blocked(mask, x, y)) {
+                y++;
+            }
+            for (bool moved = true; moved;) {
+                moved = false;
+                while (y > 0 && !blocked(mask, x, y - 1)) {
+                    y--;
+                    moved = true;
+                }
+                while (x > 0 && !blocked(mask, x - 1, y)) {
+                    x--;
+                    moved = true;
+                }
+            }
+            atlas.stamp(mask.padded, x, y);
+            placements[c].x = x + padding;
+            placements[c].y = y + padding;
+            top = std::max(top, y + 2 * padding + placements[c].height);
+        }
+        return top;
+    }
+};
+
+} // namespace
+
+AtlasReport AtlasPacker::pack(std::vector<UVChart>& charts, const AtlasOptions& options) {
+    auto packStart = std::chrono::high_resolution_clock::now();
+    AtlasReport report;
+    const size_t chartCount = charts.size();
+    if (chartCount == 0 || options.resolution <= 2 * options.padding) {
+        return report;
+    }
+
+    // Frame of every chart: minimum-area rectangle, bounds and area
+    std::vector<ChartFrame> frames(chartCount);
+    ThreadPool::global().run(chartCount, [&](size_t c) {
+        const UVChart& chart = charts[c];
+        ChartFrame& frame = frames[c];
+        if (chart.uvs.empty()) {
+            return;
+        }
+        if (options.rotateCharts) {
+            frame.axis = minimumAreaAxis(convexHull(chart.uvs));
+        }
+        glm::vec2 lo = frame.local(chart.uvs[0]), hi = lo;
+        for (const glm::vec2& uv : chart.uvs) {
+            lo = glm::min(lo, frame.local(uv));
+            hi = glm::max(hi, frame.local(uv));
+        }
+        frame.origin = lo;
+        frame.size = hi - lo;
+        for (size_t t = 0; t < chart.triangleCount(); t++) {
+            const glm::vec2 a = chart.uvs[chart.indices[3 * t]];
+            frame.area += 0.5 * std::abs(cross(chart.uvs[chart.indices[3 * t + 1]] - a,
+                                               chart.uvs[chart.indices[3 * t + 2]] - a));
+        }
+    });
+
+    // Largest charts first: longest side, then area, then index
+    std::vector<size_t> order(chartCount);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const float sideA = std::max(frames[a].size.x, frames[a].size.y);
+        const float sideB = std::max(frames[b].size.x, frames[b].size.y);
+        if (sideA != sideB) {
+            return sideA > sideB;
+        }
+        const float areaA = frames[a].size.x * frames[a].size.y, areaB = frames[b].size.x * frames[b].size.y;
+        return areaA != areaB ? areaA > areaB : a < b;
+    });
+
+    // Largest scale whose skyline packing fits: bracket, then bisect. Raster passes cost far more, so
+    // they only refine the result below
+    AtlasOptions skylineOptions = options;
+    skylineOptions.rasterPacking = false;
+    PackingPass pass(charts, frames, order, skylineOptions);
+    PackingPass rasterPass(charts, frames, order, options);
+    auto fitsWith = [&](const PackingPass& packing, float scale, std::vector<Placement>& placements) {
+        report.attempts++;
+        const unsigned int height = packing.run(scale, placements);
+        return height > 0 && height <= options.resolution;
+    };
+    auto fits = [&](float scale, std::vector<Placement>& placements) {
+        return fitsWith(pass, scale, placements);
+    };
+    double rectangleArea = 0.0;
+    for (const ChartFrame& frame : frames) {
+        rectangleArea += static_cast<double>(frame.size.x) * frame.size.y;
+    }
+    const float usable = static_cast<float>(options.resolution - options.padding);
+    float guess = rectangleArea > 0.0 ? usable * std::sqrt(kInitialFill / static_cast<float>(rectangleArea)) : 1.0f;
+
+    std::vector<Placement> best, placements;
+    float lo = 0.0f, hi = 0.0f;
+    if (fits(guess, best)) {
+        lo = guess;
+        for (int step = 0; step < kBracketSteps && hi == 0.0f; step++) {
+            if (fits(lo * 2.0f, placements)) {
+                lo *= 2.0f;
+                best.swap(placements);
+            } else {
+                hi = lo * 2.0f;
+            }
+        }
+    } else {
+        hi = guess;
+        for (int step = 0; step < kBracketSteps && lo == 0.0f; step++) {
+            if (fits(hi * 0.5f, best)) {
+                lo = hi * 0.5f;
+            } else {
+                hi *= 0.5f;
+            }
+        }
+    }
+    if (lo == 0.0f) {
+        // Too many charts for the resolution even at one texel each: keep
+        // the smallest packing and let it overflow, scaled into [0,1] below
+        lo = hi;
+        (options.rasterPacking ? rasterPass : pass).run(lo, best);
+    } else {
+        if (hi > 0.0f) {
+            for (int step = 0; step < kBisectionSteps; step++) {
+                const float middle = 0.5f * (lo + hi);
+                if (fits(middle, placements)) {
+                    lo = middle;
+                    best.swap(placements);
+                } else {
+                    hi = middle;
+                }
+            }
+        }
+
+        // Compaction never raises the skyline top, so raster passes only
+        // search above the skyline scale; should one still overflow there,
+        // the skyline packing is kept
+        if (options.rasterPacking && fitsWith(rasterPass, lo, placements)) {
+            best.swap(placements);
+            float rasterHi = lo * kRasterGain;
+            for (int step = 0; step < kRasterBisectionSteps; step++) {
+                const float middle = 0.5f * (lo + rasterHi);
+                if (fitsWith(rasterPass, middle, placements)) {
+                    lo = middle;
+                    best.swap(placements);
+                } else {
+                    rasterHi = middle;
+                }
+            }
+        }
+    }
+
+    // Texel positions -> [0,1]; an overflowing packing shrinks to fit
+    unsigned int extent = options.resolution;
+    for (const Placement& placement : best) {
+        extent = std::max(extent, std::max(placement.x + placement.width, placement.y + placement.height) +
+                                      options.padding);
+    }
+    const float toAtlas = 1.0f / static_cast<float>(extent);
+    ThreadPool::global().run(chartCount, [&](size_t c) {
+        const ChartFrame& frame = frames[c];
+        const Placement& placement = best[c];
+        const glm::vec2 corner(static_cast<float>(placement.x), static_cast<float>(placement.y));
+        for (glm::vec2& uv : charts[c].uvs) {
+            glm::vec2 p = frame.local(uv);
+            if (placement.rotated) {
+                p = glm::vec2(frame.size.y - p.y, p.x);
+            }
+            uv = (corner + p * lo) * toAtlas;
+        }
+    });
+
+    double chartArea = 0.0;
+    for (size_t c = 0; c < chartCount; c++) {
+        chartArea += frames[c].area;
+        report.rotatedCharts += best[c].rotated ? 1 : 0;
+    }
+    report.resolution = options.resolution;
+    report.texelsPerUnit = lo * static_cast<float>(options.resolution) / static_cast<float>(extent);
+    report.utilization = chartArea * lo * lo / (static_cast<double>(extent) * extent);
+    report.packMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - packStart).count();
+    return report;
+}
+
+AtlasReport AtlasPacker::packAtDensity(std::vector<UVChart>& charts, const AtlasOptions& options, float texelsPerUnit,
+                                       unsigned int maxResolution) {
+    auto packStart = std::chrono::high_resolution_clock::now();
+    double chartArea = 0.0;
+    for (const UVChart& chart : charts) {
+        for (size_t t = 0; t < chart.triangleCount(); t++) {
+            const glm::vec2 a = chart.uvs[chart.indices[3 * t]];
+            chartArea += 0.5 * std::abs(cross(chart.uvs[chart.indices[3 * t + 1]] - a,
+                                              chart.uvs[chart.indices[3 * t + 2]] - a));
+        }
+    }
+    AtlasOptions attempt = options;
+    attempt.resolution = std::min(64u, maxResolution);
+    const double texels = std::sqrt(chartArea) * texelsPerUnit;
+    while (attempt.resolution < maxResolution && attempt.resolution < texels) {
+        attempt.resolution *= 2;
+    }
+
+    // Every pass replaces the uvs, so failed passes start over from a copy
+    std::vector<std::vector<glm::vec2>> original;
+    if (attempt.resolution < maxResolution) {
+        original.reserve(charts.size());
+        for (const UVChart& chart : charts) {
+            original.push_back(chart.uvs);
+        }
+    }
+    AtlasReport report;
+    unsigned int attempts = 0;
+    for (;;) {
+        report = pack(charts, attempt);
+        attempts += report.attempts;
+        if (report.texelsPerUnit >= texelsPerUnit || attempt.resolution >= maxResolution) {
+            break;
+        }
+        for (size_t c = 0; c < charts.size(); c++) {
+            charts[c].uvs = original[c];
+        }
+        attempt.resolution = std::min(attempt.resolution * 2, maxResolution);
+    }
+    report.attempts = attempts;
+    report.packMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - packStart).count();
+    return report;
+}
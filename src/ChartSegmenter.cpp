@@ -0,0 +1,385 @@
+#include "ChartSegmenter.h"
+#include "ThreadPool.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+namespace {
+
+const unsigned int kNone = std::numeric_limits<unsigned int>::max();
+
+// Faces per parallel task
+const size_t kGrainSize = 1 << 12;
+
+const float kDegreesToRadians = 3.14159265f / 180.0f;
+
+unsigned int findRoot(std::vector<unsigned int>& parent, unsigned int v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+/**
+ * Candidate face of the growing chart; the flattest one is taken first.
+ */
+struct Candidate {
+    float cost;
+    unsigned int face;
+
+    bool operator<(const Candidate& other) const {
+        // Reversed for a min-heap; ties broken by face for determinism
+        return cost != other.cost ? cost > other.cost : face > other.face;
+    }
+};
+
+/**
+ * Segments one connected component. Faces are labeled with component-local
+ * chart numbers; returns the number of charts and the number of disc splits.
+ */
+class ComponentSegmenter {
+public:
+    ComponentSegmenter(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& normals,
+                       const std::vector<float>& areas, const std::vector<unsigned int>& adjacency,
+                       std::vector<unsigned int>& chartOfFace)
+        : indices(indices), normals(normals), areas(areas), adjacency(adjacency), chartOfFace(chartOfFace) {}
+
+    void segment(const unsigned int* faces, size_t faceCount, float cosCone) {
+        std::vector<std::vector<unsigned int>> charts;
+        grow(faces, faceCount, cosCone, charts);
+        for (std::vector<unsigned int>& chart : charts) {
+            std::sort(chart.begin(), chart.end());
+        }
+
+        // Split the charts that are not discs until all of them are
+        for (size_t c = 0; c < charts.size(); c++) {
+            while (!isDisc(charts[c], static_cast<unsigned int>(c))) {
+                std::vector<unsigned int> part;
+                split(charts[c], static_cast<unsigned int>(c), static_cast<unsigned int>(charts.size()), part);
+                charts.push_back(std::move(part));
+                splitCount++;
+            }
+        }
+        chartCount = charts.size();
+    }
+
+    size_t chartCount = 0;
+    size_t splitCount = 0;
+
+private:
+    const std::vector<unsigned int>& indices;
+    const std::vector<glm::vec3>& normals;  ///< Unit face normals (zero for degenerate faces)
+    const std::vector<float>& areas;
+    const std::vector<unsigned int>& adjacency;  ///< Face across every edge, or kNone
+    std::vector<unsigned int>& chartOfFace;
+
+    /**
+     * Normal cone region growing from the faces in order as seeds.
+     */
+    void grow(const unsigned int* faces, size_t faceCount, float cosCone,
+              std::vector<std::vector<unsigned int>>& charts) {
+        std::priority_queue<Candidate> queue;
+        for (size_t i = 0; i < faceCount; i++) {
+            if (chartOfFace[faces[i]] != kNone) {
+                continue;
+            }
+            const unsigned int chart = static_cast<unsigned int>(charts.size());
+            charts.emplace_back();
+            glm::vec3 normalSum(0.0f);
+            queue.push(Candidate{ 0.0f, faces[i] });
+            while (!queue.empty()) {
+                const unsigned int face = queue.top().face;
+                queue.pop();
+                if (chartOfFace[face] != kNone) {
+                    continue;
+                }
+
+                // The cone test uses the chart normal at the time the face is taken
+                const glm::vec3 axis = coneAxis(normalSum);
+                const bool degenerate = glm::dot(normals[face], normals[face]) == 0.0f;
+                if (!charts[chart].empty() && !degenerate && glm::dot(normals[face], axis) < cosCone) {
+                    continue;
+                }
+                chartOfFace[face] = chart;
+                charts[chart].push_back(face);
+                normalSum += normals[face] * areas[face];
+                const glm::vec3 nextAxis = coneAxis(normalSum);
+                for (int k = 0; k < 3; k++) {
+                    const unsigned int neighbor = adjacency[3 * face + k];
+                    if (neighbor != kNone && chartOfFace[neighbor] == kNone) {
+                        queue.push(Candidate{ 1.0f - glm::dot(normals[neighbor], nextAxis), neighbor });
+                    }
+                }
+            }
+        }
+    }
+
+    static glm::vec3 coneAxis(const glm::vec3& normalSum) {
+        const float length = glm::length(normalSum);
+        return length > 0.0f ? normalSum / length : glm::vec3(0.0f);
+    }
+
+    /**
+     * A connected chart is a disc if its Euler characteristic V - E + F is 1
+     * and no vertex has more than two border edges (the chart does not
+     * touch itself at a vertex).
+     */
+    bool isDisc(const std::vector<unsigned int>& faces, unsigned int chart) const {
+        if (faces.size() <= 1) {
+            return true;
+        }
+        std::vector<unsigned int> vertices, borderVertices;
+        vertices.reserve(faces.size() * 3);
+        size_t borderEdges = 0;
+        for (unsigned int face : faces) {
+            for (int k = 0; k < 3; k++) {
+                vertices.push_back(indices[3 * face + k]);
+                const unsigned int neighbor = adjacency[3 * face + k];
+                if (neighbor == kNone || chartOfFace[neighbor] != chart) {
+                    borderEdges++;
+                    borderVertices.push_back(indices[3 * face + k]);
+                    borderVertices.push_back(indices[3 * face + (k + 1) % 3]);
+                }
+            }
+        }
+        std::sort(vertices.begin(), vertices.end());
+        const size_t vertexCount = std::unique(vertices.begin(), vertices.end()) - vertices.begin();
+        const size_t edgeCount = (3 * faces.size() + borderEdges) / 2;
+        if (vertexCount + faces.size() != edgeCount + 1) {
+            return false;
+        }
+        std::sort(borderVertices.begin(), borderVertices.end());
+        for (size_t i = 0; i + 2 < borderVertices.size(); i++) {
+            if (borderVertices[i] == borderVertices[i + 2]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Splits a chart by breadth-first growth from its first face and the
+     * face farthest from it; the part around the far face becomes newChart.
+     */
+    void split(std::vector<unsigned int>& faces, unsigned int chart, unsigned int newChart,
+               std::vector<unsigned int>& part) {
+        // Farthest face in hops from the first one
+        std::vector<unsigned int> order;
+        order.reserve(faces.size());
+        order.push_back(faces[0]);
+        chartOfFace[faces[0]] = kNone;
+        for (size_t head = 0; head < order.size(); head++) {
+            for (int k = 0; k < 3; k++) {
+                const unsigned int neighbor = adjacency[3 * order[head] + k];
+                if (neighbor != kNone && chartOfFace[neighbor] == chart) {
+                    chartOfFace[neighbor] = kNone;
+                    order.push_back(neighbor);
+                }
+            }
+        }
+
+        // Grow both parts in lockstep; faces are unlabeled (kNone) meanwhile
+        std::queue<unsigned int> queue;
+        chartOfFace[order.front()] = chart;
+        chartOfFace[order.back()] = newChart;
+        queue.push(order.front());
+        queue.push(order.back());
+        while (!queue.empty()) {
+            const unsigned int face = queue.front();
+            queue.pop();
+            for (int k = 0; k < 3; k++) {
+                const unsigned int neighbor = adjacency[3 * face + k];
+                if (neighbor != kNone && chartOfFace[neighbor] == kNone &&
+                    std::binary_search(faces.begin(), faces.end(), neighbor)) {
+                    chartOfFace[neighbor] = chartOfFace[face];
+                    queue.push(neighbor);
+                }
+            }
+        }
+
+        std::vector<unsigned int> kept;
+        for (unsigned int face : faces) {
+            (chartOfFace[face] == newChart ? part : kept).push_back(face);
+        }
+        faces.swap(kept);
+    }
+};
+
+} // namespace
+
+Segmentation ChartSegmenter::segment(const PositionArray& positions, const std::vector<unsigned int>& indices,
+                                     const SegmentationOptions& options) {
+    Segmentation segmentation;
+    const size_t vertexTotal = positions.size();
+    const size_t faceTotal = indices.size() / 3;
+    ThreadPool& pool = ThreadPool::global();
+    segmentation.chartOfFace.assign(faceTotal, kNone);
+    if (faceTotal == 0) {
+        return segmentation;
+    }
+
+    // Unit normals and areas
+    std::vector<glm::vec3> normals(faceTotal);
+    std::vector<float> areas(faceTotal);
+    pool.parallelFor(faceTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; f++) {
+            const glm::vec3 p0 = positions[indices[3 * f]];
+            const glm::vec3 n = glm::cross(positions[indices[3 * f + 1]] - p0, positions[indices[3 * f + 2]] - p0);
+            const float length = glm::length(n);
+            normals[f] = length > 0.0f ? n / length : glm::vec3(0.0f);
+            areas[f] = 0.5f * length;
+        }
+    });
+
+    // Vertex -> faces table
+    std::vector<size_t> faceOffsets(vertexTotal + 1, 0);
+    for (unsigned int v : indices) {
+        faceOffsets[v + 1]++;
+    }
+    for (size_t v = 0; v < vertexTotal; v++) {
+        faceOffsets[v + 1] += faceOffsets[v];
+    }
+    std::vector<unsigned int> vertexFaces(indices.size());
+    {
+        std::vector<size_t> cursor(faceOffsets.begin(), faceOffsets.end() - 1);
+        for (size_t corner = 0; corner < indices.size(); corner++) {
+            vertexFaces[cursor[indices[corner]]++] = static_cast<unsigned int>(corner / 3);
+        }
+    }
+
+    // Face across the edge from corner k to corner k + 1. Edges shared by
+    // more than two faces, by faces of opposite orientation or bending by
+    // more than the crease angle connect nothing.
+    const float cosCrease = std::cos(options.creaseAngle * kDegreesToRadians);
+    std::vector<unsigned int> adjacency(3 * faceTotal, kNone);
+    pool.parallelFor(faceTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; f++) {
+            for (int k = 0; k < 3; k++) {
+                const unsigned int a = indices[3 * f + k];
+                const unsigned int b = indices[3 * f + (k + 1) % 3];
+                if (a == b) {
+                    continue;
+                }
+                unsigned int match = kNone;
+                size_t matches = 0;
+                bool opposite = false;
+                for (size_t i = faceOffsets[a]; i < faceOffsets[a + 1]; i++) {
+                    const unsigned int g = vertexFaces[i];
+                    if (g == f || (i > faceOffsets[a] && vertexFaces[i - 1] == g)) {
+                        continue;
+                    }
+                    for (int m = 0; m < 3; m++) {
+                        if (indices[3 * g + m] == b) {
+                            matches++;
+                            match = g;
+                            opposite = indices[3 * g + (m + 1) % 3] == a;
+                        }
+                    }
+                }
+                if (matches != 1 || !opposite) {
+                    continue;
+                }
+                const bool degenerate = glm::dot(normals[f], normals[f]) == 0.0f ||
+                                        glm::dot(normals[match], normals[match]) == 0.0f;
+                if (degenerate || glm::dot(normals[f], normals[match]) >= cosCrease) {
+                    adjacency[3 * f + k] = match;
+                }
+            }
+        }
+    });
+    faceOffsets = std::vector<size_t>();
+    vertexFaces = std::vector<unsigned int>();
+
+    // Connected components, numbered in order of their first face
+    std::vector<unsigned int> parent(faceTotal);
+    std::iota(parent.begin(), parent.end(), 0u);
+    for (size_t f = 0; f < faceTotal; f++) {
+        for (int k = 0; k < 3; k++) {
+            const unsigned int g = adjacency[3 * f + k];
+            if (g != kNone) {
+                const unsigned int a = findRoot(parent, static_cast<unsigned int>(f));
+                const unsigned int b = findRoot(parent, g);
+                if (a != b) {
+                    parent[std::max(a, b)] = std::min(a, b);
+                }
+            }
+        }
+    }
+    std::vector<unsigned int> componentOf(faceTotal);
+    std::vector<unsigned int> componentOfRoot(faceTotal, kNone);
+    size_t componentCount = 0;
+    for (size_t f = 0; f < faceTotal; f++) {
+        const unsigned int root = findRoot(parent, static_cast<unsigned int>(f));
+        if (componentOfRoot[root] == kNone) {
+            componentOfRoot[root] = static_cast<unsigned int>(componentCount++);
+        }
+        componentOf[f] = componentOfRoot[root];
+    }
+    parent = std::vector<unsigned int>();
+    componentOfRoot = std::vector<unsigned int>();
+
+    std::vector<size_t> componentOffsets(componentCount + 1, 0);
+    for (unsigned int component : componentOf) {
+        componentOffsets[component + 1]++;
+    }
+    for (size_t c = 0; c < componentCount; c++) {
+        componentOffsets[c + 1] += componentOffsets[c];
+    }
+    std::vector<unsigned int> componentFaces(faceTotal);
+    {
+        std::vector<size_t> cursor(componentOffsets.begin(), componentOffsets.end() - 1);
+        for (size_t f = 0; f < faceTotal; f++) {
+            componentFaces[cursor[componentOf[f]]++] = static_cast<unsigned int>(f);
+        }
+    }
+    componentOf = std::vector<unsigned int>();
+
+    // Components never share a face, so they write their local chart
+    // numbers into one label array concurrently
+    const float cosCone = std::cos(options.maxConeAngle * kDegreesToRadians);
+    std::vector<size_t> chartCounts(componentCount), splitCounts(componentCount);
+    pool.run(componentCount, [&](size_t c) {
+        ComponentSegmenter segmenter(indices, normals, areas, adjacency, segmentation.chartOfFace);
+        segmenter.segment(&componentFaces[componentOffsets[c]], componentOffsets[c + 1] - componentOffsets[c],
+                          cosCone);
+        chartCounts[c] = segmenter.chartCount;
+        splitCounts[c] = segmenter.splitCount;
+    });
+
+    // Global chart numbers: offset the local ones by component
+    std::vector<size_t> chartBase(componentCount, 0);
+    for (size_t c = 0; c < componentCount; c++) {
+        chartBase[c] = segmentation.chartCount;
+        segmentation.chartCount += chartCounts[c];
+        segmentation.discSplits += splitCounts[c];
+    }
+    pool.run(componentCount, [&](size_t c) {
+        for (size_t k = componentOffsets[c]; k < componentOffsets[c + 1]; k++) {
+            segmentation.chartOfFace[componentFaces[k]] += static_cast<unsigned int>(chartBase[c]);
+        }
+    });
+    segmentation.componentCount = componentCount;
+
+    // Seam edges: open borders count once, edges between charts on the lower face
+    std::vector<size_t> seamPartials((faceTotal + kGrainSize - 1) / kGrainSize, 0);
+    pool.parallelFor(faceTotal, kGrainSize, [&](size_t begin, size_t end) {
+        size_t seams = 0;
+        for (size_t f = begin; f < end; f++) {
+            for (int k = 0; k < 3; k++) {
+                const unsigned int g = adjacency[3 * f + k];
+                if (g == kNone || (g > f && segmentation.chartOfFace[g] != segmentation.chartOfFace[f])) {
+                    seams++;
+                }
+            }
+        }
+        seamPartials[begin / kGrainSize] = seams;
+    });
+    for (size_t seams : seamPartials) {
+        segmentation.seamEdges += seams;
+    }
+    return segmentation;
+}
@@ -0,0 +1,297 @@
+#include "LSCM.h"
+#include "Multigrid.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// Vertices or triangles per parallel task
+const size_t kGrainSize = 1 << 12;
+
+// Charts from this size on are solved with the multigrid preconditioner
+const size_t kMultigridVertices = 4096;
+
+/**
+ * Edge vectors of a triangle in its own 2D frame: e[k] is the edge opposite
+ * corner k, and weight = 1 / (4 area). Degenerate triangles get weight 0.
+ */
+struct TriangleTerm {
+    double ex[3];
+    double ey[3];
+    double weight;
+};
+
+/**
+ * Term of a triangle laid out as (0, 0), (q1x, 0), (q2x, q2y) with q2y > 0.
+ */
+TriangleTerm frameTerm(double q1x, double q2x, double q2y) {
+    TriangleTerm term = {};
+    term.ex[0] = q2x - q1x;
+    term.ey[0] = q2y;
+    term.ex[1] = -q2x;
+    term.ey[1] = -q2y;
+    term.ex[2] = q1x;
+    term.ey[2] = 0.0;
+    term.weight = 1.0 / (2.0 * q1x * q2y);
+    return term;
+}
+
+TriangleTerm triangleTerm(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+    const double a[3] = { double(p1.x) - p0.x, double(p1.y) - p0.y, double(p1.z) - p0.z };
+    const double b[3] = { double(p2.x) - p0.x, double(p2.y) - p0.y, double(p2.z) - p0.z };
+    const double n[3] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+    const double twiceArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    const double lengthA = std::sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]);
+    if (!(twiceArea > 1e-12 * lengthA * lengthA) || lengthA == 0.0) {
+        return TriangleTerm();
+    }
+
+    // Frame: x along p1 - p0, y = normal x x, so the triangle is counter-clockwise
+    const double x[3] = { a[0] / lengthA, a[1] / lengthA, a[2] / lengthA };
+    const double y[3] = { (n[1] * x[2] - n[2] * x[1]) / twiceArea, (n[2] * x[0] - n[0] * x[2]) / twiceArea,
+                          (n[0] * x[1] - n[1] * x[0]) / twiceArea };
+    return frameTerm(lengthA, b[0] * x[0] + b[1] * x[1] + b[2] * x[2], b[0] * y[0] + b[1] * y[1] + b[2] * y[2]);
+}
+
+/**
+ * Term of a triangle with the given corner angles, scaled so that the edge
+ * p0 p1 keeps its length (the energy itself does not depend on the scale).
+ */
+TriangleTerm angleTerm(const double* angles, double length) {
+    const double sin2 = std::sin(angles[2]);
+    if (!(sin2 > 1e-12) || !(angles[0] > 0.0) || !(angles[1] > 0.0) || !(length > 0.0)) {
+        return TriangleTerm();
+    }
+    // Law of sines: the edge p0 p2 is opposite corner 1
+    const double side = length * std::sin(angles[1]) / sin2;
+    const double q2y = side * std::sin(angles[0]);
+    if (!(q2y > 1e-12 * length)) {
+        return TriangleTerm();
+    }
+    return frameTerm(length, side * std::cos(angles[0]), q2y);
+}
+
+double millisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+/**
+ * Minimizes the conformal energy of the given triangle terms, starting from
+ * and pinning against the current chart.uvs.
+ */
+LSCMReport solveConformal(UVChart& chart, std::vector<TriangleTerm>& terms, const LSCMOptions& options,
+                          std::chrono::high_resolution_clock::time_point assemblyStart) {
+    LSCMReport report;
+    ThreadPool& pool = ThreadPool::global();
+    const size_t vertexTotal = chart.vertexCount();
+    const size_t triangleTotal = chart.triangleCount();
+    if (vertexTotal < 3 || triangleTotal == 0) {
+        return report;
+    }
+
+    // Pin the two vertices farthest apart along the longer axis of the start layout
+    glm::vec2 lo = chart.uvs[0], hi = chart.uvs[0];
+    for (const glm::vec2& uv : chart.uvs) {
+        lo = glm::min(lo, uv);
+        hi = glm::max(hi, uv);
+    }
+    const int pinAxis = (hi.x - lo.x) >= (hi.y - lo.y) ? 0 : 1;
+    size_t pinA = 0, pinB = 0;
+    for (size_t i = 1; i < vertexTotal; i++) {
+        if (chart.uvs[i][pinAxis] < chart.uvs[pinA][pinAxis]) {
+            pinA = i;
+        }
+        if (chart.uvs[i][pinAxis] > chart.uvs[pinB][pinAxis]) {
+            pinB = i;
+        }
+    }
+    if (pinA == pinB) {
+        return report;
+    }
+
+    // Sparsity pattern: one 2x2 block per pair of vertices sharing a
+    // triangle; unknowns are interleaved (u0, v0, u1, v1, ...)
+    std::vector<size_t> cornerOffsets, neighborOffsets;
+    std::vector<unsigned int> corners, neighbors;
+    chart.vertexCorners(cornerOffsets, corners);
+    chart.vertexNeighbors(cornerOffsets, corners, neighborOffsets, neighbors);
+    SparseMatrix matrix = SparseMatrix::blockPattern(neighborOffsets, neighbors, 2);
+    std::vector<double> rhs(2 * vertexTotal, 0.0);
+    std::vector<char> pinned(vertexTotal, 0);
+    pinned[pinA] = pinned[pinB] = 1;
+
+    pool.parallelFor(vertexTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            const unsigned int* first = neighbors.data() + neighborOffsets[v];
+            const size_t degree = neighborOffsets[v + 1] - neighborOffsets[v];
+            double* valuesU = &matrix.values[matrix.rowOffsets[2 * v]];
+            double* valuesV = &matrix.values[matrix.rowOffsets[2 * v + 1]];
+
+            // Sum the triangle blocks: uu = vv = w (e_a . e_b), vu = -uv = w (e_a x e_b)
+            for (size_t k = cornerOffsets[v]; k < cornerOffsets[v + 1]; k++) {
+                const size_t t = corners[k] / 3;
+                const int a = static_cast<int>(corners[k] % 3);
+                const TriangleTerm& term = terms[t];
+                for (int b = 0; b < 3; b++) {
+                    const unsigned int other = chart.indices[3 * t + b];
+                    const size_t column = std::lower_bound(first, first + degree, other) - first;
+                    const double dot = term.weight * (term.ex[a] * term.ex[b] + term.ey[a] * term.ey[b]);
+                    const double cross = term.weight * (term.ex[a] * term.ey[b] - term.ey[a] * term.ex[b]);
+                    valuesU[2 * column] += dot;
+                    valuesU[2 * column + 1] -= cross;
+                    valuesV[2 * column] += cross;
+                    valuesV[2 * column + 1] += dot;
+                }
+            }
+
+            // Pinned vertices become identity rows; their columns move to the right-hand side
+            if (pinned[v]) {
+                std::fill(valuesU, valuesU + 2 * degree, 0.0);
+                std::fill(valuesV, valuesV + 2 * degree, 0.0);
+                const size_t self = std::lower_bound(first, first + degree, static_cast<unsigned int>(v)) - first;
+                valuesU[2 * self] = 1.0;
+                valuesV[2 * self + 1] = 1.0;
+                rhs[2 * v] = chart.uvs[v].x;
+                rhs[2 * v + 1] = chart.uvs[v].y;
+                continue;
+            }
+            for (size_t k = 0; k < degree; k++) {
+                if (!pinned[first[k]]) {
+                    continue;
+                }
+                const glm::vec2 pin = chart.uvs[first[k]];
+                rhs[2 * v] -= valuesU[2 * k] * pin.x + valuesU[2 * k + 1] * pin.y;
+                rhs[2 * v + 1] -= valuesV[2 * k] * pin.x + valuesV[2 * k + 1] * pin.y;
+                valuesU[2 * k] = valuesU[2 * k + 1] = 0.0;
+                valuesV[2 * k] = valuesV[2 * k + 1] = 0.0;
+            }
+        }
+    });
+    report.unknowns = matrix.rows;
+    report.nonZeros = matrix.nonZeros();
+
+    // Free the assembly tables before the solve
+    terms = std::vector<TriangleTerm>();
+    corners = std::vector<unsigned int>();
+    cornerOffsets = std::vector<size_t>();
+    neighbors = std::vector<unsigned int>();
+    neighborOffsets = std::vector<size_t>();
+    report.assemblyMs = millisecondsSince(assemblyStart);
+
+    // Warm start from the current layout, which is exact for flat charts
+    auto solveStart = std::chrono::high_resolution_clock::now();
+    std::vector<double> solution(2 * vertexTotal);
+    for (size_t v = 0; v < vertexTotal; v++) {
+        solution[2 * v] = chart.uvs[v].x;
+        solution[2 * v + 1] = chart.uvs[v].y;
+    }
+    MultigridPreconditioner multigrid;
+    const bool useMultigrid = options.multigrid && vertexTotal >= kMultigridVertices;
+    if (useMultigrid) {
+        // Translations of u and v (the default near-null space); adding the
+        // rotation and scaling modes densifies the coarse levels more than it
+        // saves iterations
+        multigrid.build(matrix, 2);
+        report.multigridLevels = multigrid.levelCount();
+    }
+    report.solver = SparseSolver::conjugateGradient(matrix, rhs, solution, options.tolerance, options.maxIterations,
+                                                    useMultigrid ? &multigrid : nullptr);
+    for (size_t v = 0; v < vertexTotal; v++) {
+        chart.uvs[v] = glm::vec2(static_cast<float>(solution[2 * v]), static_cast<float>(solution[2 * v + 1]));
+    }
+    report.solveMs = millisecondsSince(solveStart);
+    return report;
+}
+
+} // namespace
+
+void LSCM::projectToPlane(UVChart& chart) {
+    const size_t vertexTotal = chart.positions.size();
+    chart.uvs.assign(vertexTotal, glm::vec2(0.0f));
+    if (vertexTotal == 0) {
+        return;
+    }
+
+    // Area-weighted normal and bounding box
+    double normalSum[3] = { 0.0, 0.0, 0.0 };
+    double areaSum = 0.0;
+    for (size_t t = 0; t < chart.triangleCount(); t++) {
+        const glm::vec3& p0 = chart.positions[chart.indices[3 * t]];
+        glm::vec3 n = glm::cross(chart.positions[chart.indices[3 * t + 1]] - p0,
+                                 chart.positions[chart.indices[3 * t + 2]] - p0);
+        normalSum[0] += n.x;
+        normalSum[1] += n.y;
+        normalSum[2] += n.z;
+        areaSum += glm::length(n);
+    }
+    glm::vec3 lo = chart.positions[0], hi = chart.positions[0];
+    double centroid[3] = { 0.0, 0.0, 0.0 };
+    for (const glm::vec3& p : chart.positions) {
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+        centroid[0] += p.x;
+        centroid[1] += p.y;
+        centroid[2] += p.z;
+    }
+    const glm::vec3 center(static_cast<float>(centroid[0] / vertexTotal), static_cast<float>(centroid[1] / vertexTotal),
+                           static_cast<float>(centroid[2] / vertexTotal));
+
+    glm::vec3 normal(static_cast<float>(normalSum[0]), static_cast<float>(normalSum[1]),
+                     static_cast<float>(normalSum[2]));
+    const double normalLength = std::sqrt(normalSum[0] * normalSum[0] + normalSum[1] * normalSum[1] +
+                                          normalSum[2] * normalSum[2]);
+    if (!(normalLength > 0.1 * areaSum)) {
+        // Normals cancel out (closed or strongly curved chart): use the thinnest axis
+        glm::vec3 extents = hi - lo;
+        int axis = extents.x <= extents.y ? (extents.x <= extents.z ? 0 : 2) : (extents.y <= extents.z ? 1 : 2);
+        normal = glm::vec3(0.0f);
+        normal[axis] = 1.0f;
+    } else {
+        normal /= static_cast<float>(normalLength);
+    }
+    const glm::vec3 helper = std::fabs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::vec3 tangent = glm::normalize(glm::cross(helper, normal));
+    const glm::vec3 bitangent = glm::cross(normal, tangent);
+
+    ThreadPool::global().parallelFor(vertexTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            glm::vec3 offset = chart.positions[i] - center;
+            chart.uvs[i] = glm::vec2(glm::dot(offset, tangent), glm::dot(offset, bitangent));
+        }
+    });
+}
+
+LSCMReport LSCM::parameterize(UVChart& chart, const LSCMOptions& options) {
+    auto assemblyStart = std::chrono::high_resolution_clock::now();
+    projectToPlane(chart);
+    std::vector<TriangleTerm> terms(chart.triangleCount());
+    ThreadPool::global().parallelFor(terms.size(), kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            terms[t] = triangleTerm(chart.positions[chart.indices[3 * t]], chart.positions[chart.indices[3 * t + 1]],
+                                    chart.positions[chart.indices[3 * t + 2]]);
+        }
+    });
+    return solveConformal(chart, terms, options, assemblyStart);
+}
+
+LSCMReport LSCM::parameterizeAngles(UVChart& chart, const std::vector<double>& angles, const LSCMOptions& options) {
+    auto assemblyStart = std::chrono::high_resolution_clock::now();
+    if (chart.uvs.size() != chart.vertexCount()) {
+        projectToPlane(chart);
+    }
+    std::vector<TriangleTerm> terms(chart.triangleCount());
+    ThreadPool::global().parallelFor(terms.size(), kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            const unsigned int* corner = &chart.indices[3 * t];
+            if (corner[0] == corner[1] || corner[1] == corner[2] || corner[0] == corner[2]) {
+                terms[t] = TriangleTerm();
+                continue;
+            }
+            const glm::vec3 edge = chart.positions[corner[1]] - chart.positions[corner[0]];
+            terms[t] = angleTerm(&angles[3 * t], glm::length(edge));
+        }
+    });
+    return solveConformal(chart, terms, options, assemblyStart);
+}
@@ -0,0 +1,107 @@
+#include "LayoutBenchmark.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+std::vector<LayoutBenchmarkResult> LayoutBenchmark::run(const std::string& filename, const MeshLoadOptions& options,
+                                                        const Shader& shader, unsigned int frames) {
+    std::vector<LayoutBenchmarkResult> results;
+    GLuint query = 0;
+    glGenQueries(1, &query);
+    for (VertexLayout layout : {VertexLayout::Interleaved, VertexLayout::Split}) {
+        LayoutBenchmarkResult result;
+        result.layout = layout;
+
+        // UV updates need the CPU-side data; measurements would only add noise
+        MeshLoadOptions layoutOptions = options;
+        layoutOptions.vertexFormat.layout = layout;
+        layoutOptions.retainCpuData = true;
+        layoutOptions.measureUVs = false;
+        layoutOptions.buildTopology = false;
+        Mesh mesh;
+        if (!mesh.loadFromFile(filename, layoutOptions)) {
+            results.push_back(result);
+            continue;
+        }
+        result.loaded = true;
+
+        // Static draws, timed on the GPU and on the CPU frame by frame
+        draw(mesh, shader);
+        glFinish();
+        double drawMs = 0.0, drawGpuMs = 0.0;
+        for (unsigned int frame = 0; frame < frames; frame++) {
+            auto drawStart = std::chrono::high_resolution_clock::now();
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            draw(mesh, shader);
+            glEndQuery(GL_TIME_ELAPSED);
+            glFinish();
+            drawMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - drawStart)
+                          .count();
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+            drawGpuMs += static_cast<double>(elapsed) * 1e-6;
+        }
+        result.drawMs = drawMs / frames;
+        result.drawGpuMs = drawGpuMs / frames;
+
+        // Per-frame UV updates: scroll the UVs and draw with them
+        mesh.loadCpuData();
+        const std::vector<glm::vec2> baseUVs = mesh.getUVs();
+        std::vector<glm::vec2> frameUVs(baseUVs.size());
+        double updateMs = 0.0;
+        for (unsigned int frame = 0; frame < frames; frame++) {
+            const glm::vec2 scroll(static_cast<float>(frame) / frames, 0.0f);
+            for (size_t i = 0; i < baseUVs.size(); i++) {
+                frameUVs[i] = baseUVs[i] + scroll;
+            }
+            auto updateStart = std::chrono::high_resolution_clock::now();
+            mesh.updateUVs(frameUVs);
+            draw(mesh, shader);
+            glFinish();
+            updateMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - updateStart)
+                            .count();
+        }
+        result.updateMs = updateMs / frames;
+
+        // The interleaved buffer is mapped whole so the driver keeps positions and normals intact
+        const VertexFormat& format = mesh.getVertexFormat();
+        const size_t updateBytes = layout == VertexLayout::Split ? format.attributeSize(1) : format.stride();
+        result.updateMB = static_cast<double>(mesh.getVertexCount()) * updateBytes / (1024.0 * 1024.0);
+        results.push_back(result);
+    }
+    glDeleteQueries(1, &query);
+
+    std::cout << "Layout benchmark, " << frames << " frames per test:" << std::endl;
+    for (const LayoutBenchmarkResult& result : results) {
+        const char* name = result.layout == VertexLayout::Split ? "split" : "interleaved";
+        if (!result.loaded) {
+            std::cout << "  " << std::setw(11) << name << ": failed to load" << std::endl;
+            continue;
+        }
+        std::cout << "  " << std::setw(11) << name << std::fixed << std::setprecision(3)
+                  << ": static draw " << result.drawMs << " ms (GPU " << result.drawGpuMs << " ms)"
+                  << ", UV update + draw " << result.updateMs << " ms"
+                  << ", " << std::setprecision(1) << result.updateMB << " MB rewritten per update" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+    return results;
+}
+
+void LayoutBenchmark::draw(const Mesh& mesh, const Shader& shader) {
+    // Identity transforms: the comparison is about vertex fetch and upload, not shading
+    shader.use();
+    shader.setMat4("model", glm::mat4(1.0f));
+    shader.setMat4("view", glm::mat4(1.0f));
+    shader.setMat4("projection", glm::mat4(1.0f));
+    const VertexDecode& decode = mesh.getVertexDecode();
+    shader.setVec3("positionOffset", decode.positionOffset);
+    shader.setVec3("positionScale", decode.positionScale);
+    shader.setVec2("uvOffset", decode.uvOffset);
+    shader.setVec2("uvScale", decode.uvScale);
+    shader.setBool("octahedralNormals", decode.octahedralNormals);
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    mesh.bind();
+    glDrawElements(GL_TRIANGLES, mesh.getIndexCount(), GL_UNSIGNED_INT, 0);
+    mesh.unbind();
+}
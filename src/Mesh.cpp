@@ -1,378 +1,775 @@
 #include "Mesh.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "MeshKernels.h"
+#include "MeshOptimizer.h"
+#include "MeshletBuilder.h"
+#include "NormalGenerator.h"
+#include "TangentGenerator.h"
+#include "ObjParser.h"
+#include "ThreadPool.h"
+#include "UVOverlap.h"
+#include "UVProjector.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
-#include <map>
 #include <limits>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 
-Mesh::Mesh() : VAO(0), VBO(0), EBO(0), vertexCount(0), indexCount(0) {
+Mesh::Mesh() : VAO(0), VBO(0), EBO(0), texcoordVBO(0), normalVBO(0), tangentVBO(0), vertexCount(0), indexCount(0) {
 }
 
 Mesh::~Mesh() {
     cleanup();
 }
 
-bool Mesh::loadFromFile(const std::string& filename) {
+bool Mesh::loadFromFile(const std::string& filename, const MeshLoadOptions& options) {
 
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
-        return false;
+    std::cout << "Loading mesh from file: " << filename << std::endl;
+
+    vertexFormat = options.vertexFormat;
+    vertexDecode = VertexDecode();
+    meshlets.clear();
+    topology.clear();
+    cachedData.reset();
+
+    if (options.useMeshCache && loadFromCache(filename, options)) {
+        return true;
     }
 
-    std::vector<glm::vec3> temp_vertices;
-    std::vector<glm::vec2> temp_uvs;
-    std::vector<glm::vec3> temp_normals;
-    std::vector<unsigned int> vertexIndices, uvIndices, normalIndices;
+    auto parseStart = std::chrono::high_resolution_clock::now();
 
-    std::cout << "Loading mesh from file: " << filename << std::endl;
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
+    ObjData obj;
+    if (!ObjParser::parse(file.data(), file.data() + file.size(), obj)) {
+        std::cerr << "Error: Could not parse file " << filename << std::endl;
+        return false;
+    }
 
-        if (type == "v") {
-            glm::vec3 vertex;
-            iss >> vertex.x >> vertex.y >> vertex.z;
-            temp_vertices.push_back(vertex);
-        }
-        else if (type == "vt") {
-            glm::vec2 uv;
-            iss >> uv.x >> uv.y;
-            temp_uvs.push_back(uv);
-        }
-        else if (type == "vn") {
-            glm::vec3 normal;
-            iss >> normal.x >> normal.y >> normal.z;
-            temp_normals.push_back(normal);
-        }
-        else if (type == "f") {
-            std::string vertex1, vertex2, vertex3;
-            iss >> vertex1 >> vertex2 >> vertex3;
-
-            std::vector<std::string> vertices = {vertex1, vertex2, vertex3};
-            for (const auto& vertex : vertices) {
-                std::istringstream viss(vertex);
-                std::string index_str;
-                std::vector<unsigned int> face_indices;
-
-                while (std::getline(viss, index_str, '/')) {
-                    if (!index_str.empty()) {
-                        face_indices.push_back(std::stoi(index_str));
-                    }
-                    else {
-                        face_indices.push_back(0);
-                    }
-                }
+    auto parseEnd = std::chrono::high_resolution_clock::now();
+    double parseSeconds = std::chrono::duration<double>(parseEnd - parseStart).count();
+    double megabytes = static_cast<double>(file.size()) / (1024.0 * 1024.0);
+    std::cout << "Parsed " << megabytes << " MB in " << parseSeconds * 1000.0 << " ms ("
+              << (parseSeconds > 0.0 ? megabytes / parseSeconds : 0.0) << " MB/s)" << std::endl;
+    file.close();
 
-                // OBJ indices are 1-based, convert to 0-based
-                vertexIndices.push_back(face_indices[0] - 1);
-                if (face_indices.size() > 1 && face_indices[1] != 0) {
-                    uvIndices.push_back(face_indices[1] - 1);
-                }
-                if (face_indices.size() > 2 && face_indices[2] != 0) {
-                    normalIndices.push_back(face_indices[2] - 1);
-                }
-            }
-        }
+    // Share one vertex between all corners with the same position/uv/normal triple
+    std::vector<ObjCorner> uniqueCorners;
+    ObjParser::weldCorners(obj.corners, uniqueCorners, indices);
+    const size_t cornerCount = obj.corners.size();
+    obj.corners = std::vector<ObjCorner>();
+
+    vertices.resize(uniqueCorners.size());
+    normals.resize(uniqueCorners.size());
+    if (obj.hasTexcoords) {
+        uvs.resize(uniqueCorners.size());
     }
 
-    // Process the data
-    for (size_t i = 0; i < vertexIndices.size(); i++) {
-        unsigned int vertexIndex = vertexIndices[i];
-        vertices.push_back(temp_vertices[vertexIndex]);
+    // Without vn records the normals are generated from the faces, smoothed over the shared positions
+    const bool generateNormals = !obj.hasNormals && options.normals.generate;
+    std::vector<unsigned int> positionIds(generateNormals ? uniqueCorners.size() : 0);
 
-        if (!uvIndices.empty()) {
-            unsigned int uvIndex = uvIndices[i];
-            uvs.push_back(temp_uvs[uvIndex]);
-        }
-        else {
-            uvs.push_back(glm::vec2(0.0f, 0.0f));
-        }
+    ThreadPool::global().parallelFor(uniqueCorners.size(), 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const ObjCorner& corner = uniqueCorners[i];
+            vertices.set(i, obj.positions[corner.position]);
 
-        if (!normalIndices.empty()) {
-            unsigned int normalIndex = normalIndices[i];
-            normals.push_back(temp_normals[normalIndex]);
-        }
-        else {
-            normals.push_back(glm::vec3(0.0f, 1.0f, 0.0f));
+            // Leave uvs empty when the file has none so procedural UVs are generated below
+            if (obj.hasTexcoords) {
+                uvs[i] = corner.texcoord >= 0 ? obj.texcoords[corner.texcoord] : glm::vec2(0.0f, 0.0f);
+            }
+
+            if (corner.normal >= 0) {
+                normals[i] = obj.normals[corner.normal];
+            }
+            else {
+                normals[i] = glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+            if (generateNormals) {
+                positionIds[i] = static_cast<unsigned int>(corner.position);
+            }
         }
+    });
 
-        indices.push_back(i);
+    if (generateNormals) {
+        std::vector<unsigned int> sourceVertices;
+        NormalReport report = NormalGenerator::generate(vertices, positionIds, obj.positions.size(), indices, normals,
+                                                        sourceVertices, options.normals);
+        const size_t originalCount = vertices.size();
+        vertices.resize(originalCount + sourceVertices.size());
+        if (obj.hasTexcoords) {
+            uvs.resize(originalCount + sourceVertices.size());
+        }
+        ThreadPool::global().parallelFor(sourceVertices.size(), 1 << 16, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                vertices.set(originalCount + i, vertices[sourceVertices[i]]);
+                if (obj.hasTexcoords) {
+                    uvs[originalCount + i] = uvs[sourceVertices[i]];
+                }
+            }
+        });
+        std::cout << "Generated smooth normals for " << report.triangles << " triangles in " << report.generateMs
+                  << " ms (" << options.normals.creaseAngle << " degree crease, " << report.creaseVertices
+                  << " vertices split, " << report.degenerateTriangles << " degenerate triangles)" << std::endl;
     }
+    positionIds = std::vector<unsigned int>();
 
     vertexCount = vertices.size();
     indexCount = indices.size();
 
-    std::cout << "Successfully loaded " << vertices.size() << " vertices." << std::endl;
+    std::cout << "Successfully loaded " << vertices.size() << " unique vertices for "
+              << indices.size() / 3 << " triangles (" << cornerCount << " face corners)." << std::endl;
+
+    // The raw OBJ pools are no longer needed, release them before UV generation
+    obj = ObjData();
+    uniqueCorners = std::vector<ObjCorner>();
+
+    // Bounding box of the model, shared by UV generation and centering
+    auto boundsStart = std::chrono::high_resolution_clock::now();
+    glm::vec3 minBounds, maxBounds;
+    MeshKernels::computeBounds(vertices, minBounds, maxBounds);
+    glm::vec3 center = (minBounds + maxBounds) * 0.5f;
     
     // Check if UV coordinates are missing or insufficient
-    if (uvs.empty() || uvs.size() != vertices.size()) {
-        std::cout << "UV coordinates missing or incomplete. Generating procedural UVs..." << std::endl;
-        
-        // Clear existing UVs and generate new ones
-        uvs.clear();
-        uvs.resize(vertices.size());
-        
-        // Find the bounding box for the model
-        glm::vec3 minBounds = glm::vec3(std::numeric_limits<float>::max());
-        glm::vec3 maxBounds = glm::vec3(std::numeric_limits<float>::lowest());
-        
-        for (const auto& vertex : vertices) {
-            minBounds = glm::min(minBounds, vertex);
-            maxBounds = glm::max(maxBounds, vertex);
-        }
-        
-        glm::vec3 dimensions = maxBounds - minBounds;
-        glm::vec3 center = (minBounds + maxBounds) * 0.5f;
-        
-        // Check if this is the armadillo model by looking at the filename
-        bool isArmadillo = filename.find("armadillo") != std::string::npos;
-        
-        if (isArmadillo) {
-            std::cout << "Detected armadillo model. Using advanced segmentation UV mapping..." << std::endl;
-            
-            // For the armadillo, we'll use a segmentation-based approach
-            // This divides the model into regions and applies different mapping techniques to each
-            
-            // 1. First, segment the model into regions based on Y-coordinate (height)
-            const int numSegments = 10;
-            std::vector<std::vector<size_t>> segments(numSegments);
-            
-            // Assign vertices to segments
-            for (size_t i = 0; i < vertices.size(); i++) {
-                float heightRatio = (vertices[i].y - minBounds.y) / dimensions.y;
-                int segmentIndex = std::min(static_cast<int>(heightRatio * numSegments), numSegments - 1);
-                segments[segmentIndex].push_back(i);
-            }
-            
-            // 2. Process each segment with a specialized mapping technique
-            for (int segment = 0; segment < numSegments; segment++) {
-                if (segments[segment].empty()) continue;
-                
-                // Calculate segment-specific parameters
-                float segmentYMin = minBounds.y + (segment * dimensions.y) / numSegments;
-                float segmentYMax = minBounds.y + ((segment + 1) * dimensions.y) / numSegments;
-                float segmentHeight = segmentYMax - segmentYMin;
-                
-                // Calculate segment center
-                glm::vec3 segmentCenter = glm::vec3(0.0f);
-                for (size_t idx : segments[segment]) {
-                    segmentCenter += vertices[idx];
-                }
-                segmentCenter /= static_cast<float>(segments[segment].size());
-                
-                // Different mapping techniques based on segment position
-                if (segment < 3) {
-                    // Bottom segments (legs, tail) - use cylindrical mapping
-                    for (size_t idx : segments[segment]) {
-                        glm::vec3 dir = vertices[idx] - segmentCenter;
-                        float angle = atan2(dir.z, dir.x);
-                        float u = (angle + 3.14159f) / (2.0f * 3.14159f);
-                        
-                        // Normalize height within segment
-                        float v = (vertices[idx].y - segmentYMin) / segmentHeight;
-                        
-                        // Store UV with scaling for better texture detail
-                        uvs[idx] = glm::vec2(u * 2.0f, v * 2.0f);
-                    }
-                } 
-                else if (segment < 7) {
-                    // Middle segments (body, arms) - use a combination of cylindrical and spherical
-                    for (size_t idx : segments[segment]) {
-                        glm::vec3 dir = glm::normalize(vertices[idx] - segmentCenter);
-                        
-                        // Cylindrical component
-                        float angle = atan2(dir.z, dir.x);
-                        float u_cyl = (angle + 3.14159f) / (2.0f * 3.14159f);
-                        
-                        // Spherical component
-                        float u_sph = 0.5f + atan2(dir.z, dir.x) / (2.0f * 3.14159f);
-                        float v_sph = 0.5f - asin(dir.y) / 3.14159f;
-                        
-                        // Blend based on distance from central axis
-                        float distFromAxis = sqrt(dir.x * dir.x + dir.z * dir.z);
-                        float blend = glm::clamp(distFromAxis * 2.0f, 0.0f, 1.0f);
-                        
-                        float u = u_cyl;
-                        float v = (vertices[idx].y - segmentYMin) / segmentHeight;
-                        
-                        // Apply blending with spherical for extremities
-                        if (distFromAxis > 0.4f) {
-                            float extremityBlend = (distFromAxis - 0.4f) / 0.6f;
-                            u = glm::mix(u, u_sph, extremityBlend);
-                            v = glm::mix(v, v_sph, extremityBlend);
-                        }
-                        
-                        // Store UV with scaling
-                        uvs[idx] = glm::vec2(u * 3.0f, v * 3.0f);
-                    }
-                }
-                else {
-                    // Top segments (head, ears) - use spherical mapping
-                    for (size_t idx : segments[segment]) {
-                        glm::vec3 dir = glm::normalize(vertices[idx] - segmentCenter);
-                        float u = 0.5f + atan2(dir.z, dir.x) / (2.0f * 3.14159f);
-                        float v = 0.5f - asin(dir.y) / 3.14159f;
-                        
-                        // Store UV with scaling
-                        uvs[idx] = glm::vec2(u * 2.0f, v * 2.0f);
-                    }
-                }
-            }
-            
-            // 3. Post-process UVs to ensure smooth transitions between segments
-            // Create a copy of the original UVs for blending
-            std::vector<glm::vec2> originalUVs = uvs;
-            
-            // Smooth transitions by averaging with neighboring vertices
-            for (size_t i = 0; i < vertices.size(); i++) {
-                // Find segment boundaries
-                float heightRatio = (vertices[i].y - minBounds.y) / dimensions.y;
-                int segmentIndex = std::min(static_cast<int>(heightRatio * numSegments), numSegments - 1);
-                
-                // If near segment boundary, blend with neighbors
-                float segmentPos = heightRatio * numSegments - segmentIndex;
-                if (segmentPos < 0.1f || segmentPos > 0.9f) {
-                    // Find closest vertices in adjacent segments
-                    float blendFactor = (segmentPos < 0.1f) ? (0.1f - segmentPos) / 0.1f : (segmentPos - 0.9f) / 0.1f;
-                    
-                    // Simple smoothing by averaging with original
-                    uvs[i] = glm::mix(originalUVs[i], uvs[i], 0.7f); // 70% new, 30% original
-                }
-            }
-            
-            // 4. Final adjustments to ensure proper texture wrapping
-            for (auto& uv : uvs) {
-                // Ensure UVs are in [0,1] range for proper texture mapping
-                uv = glm::fract(uv);
-            }
-            
-            std::cout << "Generated segmentation-based UVs for armadillo model." << std::endl;
+    if (options.forceProceduralUVs || uvs.empty() || uvs.size() != vertices.size()) {
+        if (options.forceProceduralUVs && !uvs.empty()) {
+            std::cout << "Replacing " << uvs.size() << " UV coordinates from the file with procedural UVs..." << std::endl;
         } else {
-            // Original UV mapping for other models
-            for (size_t i = 0; i < vertices.size(); i++) {
-                // Get normalized position from vertex after centering
-                glm::vec3 pos = vertices[i] - minBounds;
-                pos /= dimensions; // Normalize to [0,1] range
-                
-                // Try several UV mapping approaches and choose the best one
-                // Approach 1: Planar mapping using XZ coordinates
-                glm::vec2 planarUV = glm::vec2(pos.x, pos.z);
-                
-                // Approach 2: Spherical mapping
-                glm::vec3 normal = glm::normalize(vertices[i] - center);
-                float u_spherical = 0.5f + atan2(normal.z, normal.x) / (2.0f * 3.14159f);
-                float v_spherical = 0.5f - asin(normal.y) / 3.14159f;
-                glm::vec2 sphericalUV = glm::vec2(u_spherical, v_spherical);
-                
-                // Approach 3: Cylindrical mapping
-                float theta = atan2(normal.z, normal.x);
-                float u_cylindrical = (theta + 3.14159f) / (2.0f * 3.14159f);
-                float v_cylindrical = (normal.y + 1.0f) * 0.5f;
-                glm::vec2 cylindricalUV = glm::vec2(u_cylindrical, v_cylindrical);
-                
-                // Choose mapping based on the shape:
-                // Use dot product with up vector to determine if we should use cylindrical vs spherical mapping
-                float upwardness = glm::dot(normal, glm::vec3(0.0f, 1.0f, 0.0f));
-                
-                if (abs(upwardness) > 0.7f) {
-                    // For top/bottom parts, use planar mapping
-                    uvs[i] = planarUV;
-                } else {
-                    // For sides, use cylindrical mapping
-                    uvs[i] = cylindricalUV;
-                }
-            }
+            std::cout << "UV coordinates missing or incomplete. Generating procedural UVs..." << std::endl;
         }
-        
-        std::cout << "Generated " << uvs.size() << " procedural UV coordinates." << std::endl;
+
+        auto uvStart = std::chrono::high_resolution_clock::now();
+        std::string projection = generateProceduralUVs(options, minBounds, maxBounds);
+        auto uvEnd = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Generated " << uvs.size() << " procedural UV coordinates with the " << projection
+                  << " projector in " << std::chrono::duration<double, std::milli>(uvEnd - uvStart).count() << " ms ("
+                  << (options.strictMath ? "strict libm" : "SIMD approximate") << " trigonometry, "
+                  << ThreadPool::global().size() << " threads)." << std::endl;
     } else {
         std::cout << "Model already has " << uvs.size() << " UV coordinates." << std::endl;
     }
     
-    // Force regeneration of UVs for the armadillo model
-    bool isArmadillo = filename.find("armadillo") != std::string::npos;
-    if (isArmadillo) {
-        std::cout << "Forcing regeneration of UVs for armadillo model..." << std::endl;
-        uvs.clear(); // Clear UVs to force regeneration
-    }
-    
-    // Find the center of the model and translate vertices to center it
-    glm::vec3 minBounds = glm::vec3(std::numeric_limits<float>::max());
-    glm::vec3 maxBounds = glm::vec3(std::numeric_limits<float>::lowest());
-    
-    // Calculate bounding box
-    for (const auto& vertex : vertices) {
-        minBounds = glm::min(minBounds, vertex);
-        maxBounds = glm::max(maxBounds, vertex);
-    }
-    
-    // Calculate center of the model
-    glm::vec3 center = (minBounds + maxBounds) * 0.5f;
-    
     // Translate all vertices to center the model at origin
-    for (auto& vertex : vertices) {
-        vertex -= center;
-    }
+    MeshKernels::subtract(vertices, center);
+    auto boundsEnd = std::chrono::high_resolution_clock::now();
     
     std::cout << "Model centered. Bounding box: (" 
               << minBounds.x << "," << minBounds.y << "," << minBounds.z << ") to ("
               << maxBounds.x << "," << maxBounds.y << "," << maxBounds.z << ")" << std::endl;
+    std::cout << "Bounds and centering passes (including UV generation) took "
+              << std::chrono::duration<double, std::milli>(boundsEnd - boundsStart).count() << " ms ("
+              << MeshKernels::isaName(MeshKernels::activeIsa()) << " kernels)" << std::endl;
     
-    // Setup the mesh
-    setupMesh();
+    if (options.optimizeIndices) {
+        optimizeBuffers(options.vertexCacheSize);
+    }
+    if (vertexFormat.tangent != TangentEncoding::None) {
+        generateTangents();
+    }
+
+    computeVertexDecode();
+    std::cout << "Vertex format " << vertexFormat.describe() << ": "
+              << static_cast<double>(getVertexBufferBytes()) / (1024.0 * 1024.0) << " MB vertex buffer" << std::endl;
+
+    // Setup the mesh, interleaving straight into the mapped vertex buffer
+    setupMesh(nullptr, indices.data());
+
+    if (options.meshlets.build) {
+        buildMeshlets(options.meshlets);
+    }
+
+    if (options.useMeshCache) {
+        auto writeVertices = [this](unsigned char* destination, size_t first, size_t count) {
+            fillVertexData(destination, first, count);
+        };
+        if (MeshCache::write(filename, cacheKey(options), writeVertices, vertexFormat, vertexDecode,
+                             vertices.size(), indices.data(), indices.size(), meshlets.data(), meshlets.size())) {
+            std::cout << "Wrote mesh cache " << MeshCache::cachePathFor(filename) << std::endl;
+        }
+    }
+
+    if (!options.retainCpuData) {
+        releaseCpuData();
+    } else {
+        if (options.buildTopology) {
+            buildTopology();
+        }
+        if (options.measureUVs) {
+            measureUVs(options.uvMetrics);
+        }
+    }
+    return true;
+}
+
+std::string Mesh::generateProceduralUVs(const MeshLoadOptions& options, const glm::vec3& minBounds,
+                                        const glm::vec3& maxBounds) {
+    UVProjectionContext context;
+    context.positions = &vertices;
+    context.normals = &normals;
+    context.indices = &indices;
+    context.topology = &topology;
+    context.minBounds = minBounds;
+    context.maxBounds = maxBounds;
+    context.strictMath = options.strictMath;
+    context.atlas = options.atlas;
+    context.smoothing = options.uvSmoothing;
+    context.texelDensity = options.texelDensity;
+
+    UVProjectorRegistry& registry = UVProjectorRegistry::instance();
+    std::unique_ptr<UVProjector> projector;
+    if (options.uvProjection == "best") {
+        const std::vector<std::string> candidates = { "planar", "box", "cylindrical", "spherical", "segmented" };
+        std::string best = UVProjector::projectBest(candidates, context, uvs);
+        if (!best.empty()) {
+            return best;
+        }
+    } else if (options.uvProjection != "auto") {
+        projector = registry.create(options.uvProjection);
+        if (!projector) {
+            std::cerr << "Warning: Unknown UV projection '" << options.uvProjection << "', detecting one instead"
+                      << std::endl;
+        }
+    }
+    if (!projector) {
+        ShapeStatistics shape = UVProjector::analyzeShape(context);
+        std::string detected = UVProjector::detect(shape);
+        std::cout << "Shape: flatness " << shape.flatness << ", elongation " << shape.elongation
+                  << ", radial variation " << shape.radialVariation << " -> " << detected << " projection" << std::endl;
+        projector = registry.create(detected);
+    }
+
+    UVProjector::projectAll(*projector, context, uvs);
+
+    // Chart based projectors cut seams: append the duplicated vertices
+    if (const UVSeamSplit* split = projector->seamSplit()) {
+        const size_t originalCount = vertices.size();
+        const size_t splitCount = split->sourceVertices.size();
+        const bool hasNormals = normals.size() == originalCount;
+        vertices.resize(originalCount + splitCount);
+        if (hasNormals) {
+            normals.resize(originalCount + splitCount);
+        }
+        ThreadPool::global().parallelFor(splitCount, 1 << 16, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const unsigned int source = split->sourceVertices[i];
+                vertices.set(originalCount + i, vertices[source]);
+                if (hasNormals) {
+                    normals[originalCount + i] = normals[source];
+                }
+            }
+        });
+        uvs.insert(uvs.end(), split->uvs.begin(), split->uvs.end());
+        indices = split->indices;
+        vertexCount = vertices.size();
+        indexCount = indices.size();
+        topology.clear();
+        std::cout << "Cut UV seams: " << splitCount << " vertices duplicated (" << originalCount << " -> "
+                  << vertices.size() << ")" << std::endl;
+    }
+    return projector->name();
+}
+
+bool Mesh::regenerateUVs(const std::string& projection, const MeshLoadOptions& options) {
+    if (!VAO || !loadCpuData()) {
+        std::cerr << "Warning: Regenerating UVs needs the CPU-side mesh data (retainCpuData)" << std::endl;
+        return false;
+    }
+    auto projectStart = std::chrono::high_resolution_clock::now();
+    const bool keepTopology = !topology.empty();
+    MeshLoadOptions settings = options;
+    settings.uvProjection = projection;
+    const size_t previousVertexCount = vertices.size();
+    glm::vec3 minBounds, maxBounds;
+    MeshKernels::computeBounds(vertices, minBounds, maxBounds);
+    std::string used = generateProceduralUVs(settings, minBounds, maxBounds);
+    if (vertexFormat.tangent != TangentEncoding::None) {
+        generateTangents();
+    }
+    const bool layoutChanged = vertices.size() != previousVertexCount;
+
+    // Positions stay encoded as they are unless the buffers are rebuilt
+    if (layoutChanged) {
+        computeVertexDecode();
+    } else {
+        computeTexcoordDecode();
+    }
+    auto uploadStart = std::chrono::high_resolution_clock::now();
+
+    size_t uploadedBytes = static_cast<size_t>(vertexCount) * vertexFormat.attributeSize(1);
+    // Regenerated tangents change the tangent stream as well, which is refilled with the rest
+    bool texcoordsOnly = !layoutChanged && vertexFormat.tangent == TangentEncoding::None && writeTexcoords();
+    if (!texcoordsOnly) {
+        uploadedBytes = getVertexBufferBytes();
+        glBindVertexArray(VAO);
+        writeVertexBuffers();
+        if (layoutChanged) {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexCount) * sizeof(unsigned int),
+                         indices.data(), GL_STATIC_DRAW);
+            uploadedBytes += static_cast<size_t>(indexCount) * sizeof(unsigned int);
+        }
+        glBindVertexArray(0);
+    }
+    auto uploadEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "Regenerated " << uvs.size() << " UVs with the " << used << " projector in "
+              << std::chrono::duration<double, std::milli>(uploadStart - projectStart).count() << " ms, wrote "
+              << static_cast<double>(uploadedBytes) / (1024.0 * 1024.0) << " MB ("
+              << (texcoordsOnly ? "texture coordinates only" : "whole buffers") << ") in "
+              << std::chrono::duration<double, std::milli>(uploadEnd - uploadStart).count() << " ms" << std::endl;
+
+    if (keepTopology && topology.empty()) {
+        buildTopology();
+    }
+    if (layoutChanged && !meshlets.empty()) {
+        buildMeshlets(options.meshlets);
+    }
+    uvMetrics = UVMetricsReport();
+    if (options.measureUVs) {
+        measureUVs(options.uvMetrics);
+    }
+    return true;
+}
+
+bool Mesh::updateUVs(const std::vector<glm::vec2>& texcoords) {
+    if (!VAO || texcoords.size() != vertexCount || !loadCpuData() || vertices.size() != vertexCount) {
+        std::cerr << "Warning: Updating UVs needs one UV per vertex and the CPU-side mesh data" << std::endl;
+        return false;
+    }
+    uvs = texcoords;
+    uvMetrics = UVMetricsReport();
+    computeTexcoordDecode();
+    if (!writeTexcoords()) {
+        writeVertexBuffers();
+    }
     return true;
 }
 
-void Mesh::setupMesh() {
+void Mesh::optimizeBuffers(unsigned int cacheSize) {
+    auto optimizeStart = std::chrono::high_resolution_clock::now();
+    VertexCacheStats before = MeshOptimizer::analyzeVertexCache(indices, vertices.size(), cacheSize);
+
+    // Weld vertices that ended up bitwise identical (e.g. repeated v/vt records)
+    std::vector<unsigned int> remap;
+    size_t weldedCount = MeshOptimizer::buildWeldRemap(vertices, uvs, normals, remap);
+    if (weldedCount < vertices.size()) {
+        MeshOptimizer::remapIndices(indices, remap);
+        MeshOptimizer::remapStream(vertices, remap, weldedCount);
+        MeshOptimizer::remapStream(uvs, remap, weldedCount);
+        MeshOptimizer::remapStream(normals, remap, weldedCount);
+    }
+
+    std::vector<size_t> clusters;
+    MeshOptimizer::optimizeVertexCache(indices, vertices.size(), cacheSize, &clusters);
+    MeshOptimizer::optimizeOverdraw(indices, vertices, clusters);
+
+    // Lay vertices out in the order the index buffer first touches them
+    size_t fetchCount = MeshOptimizer::buildFetchRemap(indices, vertices.size(), remap);
+    MeshOptimizer::remapIndices(indices, remap);
+    MeshOptimizer::remapStream(vertices, remap, fetchCount);
+    MeshOptimizer::remapStream(uvs, remap, fetchCount);
+    MeshOptimizer::remapStream(normals, remap, fetchCount);
+
+    vertexCount = vertices.size();
+    indexCount = indices.size();
+    topology.clear();
+
+    VertexCacheStats after = MeshOptimizer::analyzeVertexCache(indices, vertices.size(), cacheSize);
+    auto optimizeEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "Optimized buffers in "
+              << std::chrono::duration<double, std::milli>(optimizeEnd - optimizeStart).count() << " ms: "
+              << vertexCount << " vertices, " << clusters.size() << " clusters. "
+              << "ACMR " << before.acmr << " -> " << after.acmr << ", "
+              << "ATVR " << before.atvr << " -> " << after.atvr
+              << " (FIFO cache of " << cacheSize << ")" << std::endl;
+}
+
+void Mesh::generateTangents() {
+    std::vector<unsigned int> sourceVertices;
+    TangentReport report = TangentGenerator::generate(vertices, normals, uvs, indices, tangents, sourceVertices);
+    const size_t originalCount = vertices.size();
+    const size_t splitCount = sourceVertices.size();
+    vertices.resize(originalCount + splitCount);
+    uvs.resize(originalCount + splitCount);
+    normals.resize(originalCount + splitCount);
+    ThreadPool::global().parallelFor(splitCount, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const unsigned int source = sourceVertices[i];
+            vertices.set(originalCount + i, vertices[source]);
+            uvs[originalCount + i] = uvs[source];
+            normals[originalCount + i] = normals[source];
+        }
+    });
+    vertexCount = vertices.size();
+    indexCount = indices.size();
+    if (splitCount > 0) {
+        topology.clear();
+    }
+    std::cout << "Generated MikkTSpace tangents in " << report.generateMs << " ms: " << splitCount
+              << " vertices split on mirrored UVs, " << report.degenerateTriangles << " degenerate and "
+              << report.textureDegenerateTriangles << " zero UV area triangles" << std::endl;
+}
+
+void Mesh::buildTopology() {
+    if (topology.empty()) {
+        topology = MeshTopology::build(vertices, indices);
+    }
+    const TopologyStats& stats = topology.stats();
+    std::cout << "Built half-edge topology in " << stats.buildMs << " ms: " << stats.weldedVertices
+              << " welded vertices, " << stats.edges << " edges (" << stats.borderEdges << " border, "
+              << stats.nonManifoldEdges << " non-manifold, " << stats.degenerateEdges << " degenerate half-edges)"
+              << std::endl;
+}
+
+void Mesh::buildMeshlets(const MeshletOptions& options) {
+    MeshletReport report = MeshletBuilder::build(vertices, indices, meshlets, options);
+
+    // The GPU sees the quantized positions, which may lie slightly outside the spheres
+    float padding = 0.0f;
+    if (vertexFormat.position == PositionEncoding::Unorm16) {
+        padding = 0.5f * glm::length(vertexDecode.positionScale);
+    } else if (vertexFormat.position == PositionEncoding::Half16) {
+        glm::vec3 positionMin, positionMax;
+        MeshKernels::computeBounds(vertices, positionMin, positionMax);
+        // Half floats round to 11 significant bits
+        padding = glm::length(glm::max(glm::abs(positionMin), glm::abs(positionMax))) * std::ldexp(1.0f, -11);
+    }
+    for (Meshlet& meshlet : meshlets) {
+        meshlet.radius += padding;
+    }
+    std::cout << "Built " << report.meshlets << " meshlets in " << report.buildMs << " ms: "
+              << report.averageTriangles << " triangles and " << report.averageVertices
+              << " vertices on average, " << report.cullableCones << " with a normal cone" << std::endl;
+}
+
+void Mesh::measureUVs(const UVMetricsOptions& options) {
+    uvMetrics = UVMetrics::measure(vertices, indices, uvs, options);
+    std::cout << "UV quality in " << uvMetrics.measureMs << " ms: stretch L2 " << uvMetrics.stretchL2 << " / Linf "
+              << uvMetrics.stretchLinf << ", angle distortion " << uvMetrics.angleDistortionMean << " deg (max "
+              << uvMetrics.angleDistortionMax << "), area distortion " << uvMetrics.areaDistortion << ", "
+              << uvMetrics.texelDensity << " +- " << uvMetrics.texelDensityDeviation << " texels per unit, "
+              << uvMetrics.flippedTriangles << " flipped / " << uvMetrics.collapsedTriangles << " collapsed, "
+              << uvMetrics.overlap * 100.0 << "% overlap" << std::endl;
+    if (options.measureOverlap) {
+        UVOverlapReport overlap = UVOverlap::detect(indices, uvs);
+        std::cout << "UV overlap in " << overlap.detectMs << " ms: " << overlap.pairCount << " overlapping pairs of "
+                  << overlap.overlappingTriangles << " triangles, area " << overlap.overlapArea << " ("
+                  << overlap.candidatePairs << " candidates in a " << overlap.gridSize << "^2 grid)" << std::endl;
+    }
+}
+
+void Mesh::computeVertexDecode() {
+    glm::vec3 positionMin, positionMax;
+    MeshKernels::computeBounds(vertices, positionMin, positionMax);
+
+    glm::vec2 uvMin, uvMax;
+    texcoordBounds(uvMin, uvMax);
+
+    vertexDecode = VertexPacker(vertexFormat, positionMin, positionMax, uvMin, uvMax).decode();
+}
+
+void Mesh::computeTexcoordDecode() {
+    if (vertexFormat.texcoord == TexcoordEncoding::Float32) {
+        return;
+    }
+    glm::vec2 uvMin, uvMax;
+    texcoordBounds(uvMin, uvMax);
+    const VertexDecode decode = VertexPacker(vertexFormat, glm::vec3(0.0f), glm::vec3(0.0f), uvMin, uvMax).decode();
+    vertexDecode.uvOffset = decode.uvOffset;
+    vertexDecode.uvScale = decode.uvScale;
+}
+
+void Mesh::texcoordBounds(glm::vec2& uvMin, glm::vec2& uvMax) const {
+    uvMin = uvMax = glm::vec2(0.0f);
+    if (!uvs.empty()) {
+        uvMin = uvMax = uvs[0];
+        for (const auto& uv : uvs) {
+            uvMin = glm::min(uvMin, uv);
+            uvMax = glm::max(uvMax, uv);
+        }
+    }
+}
+
+void Mesh::fillVertexData(unsigned char* destination, size_t first, size_t count) const {
+    const VertexPacker packer(vertexFormat, vertexDecode);
+    const size_t stride = vertexFormat.stride();
+    ThreadPool::global().parallelFor(count, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t offset = begin; offset < end; offset++) {
+            const size_t i = first + offset;
+            glm::vec2 uv = i < uvs.size() ? uvs[i] : glm::vec2(0.0f);
+            glm::vec4 tangent = i < tangents.size() ? tangents[i] : glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+            packer.pack(vertices[i], uv, normals[i], tangent, destination + offset * stride);
+        }
+    });
+}
+
+void Mesh::fillAttributeData(unsigned int attribute, unsigned char* destination, size_t first, size_t count) const {
+    const VertexPacker packer(vertexFormat, vertexDecode);
+    const size_t size = vertexFormat.attributeSize(attribute);
+    ThreadPool::global().parallelFor(count, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t offset = begin; offset < end; offset++) {
+            const size_t i = first + offset;
+            if (attribute == 0) {
+                packer.packPosition(vertices[i], destination + offset * size);
+            } else if (attribute == 1) {
+                packer.packTexcoord(i < uvs.size() ? uvs[i] : glm::vec2(0.0f), destination + offset * size);
+            } else if (attribute == 2) {
+                packer.packNormal(normals[i], destination + offset * size);
+            } else {
+                packer.packTangent(i < tangents.size() ? tangents[i] : glm::vec4(1.0f, 0.0f, 0.0f, 1.0f),
+                                   destination + offset * size);
+            }
+        }
+    });
+}
+
+void Mesh::setupMesh(const unsigned char* vertexData, const unsigned int* indexData) {
     // Create buffers/arrays
+    const bool split = vertexFormat.layout == VertexLayout::Split;
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
+    if (split) {
+        glGenBuffers(1, &texcoordVBO);
+        glGenBuffers(1, &normalVBO);
+        if (vertexFormat.tangent != TangentEncoding::None) {
+            glGenBuffers(1, &tangentVBO);
+        }
+    }
     glGenBuffers(1, &EBO);
 
     glBindVertexArray(VAO);
 
-    // Create and fill vertex buffer
-    std::vector<float> vertexData;
-    for (size_t i = 0; i < vertices.size(); i++) {
-        // Position
-        vertexData.push_back(vertices[i].x);
-        vertexData.push_back(vertices[i].y);
-        vertexData.push_back(vertices[i].z);
-        // UV
-        vertexData.push_back(uvs[i].x);
-        vertexData.push_back(uvs[i].y);
-        // Normal
-        vertexData.push_back(normals[i].x);
-        vertexData.push_back(normals[i].y);
-        vertexData.push_back(normals[i].z);
+    // Fill vertex buffers
+    if (!vertexData) {
+        writeVertexBuffers();
+    } else if (!split) {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(getVertexBufferBytes()), vertexData, GL_STATIC_DRAW);
+    } else {
+        // Cached vertices are interleaved: gather every attribute into its stream
+        const size_t stride = vertexFormat.stride();
+        for (unsigned int attribute = 0; attribute < vertexFormat.attributeCount(); attribute++) {
+            const size_t offset = vertexFormat.attributeOffset(attribute);
+            const size_t size = vertexFormat.attributeSize(attribute);
+            writeBuffer(attributeBuffer(attribute), size, [&](unsigned char* destination, size_t first, size_t count) {
+                ThreadPool::global().parallelFor(count, 1 << 16, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        std::memcpy(destination + i * size, vertexData + (first + i) * stride + offset, size);
+                    }
+                });
+            });
+        }
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW);
-
-    // Set vertex attribute pointers
-    // Position attribute
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    // UV attribute
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    // Normal attribute
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float)));
+    // Set vertex attribute pointers for the chosen encoding and layout
+    const VertexPacker packer(vertexFormat, vertexDecode);
+    for (unsigned int attribute = 0; attribute < vertexFormat.attributeCount(); attribute++) {
+        glBindBuffer(GL_ARRAY_BUFFER, attributeBuffer(attribute));
+        packer.setupAttribute(attribute);
+    }
 
     // Element buffer
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexCount) * sizeof(unsigned int), indexData, GL_STATIC_DRAW);
 
     glBindVertexArray(0);
 }
 
+void Mesh::writeBuffer(GLuint buffer, size_t vertexBytes,
+                       const std::function<void(unsigned char*, size_t, size_t)>& fill) {
+    const GLsizeiptr bufferBytes = static_cast<GLsizeiptr>(static_cast<size_t>(vertexCount) * vertexBytes);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+    // Encode directly into driver memory instead of building a CPU-side copy first
+    glBufferData(GL_ARRAY_BUFFER, bufferBytes, nullptr, GL_STATIC_DRAW);
+    void* mapped = bufferBytes > 0
+        ? glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)
+        : nullptr;
+    bool uploaded = false;
+    if (mapped) {
+        fill(static_cast<unsigned char*>(mapped), 0, vertexCount);
+        // Unmapping can fail if the driver lost the storage (e.g. mode switch); re-upload below then
+        uploaded = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+    }
+    if (!uploaded && vertexCount > 0) {
+        // Fallback: stream through a bounded staging block
+        const size_t blockVertices = 1 << 16;
+        std::vector<unsigned char> staging(std::min<size_t>(blockVertices, vertexCount) * vertexBytes);
+        for (size_t first = 0; first < vertexCount; first += blockVertices) {
+            size_t count = std::min<size_t>(blockVertices, vertexCount - first);
+            fill(staging.data(), first, count);
+            glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(first * vertexBytes),
+                            static_cast<GLsizeiptr>(count * vertexBytes), staging.data());
+        }
+    }
+}
+
+void Mesh::writeVertexBuffers() {
+    if (vertexFormat.layout == VertexLayout::Interleaved) {
+        writeBuffer(VBO, vertexFormat.stride(), [this](unsigned char* destination, size_t first, size_t count) {
+            fillVertexData(destination, first, count);
+        });
+        return;
+    }
+    for (unsigned int attribute = 0; attribute < vertexFormat.attributeCount(); attribute++) {
+        writeBuffer(attributeBuffer(attribute), vertexFormat.attributeSize(attribute),
+                    [this, attribute](unsigned char* destination, size_t first, size_t count) {
+                        fillAttributeData(attribute, destination, first, count);
+                    });
+    }
+}
+
+bool Mesh::writeTexcoords() {
+    if (vertexFormat.layout == VertexLayout::Split) {
+        // The stream holds nothing else, so it is simply replaced
+        writeBuffer(texcoordVBO, vertexFormat.attributeSize(1),
+                    [this](unsigned char* destination, size_t first, size_t count) {
+                        fillAttributeData(1, destination, first, count);
+                    });
+        return true;
+    }
+
+    const size_t stride = vertexFormat.stride();
+    const size_t texcoordOffset = vertexFormat.texcoordOffset();
+    const GLsizeiptr vertexBytes = static_cast<GLsizeiptr>(getVertexBufferBytes());
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    // No invalidation: the mapping must keep the positions and normals around the UVs
+    void* mapped = vertexBytes > 0 ? glMapBufferRange(GL_ARRAY_BUFFER, 0, vertexBytes, GL_MAP_WRITE_BIT) : nullptr;
+    if (!mapped) {
+        return false;
+    }
+    unsigned char* destination = static_cast<unsigned char*>(mapped);
+    const VertexPacker packer(vertexFormat, vertexDecode);
+    ThreadPool::global().parallelFor(vertexCount, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            packer.packTexcoord(uvs[i], destination + i * stride + texcoordOffset);
+        }
+    });
+    return glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+}
+
+void Mesh::releaseCpuData() {
+    vertices.release();
+    std::vector<glm::vec2>().swap(uvs);
+    std::vector<glm::vec3>().swap(normals);
+    std::vector<glm::vec4>().swap(tangents);
+    std::vector<unsigned int>().swap(indices);
+    topology.clear();
+    cachedData.reset();
+}
+
+bool Mesh::loadFromCache(const std::string& filename, const MeshLoadOptions& options) {
+    auto cacheStart = std::chrono::high_resolution_clock::now();
+
+    std::unique_ptr<MeshCache> cache(new MeshCache());
+    if (!cache->open(filename, cacheKey(options), vertexFormat)) {
+        return false;
+    }
+
+    vertexDecode = cache->vertexDecode();
+    vertexCount = static_cast<unsigned int>(cache->vertexCount());
+    indexCount = static_cast<unsigned int>(cache->indexCount());
+
+    // Upload straight from the mapping
+    setupMesh(cache->vertexData(), cache->indexData());
+    meshlets.assign(cache->meshletData(), cache->meshletData() + cache->meshletCount());
+
+    auto cacheEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "Loaded " << vertexCount << " vertices, " << indexCount / 3 << " triangles and " << meshlets.size()
+              << " meshlets from mesh cache in "
+              << std::chrono::duration<double, std::milli>(cacheEnd - cacheStart).count() << " ms" << std::endl;
+
+    if (!options.retainCpuData) {
+        return true;
+    }
+
+    // Decoding the CPU-side streams waits until something needs them; the cached buffers need no measuring
+    cachedData = std::move(cache);
+    if (options.buildTopology && loadCpuData()) {
+        buildTopology();
+    }
+    return true;
+}
+
+bool Mesh::loadCpuData() {
+    if (!cachedData) {
+        return !vertices.empty() && !indices.empty();
+    }
+    auto restoreStart = std::chrono::high_resolution_clock::now();
+
+    // Restore the CPU-side streams from the interleaved blob (lossy for quantized formats)
+    const MeshCache& cache = *cachedData;
+    const unsigned char* vertexData = cache.vertexData();
+    vertices.resize(cache.vertexCount());
+    uvs.resize(cache.vertexCount());
+    normals.resize(cache.vertexCount());
+    const bool hasTangents = vertexFormat.tangent != TangentEncoding::None;
+    tangents.resize(hasTangents ? cache.vertexCount() : 0);
+    const VertexPacker packer(vertexFormat, vertexDecode);
+    const size_t stride = vertexFormat.stride();
+    ThreadPool::global().parallelFor(cache.vertexCount(), 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            glm::vec3 position;
+            glm::vec4 tangent;
+            packer.unpack(vertexData + i * stride, position, uvs[i], normals[i], tangent);
+            vertices.set(i, position);
+            if (hasTangents) {
+                tangents[i] = tangent;
+            }
+        }
+    });
+    indices.assign(cache.indexData(), cache.indexData() + cache.indexCount());
+    cachedData.reset();
+
+    auto restoreEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "Restored CPU-side mesh data from the cache in "
+              << std::chrono::duration<double, std::milli>(restoreEnd - restoreStart).count() << " ms" << std::endl;
+    return !vertices.empty() && !indices.empty();
+}
+
+uint64_t Mesh::cacheKey(const MeshLoadOptions& options) {
+    // Only options that change the processed vertex/index data belong here
+    uint64_t key = 1469598103934665603ull;
+    auto mix = [&key](uint64_t value) {
+        key = (key ^ value) * 1099511628211ull;
+    };
+    auto mixFloat = [&mix](float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        mix(bits);
+    };
+    mix(options.optimizeIndices ? 1 : 0);
+    mix(options.optimizeIndices ? options.vertexCacheSize : 0);
+    mix(options.vertexFormat.key());
+    mix(options.strictMath ? 1 : 0);
+    mix(options.forceProceduralUVs ? 1 : 0);
+    for (char c : options.uvProjection) {
+        mix(static_cast<unsigned char>(c));
+    }
+    mix(options.atlas.resolution);
+    mix(options.atlas.padding);
+    mix(options.atlas.rotateCharts ? 1 : 0);
+    mix(options.atlas.rasterPacking ? 1 : 0);
+    mix(options.uvSmoothing.iterations);
+    mixFloat(options.uvSmoothing.strength);
+    mixFloat(options.uvSmoothing.seamThreshold);
+    mixFloat(options.uvSmoothing.tolerance);
+    mix(options.texelDensity.equalize ? 1 : 0);
+    mixFloat(options.texelDensity.texelsPerUnit);
+    mix(options.texelDensity.maxResolution);
+    mix(options.normals.generate ? 1 : 0);
+    mixFloat(options.normals.creaseAngle);
+    mix(options.meshlets.build ? 1 : 0);
+    mix(options.meshlets.build ? options.meshlets.maxVertices : 0);
+    mix(options.meshlets.build ? options.meshlets.maxTriangles : 0);
+    return key;
+}
+
 void Mesh::bind() const {
     glBindVertexArray(VAO);
 }
@@ -390,6 +787,18 @@ void Mesh::cleanup() {
         glDeleteBuffers(1, &VBO);
         VBO = 0;
     }
+    if (texcoordVBO) {
+        glDeleteBuffers(1, &texcoordVBO);
+        texcoordVBO = 0;
+    }
+    if (normalVBO) {
+        glDeleteBuffers(1, &normalVBO);
+        normalVBO = 0;
+    }
+    if (tangentVBO) {
+        glDeleteBuffers(1, &tangentVBO);
+        tangentVBO = 0;
+    }
     if (EBO) {
         glDeleteBuffers(1, &EBO);
         EBO = 0;
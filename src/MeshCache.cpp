@@ -0,0 +1,248 @@
+#include "MeshCache.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+const char kMagic[8] = { 'U', 'V', 'M', 'C', 'A', 'C', 'H', 'E' };
+const uint32_t kByteOrderMark = 0x01020304u;
+
+/**
+ * On-disk header. All fields are fixed width and the struct has no padding;
+ * the blobs that follow start at 16-byte aligned offsets.
+ */
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    uint64_t optionsKey;
+    uint32_t vertexFormat;
+    uint32_t vertexStride;
+    uint32_t indexSize;
+    uint32_t reserved;
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t meshletCount;
+    uint64_t meshletOffset;
+    float positionOffset[3];
+    float positionScale[3];
+    float uvOffset[2];
+    float uvScale[2];
+};
+static_assert(sizeof(CacheHeader) == 144, "cache header must not contain padding");
+static_assert(sizeof(Meshlet) == 56, "meshlets are stored as they are laid out in memory");
+
+inline uint64_t alignTo16(uint64_t offset) {
+    return (offset + 15) & ~uint64_t(15);
+}
+
+/**
+ * Reads the identity of the source model. Returns false if it cannot be stat'ed.
+ */
+bool sourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& modified) {
+    std::error_code error;
+    size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, error));
+    if (error) {
+        return false;
+    }
+    auto writeTime = std::filesystem::last_write_time(sourcePath, error);
+    if (error) {
+        return false;
+    }
+    modified = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+} // namespace
+
+MeshCache::MeshCache()
+    : vertices(nullptr), indices(nullptr), meshlets(nullptr), cachedVertexCount(0), cachedIndexCount(0),
+      cachedMeshletCount(0) {
+}
+
+std::string MeshCache::cachePathFor(const std::string& sourcePath) {
+    return sourcePath + ".meshcache";
+}
+
+bool MeshCache::open(const std::string& sourcePath, uint64_t optionsKey, const VertexFormat& format) {
+    file.close();
+    vertices = nullptr;
+    indices = nullptr;
+    meshlets = nullptr;
+    cachedVertexCount = 0;
+    cachedIndexCount = 0;
+    cachedMeshletCount = 0;
+    decode = VertexDecode();
+
+    uint64_t sourceSize = 0;
+    int64_t sourceModified = 0;
+    const std::string cachePath = cachePathFor(sourcePath);
+    std::error_code error;
+    if (!sourceStamp(sourcePath, sourceSize, sourceModified) || !std::filesystem::exists(cachePath, error)) {
+        return false;
+    }
+    if (!file.open(cachePath) || file.size() < sizeof(CacheHeader)) {
+        file.close();
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+              && header.version == kVersion
+              && header.byteOrderMark == kByteOrderMark
+              && header.sourceSize == sourceSize
+              && header.sourceModified == sourceModified
+              && header.optionsKey == optionsKey
+              && header.vertexFormat == format.key()
+              && header.vertexStride == format.stride()
+              && header.indexSize == sizeof(unsigned int);
+
+    // Counts are bounded by dividing the space left after each offset, so corrupt values cannot overflow
+    const uint64_t fileSize = file.size();
+    valid = valid
+         && header.vertexOffset % 16 == 0 && header.indexOffset % 16 == 0 && header.meshletOffset % 16 == 0
+         && header.vertexOffset >= sizeof(CacheHeader)
+         && header.vertexOffset <= fileSize && header.indexOffset <= fileSize && header.meshletOffset <= fileSize
+         && header.vertexCount <= (fileSize - header.vertexOffset) / header.vertexStride
+         && header.indexCount <= (fileSize - header.indexOffset) / sizeof(unsigned int)
+         && header.meshletCount <= (fileSize - header.meshletOffset) / sizeof(Meshlet)
+         && header.vertexCount <= std::numeric_limits<unsigned int>::max()
+         && header.indexCount <= std::numeric_limits<unsigned int>::max()
+         && header.indexCount % 3 == 0;
+
+    // Every index must name a cached vertex: the indices are read on the CPU too (meshlets, topology)
+    if (valid) {
+        const unsigned int* indexData = reinterpret_cast<const unsigned int*>(file.data() + header.indexOffset);
+        const size_t indexCount = static_cast<size_t>(header.indexCount);
+        const size_t grainSize = 1 << 16;
+        std::vector<unsigned int> chunkMax((indexCount + grainSize - 1) / grainSize, 0);
+        ThreadPool::global().parallelFor(indexCount, grainSize, [&](size_t begin, size_t end) {
+            unsigned int maximum = 0;
+            for (size_t i = begin; i < end; i++) {
+                maximum = std::max(maximum, indexData[i]);
+            }
+            chunkMax[begin / grainSize] = maximum;
+        });
+        for (unsigned int maximum : chunkMax) {
+            valid = valid && maximum < header.vertexCount;
+        }
+
+        const Meshlet* meshletData = reinterpret_cast<const Meshlet*>(file.data() + header.meshletOffset);
+        for (size_t m = 0; valid && m < header.meshletCount; m++) {
+            valid = meshletData[m].firstIndex + 3 * static_cast<uint64_t>(meshletData[m].triangleCount)
+                    <= header.indexCount;
+        }
+    }
+    if (!valid) {
+        std::cout << "Mesh cache " << cachePath << " is stale or invalid, rebuilding." << std::endl;
+        file.close();
+        return false;
+    }
+
+    vertices = reinterpret_cast<const unsigned char*>(file.data() + header.vertexOffset);
+    indices = reinterpret_cast<const unsigned int*>(file.data() + header.indexOffset);
+    meshlets = reinterpret_cast<const Meshlet*>(file.data() + header.meshletOffset);
+    cachedVertexCount = static_cast<size_t>(header.vertexCount);
+    cachedIndexCount = static_cast<size_t>(header.indexCount);
+    cachedMeshletCount = static_cast<size_t>(header.meshletCount);
+    decode.positionOffset = glm::vec3(header.positionOffset[0], header.positionOffset[1], header.positionOffset[2]);
+    decode.positionScale = glm::vec3(header.positionScale[0], header.positionScale[1], header.positionScale[2]);
+    decode.uvOffset = glm::vec2(header.uvOffset[0], header.uvOffset[1]);
+    decode.uvScale = glm::vec2(header.uvScale[0], header.uvScale[1]);
+    decode.octahedralNormals = format.normal == NormalEncoding::Octahedral16;
+    return true;
+}
+
+bool MeshCache::write(const std::string& sourcePath, uint64_t optionsKey,
+                      const VertexWriter& vertexWriter, const VertexFormat& format,
+                      const VertexDecode& decode, size_t vertexCount,
+                      const unsigned int* indexData, size_t indexCount,
+                      const Meshlet* meshletData, size_t meshletCount) {
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    if (!sourceStamp(sourcePath, header.sourceSize, header.sourceModified)) {
+        return false;
+    }
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.optionsKey = optionsKey;
+    header.vertexFormat = format.key();
+    header.vertexStride = format.stride();
+    header.indexSize = sizeof(unsigned int);
+    header.vertexCount = vertexCount;
+    header.indexCount = indexCount;
+    header.vertexOffset = alignTo16(sizeof(CacheHeader));
+    header.indexOffset = alignTo16(header.vertexOffset + vertexCount * header.vertexStride);
+    header.meshletCount = meshletCount;
+    header.meshletOffset = alignTo16(header.indexOffset + indexCount * sizeof(unsigned int));
+    for (int axis = 0; axis < 3; axis++) {
+        header.positionOffset[axis] = decode.positionOffset[axis];
+        header.positionScale[axis] = decode.positionScale[axis];
+    }
+    for (int axis = 0; axis < 2; axis++) {
+        header.uvOffset[axis] = decode.uvOffset[axis];
+        header.uvScale[axis] = decode.uvScale[axis];
+    }
+
+    const std::string cachePath = cachePathFor(sourcePath);
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Warning: Could not write mesh cache " << cachePath << std::endl;
+            return false;
+        }
+
+        const char padding[16] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(padding, static_cast<std::streamsize>(header.vertexOffset - sizeof(header)));
+
+        const size_t blockVertices = 1 << 16;
+        std::vector<unsigned char> block(std::min(blockVertices, vertexCount) * header.vertexStride);
+        for (size_t first = 0; first < vertexCount; first += blockVertices) {
+            size_t count = std::min(blockVertices, vertexCount - first);
+            vertexWriter(block.data(), first, count);
+            out.write(reinterpret_cast<const char*>(block.data()),
+                      static_cast<std::streamsize>(count * header.vertexStride));
+        }
+        uint64_t written = header.vertexOffset + vertexCount * header.vertexStride;
+        out.write(padding, static_cast<std::streamsize>(header.indexOffset - written));
+        out.write(reinterpret_cast<const char*>(indexData),
+                  static_cast<std::streamsize>(indexCount * sizeof(unsigned int)));
+        written = header.indexOffset + indexCount * sizeof(unsigned int);
+        out.write(padding, static_cast<std::streamsize>(header.meshletOffset - written));
+        if (meshletCount > 0) {
+            out.write(reinterpret_cast<const char*>(meshletData),
+                      static_cast<std::streamsize>(meshletCount * sizeof(Meshlet)));
+        }
+        if (!out) {
+            std::cerr << "Warning: Could not write mesh cache " << cachePath << std::endl;
+            out.close();
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::cerr << "Warning: Could not write mesh cache " << cachePath << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
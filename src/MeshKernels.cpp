@@ -0,0 +1,576 @@
+#include "MeshKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MESH_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC accepts intrinsics of any instruction set without per-function targets
+#define MESH_KERNELS_TARGET_SSE2
+#define MESH_KERNELS_TARGET_AVX2
+#else
+#define MESH_KERNELS_TARGET_SSE2 __attribute__((target("sse2")))
+#define MESH_KERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+// Vertices per parallel task of the whole-array passes
+const size_t kGrainSize = 1 << 16;
+
+const float kPi = 3.14159265358979f;
+const float kHalfPi = 1.57079632679490f;
+const float kQuarterPi = 0.785398163397448f;
+const float kTanPiOver8 = 0.414213562373095f;
+
+// Cephes atanf coefficients, valid on [-tan(pi/8), tan(pi/8)]
+const float kAtan0 = 8.05374449538e-2f;
+const float kAtan1 = -1.38776856032e-1f;
+const float kAtan2 = 1.99777106478e-1f;
+const float kAtan3 = -3.33329491539e-1f;
+
+// Cephes asinf coefficients, valid on [0, 0.5]
+const float kAsin0 = 4.2163199048e-2f;
+const float kAsin1 = 2.4181311049e-2f;
+const float kAsin2 = 4.5470025998e-2f;
+const float kAsin3 = 7.4953002686e-2f;
+const float kAsin4 = 1.6666752422e-1f;
+
+/**
+ * Kernels of one instruction set, all operating on [0, count) of the given pointers.
+ */
+struct KernelTable {
+    void (*bounds)(const float* x, const float* y, const float* z, size_t count, float* minOut, float* maxOut);
+    void (*subtract)(float* x, float* y, float* z, size_t count, const float* offset);
+    void (*normalize)(const float* x, const float* y, const float* z, size_t count,
+                      const float* minBounds, const float* dimensions, float* outX, float* outY, float* outZ);
+    void (*project)(const float* x, const float* y, const float* z, size_t count,
+                    const float* center, float* outX, float* outY, float* outZ);
+    void (*atan2)(const float* y, const float* x, size_t count, float* out);
+    void (*asin)(const float* x, size_t count, float* out);
+};
+
+// ---- Scalar ---------------------------------------------------------------
+
+void boundsScalar(const float* x, const float* y, const float* z, size_t count, float* minOut, float* maxOut) {
+    const float* axes[3] = { x, y, z };
+    for (int axis = 0; axis < 3; axis++) {
+        float low = minOut[axis];
+        float high = maxOut[axis];
+        const float* values = axes[axis];
+        for (size_t i = 0; i < count; i++) {
+            low = std::min(low, values[i]);
+            high = std::max(high, values[i]);
+        }
+        minOut[axis] = low;
+        maxOut[axis] = high;
+    }
+}
+
+void subtractScalar(float* x, float* y, float* z, size_t count, const float* offset) {
+    for (size_t i = 0; i < count; i++) {
+        x[i] -= offset[0];
+        y[i] -= offset[1];
+        z[i] -= offset[2];
+    }
+}
+
+void normalizeScalar(const float* x, const float* y, const float* z, size_t count,
+                     const float* minBounds, const float* dimensions, float* outX, float* outY, float* outZ) {
+    for (size_t i = 0; i < count; i++) {
+        outX[i] = (x[i] - minBounds[0]) / dimensions[0];
+        outY[i] = (y[i] - minBounds[1]) / dimensions[1];
+        outZ[i] = (z[i] - minBounds[2]) / dimensions[2];
+    }
+}
+
+void projectScalar(const float* x, const float* y, const float* z, size_t count,
+                   const float* center, float* outX, float* outY, float* outZ) {
+    for (size_t i = 0; i < count; i++) {
+        // Same operation order as glm::normalize: v * (1 / sqrt((x*x + y*y) + z*z))
+        float dx = x[i] - center[0];
+        float dy = y[i] - center[1];
+        float dz = z[i] - center[2];
+        float lengthSquared = dx * dx + dy * dy;
+        lengthSquared = lengthSquared + dz * dz;
+        float inverseLength = 1.0f / std::sqrt(lengthSquared);
+        outX[i] = dx * inverseLength;
+        outY[i] = dy * inverseLength;
+        outZ[i] = dz * inverseLength;
+    }
+}
+
+void atan2Scalar(const float* y, const float* x, size_t count, float* out) {
+    for (size_t i = 0; i < count; i++) {
+        // Reduce to a ratio in [0, 1], then to [-tan(pi/8), tan(pi/8)]
+        float ax = std::fabs(x[i]);
+        float ay = std::fabs(y[i]);
+        float high = std::max(ax, ay);
+        float low = std::min(ax, ay);
+        float ratio = high > 0.0f ? low / high : 0.0f;
+        bool reduced = ratio > kTanPiOver8;
+        float t = reduced ? (ratio - 1.0f) / (ratio + 1.0f) : ratio;
+        float z = t * t;
+        float polynomial = ((kAtan0 * z + kAtan1) * z + kAtan2) * z + kAtan3;
+        float angle = polynomial * z * t + t;
+        angle = angle + (reduced ? kQuarterPi : 0.0f);
+        // Undo the octant reduction
+        angle = ay > ax ? kHalfPi - angle : angle;
+        angle = x[i] < 0.0f ? kPi - angle : angle;
+        out[i] = std::signbit(y[i]) ? -angle : angle;
+    }
+}
+
+void asinScalar(const float* x, size_t count, float* out) {
+    for (size_t i = 0; i < count; i++) {
+        float a = std::min(std::fabs(x[i]), 1.0f);
+        // asin(a) = pi/2 - 2 asin(sqrt((1 - a) / 2)) keeps the polynomial argument below 0.5
+        bool large = a > 0.5f;
+        float z = large ? 0.5f * (1.0f - a) : a * a;
+        float s = large ? std::sqrt(z) : a;
+        float polynomial = (((kAsin0 * z + kAsin1) * z + kAsin2) * z + kAsin3) * z + kAsin4;
+        float angle = polynomial * z * s + s;
+        angle = large ? kHalfPi - (angle + angle) : angle;
+        out[i] = std::signbit(x[i]) ? -angle : angle;
+    }
+}
+
+const KernelTable kScalarKernels = {
+    boundsScalar, subtractScalar, normalizeScalar, projectScalar, atan2Scalar, asinScalar
+};
+
+#ifdef MESH_KERNELS_X86
+
+// ---- SSE2 -----------------------------------------------------------------
+
+MESH_KERNELS_TARGET_SSE2
+float horizontalMin4(__m128 v) {
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+MESH_KERNELS_TARGET_SSE2
+float horizontalMax4(__m128 v) {
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+MESH_KERNELS_TARGET_SSE2
+void boundsSSE2(const float* x, const float* y, const float* z, size_t count, float* minOut, float* maxOut) {
+    const float* axes[3] = { x, y, z };
+    const size_t vectorCount = count & ~size_t(3);
+    for (int axis = 0; axis < 3; axis++) {
+        const float* values = axes[axis];
+        __m128 low = _mm_set1_ps(minOut[axis]);
+        __m128 high = _mm_set1_ps(maxOut[axis]);
+        for (size_t i = 0; i < vectorCount; i += 4) {
+            __m128 v = _mm_loadu_ps(values + i);
+            low = _mm_min_ps(low, v);
+            high = _mm_max_ps(high, v);
+        }
+        float lowScalar = horizontalMin4(low);
+        float highScalar = horizontalMax4(high);
+        for (size_t i = vectorCount; i < count; i++) {
+            lowScalar = std::min(lowScalar, values[i]);
+            highScalar = std::max(highScalar, values[i]);
+        }
+        minOut[axis] = lowScalar;
+        maxOut[axis] = highScalar;
+    }
+}
+
+MESH_KERNELS_TARGET_SSE2
+void subtractSSE2(float* x, float* y, float* z, size_t count, const float* offset) {
+    const size_t vectorCount = count & ~size_t(3);
+    const __m128 ox = _mm_set1_ps(offset[0]);
+    const __m128 oy = _mm_set1_ps(offset[1]);
+    const __m128 oz = _mm_set1_ps(offset[2]);
+    for (size_t i = 0; i < vectorCount; i += 4) {
+        _mm_storeu_ps(x + i, _mm_sub_ps(_mm_loadu_ps(x + i), ox));
+        _mm_storeu_ps(y + i, _mm_sub_ps(_mm_loadu_ps(y + i), oy));
+        _mm_storeu_ps(z + i, _mm_sub_ps(_mm_loadu_ps(z + i), oz));
+    }
+    subtractScalar(x + vectorCount, y + vectorCount, z + vectorCount, count - vectorCount, offset);
+}
+
+MESH_KERNELS_TARGET_SSE2
+void normalizeSSE2(const float* x, const float* y, const float* z, size_t count,
+                   const float* minBounds, const float* dimensions, float* outX, float* outY, float* outZ) {
+    const size_t vectorCount = count & ~size_t(3);
+    const __m128 mx = _mm_set1_ps(minBounds[0]), my = _mm_set1_ps(minBounds[1]), mz = _mm_set1_ps(minBounds[2]);
+    const __m128 dx = _mm_set1_ps(dimensions[0]), dy = _mm_set1_ps(dimensions[1]), dz = _mm_set1_ps(dimensions[2]);
+    for (size_t i = 0; i < vectorCount; i += 4) {
+        _mm_storeu_ps(outX + i, _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(x + i), mx), dx));
+        _mm_storeu_ps(outY + i, _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(y + i), my), dy));
+        _mm_storeu_ps(outZ + i, _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(z + i), mz), dz));
+    }
+    normalizeScalar(x + vectorCount, y + vectorCount, z + vectorCount, count - vectorCount,
+                    minBounds, dimensions, outX + vectorCount, outY + vectorCount, outZ + vectorCount);
+}
+
+MESH_KERNELS_TARGET_SSE2
+void projectSSE2(const float* x, const float* y, const float* z, size_t count,
+                 const float* center, float* outX, float* outY, float* outZ) {
+    const size_t vectorCount = count & ~size_t(3);
+    const __m128 cx = _mm_set1_ps(center[0]), cy = _mm_set1_ps(center[1]), cz = _mm_set1_ps(center[2]);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (size_t i = 0; i < vectorCount; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), cy);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), cz);
+        __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        __m128 inverseLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+        _mm_storeu_ps(outX + i, _mm_mul_ps(dx, inverseLength));
+        _mm_storeu_ps(outY + i, _mm_mul_ps(dy, inverseLength));
+        _mm_storeu_ps(outZ + i, _mm_mul_ps(dz, inverseLength));
+    }
+    projectScalar(x + vectorCount, y + vectorCount, z + vectorCount, count - vectorCount,
+                  center, outX + vectorCount, outY + vectorCount, outZ + vectorCount);
+}
+
+MESH_KERNELS_TARGET_SSE2
+inline __m128 select4(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+MESH_KERNELS_TARGET_SSE2
+void atan2SSE2(const float* y, const float* x, size_t count, float* out) {
+    const size_t vectorCount = count & ~size_t(3);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (size_t i = 0; i < vectorCount; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 vy = _mm_loadu_ps(y + i);
+        __m128 ax = _mm_andnot_ps(signMask, vx);
+        __m128 ay = _mm_andnot_ps(signMask, vy);
+        __m128 high = _mm_max_ps(ax, ay);
+        __m128 low = _mm_min_ps(ax, ay);
+        __m128 ratio = select4(_mm_cmpgt_ps(high, zero), _mm_div_ps(low, high), zero);
+        __m128 reduced = _mm_cmpgt_ps(ratio, _mm_set1_ps(kTanPiOver8));
+        __m128 t = select4(reduced, _mm_div_ps(_mm_sub_ps(ratio, one), _mm_add_ps(ratio, one)), ratio);
+        __m128 z = _mm_mul_ps(t, t);
+        __m128 polynomial = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kAtan0), z), _mm_set1_ps(kAtan1));
+        polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(kAtan2));
+        polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(kAtan3));
+        __m128 angle = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polynomial, z), t), t);
+        angle = _mm_add_ps(angle, _mm_and_ps(reduced, _mm_set1_ps(kQuarterPi)));
+        angle = select4(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(kHalfPi), angle), angle);
+        angle = select4(_mm_cmplt_ps(vx, zero), _mm_sub_ps(_mm_set1_ps(kPi), angle), angle);
+        _mm_storeu_ps(out + i, _mm_xor_ps(angle, _mm_and_ps(vy, signMask)));
+    }
+    atan2Scalar(y + vectorCount, x + vectorCount, count - vectorCount, out + vectorCount);
+}
+
+MESH_KERNELS_TARGET_SSE2
+void asinSSE2(const float* x, size_t count, float* out) {
+    const size_t vectorCount = count & ~size_t(3);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (size_t i = 0; i < vectorCount; i += 4) {
+        __m128 vx = _mm_loadu_ps(x + i);
+        __m128 a = _mm_min_ps(_mm_andnot_ps(signMask, vx), one);
+        __m128 large = _mm_cmpgt_ps(a, _mm_set1_ps(0.5f));
+        __m128 z = select4(large, _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(one, a)), _mm_mul_ps(a, a));
+        __m128 s = select4(large, _mm_sqrt_ps(z), a);
+        __m128 polynomial = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kAsin0), z), _mm_set1_ps(kAsin1));
+        polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(kAsin2));
+        polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(kAsin3));
+        polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(kAsin4));
+        __m128 angle = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polynomial, z), s), s);
+        angle = select4(large, _mm_sub_ps(_mm_set1_ps(kHalfPi), _mm_add_ps(angle, angle)), angle);
+        _mm_storeu_ps(out + i, _mm_xor_ps(angle, _mm_and_ps(vx, signMask)));
+    }
+    asinScalar(x + vectorCount, count - vectorCount, out + vectorCount);
+}
+
+const KernelTable kSSE2Kernels = {
+    boundsSSE2, subtractSSE2, normalizeSSE2, projectSSE2, atan2SSE2, asinSSE2
+};
+
+// ---- AVX2 -----------------------------------------------------------------
+
+MESH_KERNELS_TARGET_AVX2
+void boundsAVX2(const float* x, const float* y, const float* z, size_t count, float* minOut, float* maxOut) {
+    const float* axes[3] = { x, y, z };
+    const size_t vectorCount = count & ~size_t(7);
+    for (int axis = 0; axis < 3; axis++) {
+        const float* values = axes[axis];
+        __m256 low = _mm256_set1_ps(minOut[axis]);
+        __m256 high = _mm256_set1_ps(maxOut[axis]);
+        for (size_t i = 0; i < vectorCount; i += 8) {
+            __m256 v = _mm256_loadu_ps(values + i);
+            low = _mm256_min_ps(low, v);
+            high = _mm256_max_ps(high, v);
+        }
+        __m128 low4 = _mm_min_ps(_mm256_castps256_ps128(low), _mm256_extractf128_ps(low, 1));
+        __m128 high4 = _mm_max_ps(_mm256_castps256_ps128(high), _mm256_extractf128_ps(high, 1));
+        float lowScalar = horizontalMin4(low4);
+        float highScalar = horizontalMax4(high4);
+        for (size_t i = vectorCount; i < count; i++) {
+            lowScalar = std::min(lowScalar, values[i]);
+            highScalar = std::max(highScalar, values[i]);
+        }
+        minOut[axis] = lowScalar;
+        maxOut[axis] = highScalar;
+    }
+}
+
+MESH_KERNELS_TARGET_AVX2
+void subtractAVX2(float* x, float* y, float* z, size_t count, const float* offset) {
+    const size_t vectorCount = count & ~size_t(7);
+    const __m256 ox = _mm256_set1_ps(offset[0]);
+    const __m256 oy = _mm256_set1_ps(offset[1]);
+    const __m256 oz = _mm256_set1_ps(offset[2]);
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        _mm256_storeu_ps(x + i, _mm256_sub_ps(_mm256_loadu_ps(x + i), ox));
+        _mm256_storeu_ps(y + i, _mm256_sub_ps(_mm256_loadu_ps(y + i), oy));
+        _mm256_storeu_ps(z + i, _mm256_sub_ps(_mm256_loadu_ps(z + i), oz));
+    }
+    subtractScalar(x + vectorCount, y + vectorCount, z + vectorCount, count - vectorCount, offset);
+}
+
+MESH_KERNELS_TARGET_AVX2
+void normalizeAVX2(const float* x, const float* y, const float* z, size_t count,
+                   const float* minBounds, const float* dimensions, float* outX, float* outY, float* outZ) {
+    const size_t vectorCount = count & ~size_t(7);
+    const __m256 mx = _mm256_set1_ps(minBounds[0]), my = _mm256_set1_ps(minBounds[1]), mz = _mm256_set1_ps(minBounds[2]);
+    const __m256 dx = _mm256_set1_ps(dimensions[0]), dy = _mm256_set1_ps(dimensions[1]), dz = _mm256_set1_ps(dimensions[2]);
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        _mm256_storeu_ps(outX + i, _mm256_div_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), mx), dx));
+        _mm256_storeu_ps(outY + i, _mm256_div_ps(_mm256_sub_ps(_mm256_loadu_ps(y + i), my), dy));
+        _mm256_storeu_ps(outZ + i, _mm256_div_ps(_mm256_sub_ps(_mm256_loadu_ps(z + i), mz), dz));
+    }
+    normalizeScalar(x + vectorCount, y + vectorCount, z + vectorCount, count - vectorCount,
+                    minBounds, dimensions, outX + vectorCount, outY + vectorCount, outZ + vectorCount);
+}
+
+MESH_KERNELS_TARGET_AVX2
+void projectAVX2(const float* x, const float* y, const float* z, size_t count,
+                 const float* center, float* outX, float* outY, float* outZ) {
+    const size_t vectorCount = count & ~size_t(7);
+    const __m256 cx = _mm256_set1_ps(center[0]), cy = _mm256_set1_ps(center[1]), cz = _mm256_set1_ps(center[2]);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), cx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), cy);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), cz);
+        // No FMA on purpose: keeps the rounding identical to the scalar path
+        __m256 lengthSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                             _mm256_mul_ps(dz, dz));
+        __m256 inverseLength = _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared));
+        _mm256_storeu_ps(outX + i, _mm256_mul_ps(dx, inverseLength));
+        _mm256_storeu_ps(outY + i, _mm256_mul_ps(dy, inverseLength));
+        _mm256_storeu_ps(outZ + i, _mm256_mul_ps(dz, inverseLength));
+    }
+    projectScalar(x + vectorCount, y + vectorCount, z + vectorCount, count - vectorCount,
+                  center, outX + vectorCount, outY + vectorCount, outZ + vectorCount);
+}
+
+MESH_KERNELS_TARGET_AVX2
+void atan2AVX2(const float* y, const float* x, size_t count, float* out) {
+    const size_t vectorCount = count & ~size_t(7);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 vy = _mm256_loadu_ps(y + i);
+        __m256 ax = _mm256_andnot_ps(signMask, vx);
+        __m256 ay = _mm256_andnot_ps(signMask, vy);
+        __m256 high = _mm256_max_ps(ax, ay);
+        __m256 low = _mm256_min_ps(ax, ay);
+        __m256 ratio = _mm256_blendv_ps(zero, _mm256_div_ps(low, high), _mm256_cmp_ps(high, zero, _CMP_GT_OQ));
+        __m256 reduced = _mm256_cmp_ps(ratio, _mm256_set1_ps(kTanPiOver8), _CMP_GT_OQ);
+        __m256 t = _mm256_blendv_ps(ratio, _mm256_div_ps(_mm256_sub_ps(ratio, one), _mm256_add_ps(ratio, one)), reduced);
+        __m256 z = _mm256_mul_ps(t, t);
+        __m256 polynomial = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kAtan0), z), _mm256_set1_ps(kAtan1));
+        polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, z), _mm256_set1_ps(kAtan2));
+        polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, z), _mm256_set1_ps(kAtan3));
+        __m256 angle = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(polynomial, z), t), t);
+        angle = _mm256_add_ps(angle, _mm256_and_ps(reduced, _mm256_set1_ps(kQuarterPi)));
+        angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(kHalfPi), angle), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+        angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(kPi), angle), _mm256_cmp_ps(vx, zero, _CMP_LT_OQ));
+        _mm256_storeu_ps(out + i, _mm256_xor_ps(angle, _mm256_and_ps(vy, signMask)));
+    }
+    atan2Scalar(y + vectorCount, x + vectorCount, count - vectorCount, out + vectorCount);
+}
+
+MESH_KERNELS_TARGET_AVX2
+void asinAVX2(const float* x, size_t count, float* out) {
+    const size_t vectorCount = count & ~size_t(7);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        __m256 vx = _mm256_loadu_ps(x + i);
+        __m256 a = _mm256_min_ps(_mm256_andnot_ps(signMask, vx), one);
+        __m256 large = _mm256_cmp_ps(a, _mm256_set1_ps(0.5f), _CMP_GT_OQ);
+        __m256 z = _mm256_blendv_ps(_mm256_mul_ps(a, a), _mm256_mul_ps(_mm256_set1_ps(0.5f), _mm256_sub_ps(one, a)), large);
+        __m256 s = _mm256_blendv_ps(a, _mm256_sqrt_ps(z), large);
+        __m256 polynomial = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kAsin0), z), _mm256_set1_ps(kAsin1));
+        polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, z), _mm256_set1_ps(kAsin2));
+        polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, z), _mm256_set1_ps(kAsin3));
+        polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, z), _mm256_set1_ps(kAsin4));
+        __m256 angle = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(polynomial, z), s), s);
+        angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(kHalfPi), _mm256_add_ps(angle, angle)), large);
+        _mm256_storeu_ps(out + i, _mm256_xor_ps(angle, _mm256_and_ps(vx, signMask)));
+    }
+    asinScalar(x + vectorCount, count - vectorCount, out + vectorCount);
+}
+
+const KernelTable kAVX2Kernels = {
+    boundsAVX2, subtractAVX2, normalizeAVX2, projectAVX2, atan2AVX2, asinAVX2
+};
+
+#endif // MESH_KERNELS_X86
+
+/**
+ * Best instruction set of the running CPU.
+ */
+KernelIsa detectIsa() {
+#ifdef MESH_KERNELS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse2 = __builtin_cpu_supports("sse2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) {
+        return KernelIsa::AVX2;
+    }
+    if (sse2) {
+        return KernelIsa::SSE2;
+    }
+#endif
+    return KernelIsa::Scalar;
+}
+
+KernelIsa supportedIsa() {
+    static const KernelIsa isa = detectIsa();
+    return isa;
+}
+
+std::atomic<KernelIsa>& selectedIsa() {
+    static std::atomic<KernelIsa> isa(supportedIsa());
+    return isa;
+}
+
+const KernelTable& kernels() {
+#ifdef MESH_KERNELS_X86
+    switch (selectedIsa().load(std::memory_order_relaxed)) {
+    case KernelIsa::AVX2:
+        return kAVX2Kernels;
+    case KernelIsa::SSE2:
+        return kSSE2Kernels;
+    default:
+        break;
+    }
+#endif
+    return kScalarKernels;
+}
+
+} // namespace
+
+KernelIsa MeshKernels::activeIsa() {
+    return selectedIsa().load(std::memory_order_relaxed);
+}
+
+void MeshKernels::setIsa(KernelIsa isa) {
+    selectedIsa().store(std::min(isa, supportedIsa()), std::memory_order_relaxed);
+}
+
+const char* MeshKernels::isaName(KernelIsa isa) {
+    switch (isa) {
+    case KernelIsa::AVX2:
+        return "avx2";
+    case KernelIsa::SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+void MeshKernels::computeBounds(const PositionArray& positions, glm::vec3& minBounds, glm::vec3& maxBounds) {
+    const size_t count = positions.size();
+    if (count == 0) {
+        minBounds = glm::vec3(0.0f);
+        maxBounds = glm::vec3(0.0f);
+        return;
+    }
+
+    // One partial box per task; min/max are exact, so the merge order does not matter
+    const size_t taskCount = (count + kGrainSize - 1) / kGrainSize;
+    std::vector<glm::vec3> partialMin(taskCount, glm::vec3(std::numeric_limits<float>::max()));
+    std::vector<glm::vec3> partialMax(taskCount, glm::vec3(std::numeric_limits<float>::lowest()));
+    const KernelTable& table = kernels();
+    ThreadPool::global().parallelFor(count, kGrainSize, [&](size_t begin, size_t end) {
+        const size_t task = begin / kGrainSize;
+        float low[3] = { partialMin[task].x, partialMin[task].y, partialMin[task].z };
+        float high[3] = { partialMax[task].x, partialMax[task].y, partialMax[task].z };
+        table.bounds(positions.x.data() + begin, positions.y.data() + begin, positions.z.data() + begin,
+                     end - begin, low, high);
+        partialMin[task] = glm::vec3(low[0], low[1], low[2]);
+        partialMax[task] = glm::vec3(high[0], high[1], high[2]);
+    });
+
+    minBounds = partialMin[0];
+    maxBounds = partialMax[0];
+    for (size_t task = 1; task < taskCount; task++) {
+        minBounds = glm::min(minBounds, partialMin[task]);
+        maxBounds = glm::max(maxBounds, partialMax[task]);
+    }
+}
+
+void MeshKernels::subtract(PositionArray& positions, const glm::vec3& offset) {
+    const float values[3] = { offset.x, offset.y, offset.z };
+    const KernelTable& table = kernels();
+    ThreadPool::global().parallelFor(positions.size(), kGrainSize, [&](size_t begin, size_t end) {
+        table.subtract(positions.x.data() + begin, positions.y.data() + begin, positions.z.data() + begin,
+                       end - begin, values);
+    });
+}
+
+void MeshKernels::normalizeToBox(const PositionArray& positions, size_t first, size_t count,
+                                 const glm::vec3& minBounds, const glm::vec3& dimensions,
+                                 float* outX, float* outY, float* outZ) {
+    const float low[3] = { minBounds.x, minBounds.y, minBounds.z };
+    const float size[3] = { dimensions.x, dimensions.y, dimensions.z };
+    kernels().normalize(positions.x.data() + first, positions.y.data() + first, positions.z.data() + first,
+                        count, low, size, outX, outY, outZ);
+}
+
+void MeshKernels::projectToSphere(const PositionArray& positions, size_t first, size_t count,
+                                  const glm::vec3& center, float* outX, float* outY, float* outZ) {
+    const float origin[3] = { center.x, center.y, center.z };
+    kernels().project(positions.x.data() + first, positions.y.data() + first, positions.z.data() + first,
+                      count, origin, outX, outY, outZ);
+}
+
+void MeshKernels::atan2Approx(const float* y, const float* x, size_t count, float* out) {
+    kernels().atan2(y, x, count, out);
+}
+
+void MeshKernels::asinApprox(const float* x, size_t count, float* out) {
+    kernels().asin(x, count, out);
+}
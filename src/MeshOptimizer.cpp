@@ -0,0 +1,309 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+/**
+ * Vertex attributes as raw bits, so welding compares exactly what would be
+ * uploaded to the GPU.
+ */
+struct VertexKey {
+    uint32_t bits[8];
+
+    bool operator==(const VertexKey& other) const {
+        return std::memcmp(bits, other.bits, sizeof(bits)) == 0;
+    }
+};
+
+VertexKey makeKey(const PositionArray& positions, const std::vector<glm::vec2>& uvs,
+                  const std::vector<glm::vec3>& normals, size_t vertex) {
+    VertexKey key;
+    std::memset(key.bits, 0, sizeof(key.bits));
+    std::memcpy(&key.bits[0], &positions.x[vertex], sizeof(float));
+    std::memcpy(&key.bits[1], &positions.y[vertex], sizeof(float));
+    std::memcpy(&key.bits[2], &positions.z[vertex], sizeof(float));
+    if (vertex < uvs.size()) {
+        std::memcpy(&key.bits[3], &uvs[vertex], sizeof(glm::vec2));
+    }
+    if (vertex < normals.size()) {
+        std::memcpy(&key.bits[5], &normals[vertex], sizeof(glm::vec3));
+    }
+    return key;
+}
+
+uint32_t hashKey(const VertexKey& key) {
+    uint32_t h = 2166136261u;
+    for (uint32_t word : key.bits) {
+        h = (h ^ word) * 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+} // namespace
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                                   unsigned int cacheSize) {
+    VertexCacheStats stats = { 0.0f, 0.0f };
+    if (indices.size() < 3 || vertexCount == 0) {
+        return stats;
+    }
+
+    // FIFO cache: a vertex is resident while fewer than cacheSize misses happened since it was loaded
+    std::vector<size_t> loadedAt(vertexCount, 0);
+    std::vector<char> everLoaded(vertexCount, 0);
+    size_t misses = 0;
+    for (unsigned int index : indices) {
+        if (!everLoaded[index] || misses - loadedAt[index] >= cacheSize) {
+            loadedAt[index] = misses;
+            everLoaded[index] = 1;
+            misses++;
+        }
+    }
+
+    size_t usedVertices = static_cast<size_t>(std::count(everLoaded.begin(), everLoaded.end(), 1));
+    stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    stats.atvr = static_cast<float>(misses) / static_cast<float>(std::max<size_t>(usedVertices, 1));
+    return stats;
+}
+
+size_t MeshOptimizer::buildWeldRemap(const PositionArray& positions,
+                                     const std::vector<glm::vec2>& uvs,
+                                     const std::vector<glm::vec3>& normals,
+                                     std::vector<unsigned int>& remap) {
+    const uint32_t kEmpty = 0xFFFFFFFFu;
+    const size_t vertexCount = positions.size();
+
+    size_t capacity = 16;
+    while (capacity < vertexCount * 2) {
+        capacity <<= 1;
+    }
+    const uint32_t mask = static_cast<uint32_t>(capacity - 1);
+    std::vector<uint32_t> slots(capacity, kEmpty);  // original index of the first vertex with this key
+
+    remap.assign(vertexCount, 0);
+    size_t uniqueCount = 0;
+    for (size_t i = 0; i < vertexCount; i++) {
+        VertexKey key = makeKey(positions, uvs, normals, i);
+        uint32_t slot = hashKey(key) & mask;
+        while (true) {
+            uint32_t first = slots[slot];
+            if (first == kEmpty) {
+                slots[slot] = static_cast<uint32_t>(i);
+                remap[i] = static_cast<unsigned int>(uniqueCount++);
+                break;
+            }
+            if (makeKey(positions, uvs, normals, first) == key) {
+                remap[i] = remap[first];
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+    return uniqueCount;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount,
+                                        unsigned int cacheSize, std::vector<size_t>* clusters) {
+    const size_t triangleCount = indices.size() / 3;
+    if (clusters) {
+        clusters->clear();
+    }
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Vertex -> triangle adjacency in CSR form
+    std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+    for (unsigned int index : indices) {
+        adjacencyOffsets[index + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) {
+        adjacency[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+    }
+
+    std::vector<unsigned int> liveTriangles(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        liveTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+    }
+
+    std::vector<size_t> cacheTime(vertexCount, 0);
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<unsigned int> deadEnd;
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+
+    size_t time = cacheSize + 1;
+    size_t cursor = 0;
+    long long fanning = 0;
+    bool jumped = true;
+
+    // Skip leading vertices that no triangle uses
+    while (cursor < vertexCount && liveTriangles[cursor] == 0) {
+        cursor++;
+    }
+    fanning = cursor < vertexCount ? static_cast<long long>(cursor) : -1;
+
+    while (fanning >= 0) {
+        const unsigned int f = static_cast<unsigned int>(fanning);
+        candidates.clear();
+
+        if (jumped && clusters) {
+            clusters->push_back(output.size() / 3);
+        }
+        jumped = false;
+
+        for (unsigned int a = adjacencyOffsets[f]; a < adjacencyOffsets[f + 1]; a++) {
+            unsigned int triangle = adjacency[a];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = 1;
+            for (int k = 0; k < 3; k++) {
+                unsigned int v = indices[triangle * 3 + k];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if (time - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = time++;
+                }
+            }
+        }
+
+        // Prefer the candidate that will still be cached after emitting its remaining fan
+        long long best = -1;
+        long long bestPriority = -1;
+        for (unsigned int v : candidates) {
+            if (liveTriangles[v] == 0) {
+                continue;
+            }
+            long long priority = 0;
+            if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize) {
+                priority = static_cast<long long>(time - cacheTime[v]);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = v;
+            }
+        }
+
+        if (best < 0) {
+            // Dead end: back up through recently used vertices, then scan forward
+            jumped = true;
+            while (!deadEnd.empty()) {
+                unsigned int v = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveTriangles[v] > 0) {
+                    best = v;
+                    break;
+                }
+            }
+            while (best < 0 && cursor < vertexCount) {
+                if (liveTriangles[cursor] > 0) {
+                    best = static_cast<long long>(cursor);
+                }
+                cursor++;
+            }
+        }
+        fanning = best;
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices, const PositionArray& positions,
+                                     const std::vector<size_t>& clusters) {
+    const size_t triangleCount = indices.size() / 3;
+    if (clusters.size() < 2 || triangleCount == 0) {
+        return;
+    }
+
+    // Area-weighted mesh centroid
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triangleCount; t++) {
+        const glm::vec3 a = positions[indices[t * 3 + 0]];
+        const glm::vec3 b = positions[indices[t * 3 + 1]];
+        const glm::vec3 c = positions[indices[t * 3 + 2]];
+        float area = glm::length(glm::cross(b - a, c - a));
+        meshCentroid += (a + b + c) * (area / 3.0f);
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid /= meshArea;
+    }
+
+    struct ClusterSort {
+        size_t first;
+        size_t last;
+        float occlusionPotential;
+    };
+    std::vector<ClusterSort> order(clusters.size());
+    for (size_t c = 0; c < clusters.size(); c++) {
+        ClusterSort& cluster = order[c];
+        cluster.first = clusters[c];
+        cluster.last = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = cluster.first; t < cluster.last; t++) {
+            const glm::vec3 a = positions[indices[t * 3 + 0]];
+            const glm::vec3 b = positions[indices[t * 3 + 1]];
+            const glm::vec3 p = positions[indices[t * 3 + 2]];
+            glm::vec3 weightedNormal = glm::cross(b - a, p - a);
+            float triangleArea = glm::length(weightedNormal);
+            centroid += (a + b + p) * (triangleArea / 3.0f);
+            normal += weightedNormal;
+            area += triangleArea;
+        }
+        if (area > 0.0f) {
+            centroid /= area;
+        }
+        float normalLength = glm::length(normal);
+        if (normalLength > 0.0f) {
+            normal /= normalLength;
+        }
+        cluster.occlusionPotential = glm::dot(centroid - meshCentroid, normal);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [](const ClusterSort& a, const ClusterSort& b) {
+        return a.occlusionPotential > b.occlusionPotential;
+    });
+
+    std::vector<unsigned int> sorted;
+    sorted.reserve(indices.size());
+    for (const ClusterSort& cluster : order) {
+        sorted.insert(sorted.end(), indices.begin() + cluster.first * 3, indices.begin() + cluster.last * 3);
+    }
+    indices.swap(sorted);
+}
+
+size_t MeshOptimizer::buildFetchRemap(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                      std::vector<unsigned int>& remap) {
+    remap.assign(vertexCount, ~0u);
+    unsigned int next = 0;
+    for (unsigned int index : indices) {
+        if (remap[index] == ~0u) {
+            remap[index] = next++;
+        }
+    }
+    return next;
+}
+
+void MeshOptimizer::remapIndices(std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap) {
+    for (unsigned int& index : indices) {
+        index = remap[index];
+    }
+}
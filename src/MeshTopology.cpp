@@ -0,0 +1,315 @@
+#include "MeshTopology.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+namespace {
+
+// Items per parallel task
+const size_t kGrainSize = 1 << 16;
+
+// The hash passes partition their items into 2^kBucketBits buckets by the top hash bits
+const unsigned int kBucketBits = 8;
+const size_t kBucketCount = size_t(1) << kBucketBits;
+
+const uint32_t kEmpty = 0xFFFFFFFFu;
+
+uint32_t mixHash(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h;
+}
+
+uint32_t floatBits(float value) {
+    // Adding zero folds -0 into +0 so both weld
+    value += 0.0f;
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+uint32_t hashPosition(const PositionArray& positions, size_t i) {
+    return mixHash(floatBits(positions.x[i]) ^ mixHash(floatBits(positions.y[i]) ^ mixHash(floatBits(positions.z[i]))));
+}
+
+bool samePosition(const PositionArray& positions, size_t a, size_t b) {
+    return floatBits(positions.x[a]) == floatBits(positions.x[b]) &&
+           floatBits(positions.y[a]) == floatBits(positions.y[b]) &&
+           floatBits(positions.z[a]) == floatBits(positions.z[b]);
+}
+
+uint32_t hashEdge(int32_t a, int32_t b) {
+    return mixHash(static_cast<uint32_t>(std::min(a, b)) ^ mixHash(static_cast<uint32_t>(std::max(a, b))));
+}
+
+size_t tableCapacity(size_t count) {
+    size_t capacity = 16;
+    while (capacity < count * 2) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/**
+ * Stable parallel partition of [0, count) into buckets by the top bits of
+ * hashOf(i). Buckets keep their items in ascending order, and keys[k]
+ * receives keyOf(items[k]) so the buckets can be resolved without
+ * gathering from the source arrays again.
+ */
+template <typename Hash, typename Key>
+void partitionByHash(size_t count, const Hash& hashOf, const Key& keyOf, std::vector<size_t>& bucketOffsets,
+                     std::vector<uint32_t>& items, std::vector<uint64_t>& keys) {
+    ThreadPool& pool = ThreadPool::global();
+    const size_t chunkCount = (count + kGrainSize - 1) / kGrainSize;
+    std::vector<size_t> cursors(chunkCount * kBucketCount, 0);
+    pool.parallelFor(count, kGrainSize, [&](size_t begin, size_t end) {
+        size_t* counts = &cursors[begin / kGrainSize * kBucketCount];
+        for (size_t i = begin; i < end; i++) {
+            counts[hashOf(i) >> (32 - kBucketBits)]++;
+        }
+    });
+
+    // Bucket-major offsets: every chunk writes its part of a bucket after the earlier chunks
+    bucketOffsets.assign(kBucketCount + 1, 0);
+    size_t running = 0;
+    for (size_t b = 0; b < kBucketCount; b++) {
+        bucketOffsets[b] = running;
+        for (size_t c = 0; c < chunkCount; c++) {
+            const size_t chunkItems = cursors[c * kBucketCount + b];
+            cursors[c * kBucketCount + b] = running;
+            running += chunkItems;
+        }
+    }
+    bucketOffsets[kBucketCount] = running;
+
+    items.resize(count);
+    keys.resize(count);
+    pool.parallelFor(count, kGrainSize, [&](size_t begin, size_t end) {
+        size_t* cursor = &cursors[begin / kGrainSize * kBucketCount];
+        for (size_t i = begin; i < end; i++) {
+            const size_t k = cursor[hashOf(i) >> (32 - kBucketBits)]++;
+            items[k] = static_cast<uint32_t>(i);
+            keys[k] = keyOf(i);
+        }
+    });
+}
+
+/**
+ * Half-edges of one undirected edge, split by direction: forward runs from
+ * the lower to the higher welded vertex.
+ */
+struct EdgeEntry {
+    int32_t low, high;
+    int32_t forward, backward;  ///< Lowest half-edge in each direction
+    uint32_t forwardCount, backwardCount;
+};
+
+/**
+ * Edge counts of one bucket.
+ */
+struct EdgeCounts {
+    size_t edges = 0;
+    size_t border = 0;
+    size_t nonManifold = 0;
+    size_t degenerate = 0;
+};
+
+} // namespace
+
+MeshTopology MeshTopology::build(const PositionArray& positions, const std::vector<unsigned int>& indices) {
+    auto buildStart = std::chrono::high_resolution_clock::now();
+    MeshTopology topology;
+    const size_t vertexTotal = positions.size();
+    const size_t halfEdgeTotal = indices.size() / 3 * 3;
+    if (halfEdgeTotal > static_cast<size_t>(std::numeric_limits<int32_t>::max()) ||
+        vertexTotal > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        return topology;
+    }
+    ThreadPool& pool = ThreadPool::global();
+
+    // Weld: the representative of a position is its lowest vertex
+    std::vector<size_t> bucketOffsets;
+    std::vector<uint32_t> items;
+    std::vector<uint64_t> keys;
+    auto positionHash = [&](size_t i) { return hashPosition(positions, i); };
+    partitionByHash(vertexTotal, positionHash, positionHash, bucketOffsets, items, keys);
+    std::vector<uint32_t> representative(vertexTotal);
+    pool.run(kBucketCount, [&](size_t b) {
+        const size_t first = bucketOffsets[b], count = bucketOffsets[b + 1] - first;
+        const size_t capacity = tableCapacity(count);
+        const uint32_t mask = static_cast<uint32_t>(capacity - 1);
+        std::vector<uint32_t> slots(capacity, kEmpty), slotHashes(capacity);
+        for (size_t k = first; k < first + count; k++) {
+            const uint32_t v = items[k], hash = static_cast<uint32_t>(keys[k]);
+            uint32_t slot = hash & mask;
+            while (slots[slot] != kEmpty && (slotHashes[slot] != hash || !samePosition(positions, slots[slot], v))) {
+                slot = (slot + 1) & mask;
+            }
+            if (slots[slot] == kEmpty) {
+                slots[slot] = v;
+                slotHashes[slot] = hash;
+            }
+            representative[v] = slots[slot];
+        }
+    });
+
+    // Number the representatives in vertex order
+    const size_t chunkCount = (vertexTotal + kGrainSize - 1) / kGrainSize;
+    std::vector<size_t> chunkBase(chunkCount + 1, 0);
+    pool.parallelFor(vertexTotal, kGrainSize, [&](size_t begin, size_t end) {
+        size_t count = 0;
+        for (size_t v = begin; v < end; v++) {
+            count += representative[v] == v ? 1 : 0;
+        }
+        chunkBase[begin / kGrainSize + 1] = count;
+    });
+    for (size_t c = 0; c < chunkCount; c++) {
+        chunkBase[c + 1] += chunkBase[c];
+    }
+    topology.welded.resize(vertexTotal);
+    pool.parallelFor(vertexTotal, kGrainSize, [&](size_t begin, size_t end) {
+        int32_t next = static_cast<int32_t>(chunkBase[begin / kGrainSize]);
+        for (size_t v = begin; v < end; v++) {
+            if (representative[v] == v) {
+                topology.welded[v] = next++;
+            }
+        }
+    });
+    pool.parallelFor(vertexTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            topology.welded[v] = topology.welded[representative[v]];
+        }
+    });
+    representative = std::vector<uint32_t>();
+    const size_t weldedTotal = chunkBase[chunkCount];
+
+    topology.origins.resize(halfEdgeTotal);
+    pool.parallelFor(halfEdgeTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t h = begin; h < end; h++) {
+            topology.origins[h] = topology.welded[indices[h]];
+        }
+    });
+
+    // Pair the half-edges: both directions of an edge hash to the same bucket
+    auto edgeHash = [&](size_t h) {
+        return hashEdge(topology.origins[h], topology.origins[next(static_cast<int32_t>(h))]);
+    };
+    auto edgeKey = [&](size_t h) {
+        return static_cast<uint64_t>(topology.origins[h]) << 32 |
+               static_cast<uint32_t>(topology.origins[next(static_cast<int32_t>(h))]);
+    };
+    partitionByHash(halfEdgeTotal, edgeHash, edgeKey, bucketOffsets, items, keys);
+    topology.twins.resize(halfEdgeTotal);
+    std::vector<EdgeCounts> bucketCounts(kBucketCount);
+    pool.run(kBucketCount, [&](size_t b) {
+        const size_t first = bucketOffsets[b], count = bucketOffsets[b + 1] - first;
+        const size_t capacity = tableCapacity(count / 2 + 1);
+        const uint32_t mask = static_cast<uint32_t>(capacity - 1);
+        std::vector<uint32_t> slots(capacity, kEmpty);
+        std::vector<EdgeEntry> entries;
+        entries.reserve(count / 2 + 1);
+        std::vector<uint32_t> entryOf(count, kEmpty);
+        EdgeCounts& counts = bucketCounts[b];
+
+        for (size_t k = first; k < first + count; k++) {
+            const int32_t h = static_cast<int32_t>(items[k]);
+            const int32_t a = static_cast<int32_t>(keys[k] >> 32), z = static_cast<int32_t>(keys[k] & 0xFFFFFFFFu);
+            if (a == z) {
+                counts.degenerate++;
+                continue;
+            }
+            const int32_t low = std::min(a, z), high = std::max(a, z);
+            uint32_t slot = hashEdge(a, z) & mask;
+            while (slots[slot] != kEmpty && (entries[slots[slot]].low != low || entries[slots[slot]].high != high)) {
+                slot = (slot + 1) & mask;
+            }
+            if (slots[slot] == kEmpty) {
+                slots[slot] = static_cast<uint32_t>(entries.size());
+                entries.push_back(EdgeEntry{ low, high, kBorder, kBorder, 0, 0 });
+            }
+            EdgeEntry& entry = entries[slots[slot]];
+            if (a == low) {
+                entry.forward = entry.forwardCount++ == 0 ? h : entry.forward;
+            } else {
+                entry.backward = entry.backwardCount++ == 0 ? h : entry.backward;
+            }
+            entryOf[k - first] = slots[slot];
+        }
+
+        // A manifold edge has exactly one half-edge in each direction
+        for (size_t k = first; k < first + count; k++) {
+            const int32_t h = static_cast<int32_t>(items[k]);
+            if (entryOf[k - first] == kEmpty) {
+                topology.twins[h] = kNonManifold;
+                continue;
+            }
+            const EdgeEntry& entry = entries[entryOf[k - first]];
+            if (entry.forwardCount > 1 || entry.backwardCount > 1) {
+                topology.twins[h] = kNonManifold;
+            } else {
+                topology.twins[h] = static_cast<int32_t>(keys[k] >> 32) == entry.low ? entry.backward : entry.forward;
+            }
+        }
+        counts.edges = entries.size();
+        for (const EdgeEntry& entry : entries) {
+            if (entry.forwardCount > 1 || entry.backwardCount > 1) {
+                counts.nonManifold++;
+            } else if (entry.forwardCount + entry.backwardCount == 1) {
+                counts.border++;
+            }
+        }
+    });
+    items = std::vector<uint32_t>();
+    keys = std::vector<uint64_t>();
+
+    // Lowest outgoing half-edge of every vertex, border half-edges first
+    std::unique_ptr<std::atomic<uint32_t>[]> lowest(new std::atomic<uint32_t>[weldedTotal]);
+    pool.parallelFor(weldedTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            lowest[v].store(kEmpty, std::memory_order_relaxed);
+        }
+    });
+    pool.parallelFor(halfEdgeTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t h = begin; h < end; h++) {
+            const uint32_t key = static_cast<uint32_t>(h) | (topology.twins[h] == kBorder ? 0u : 0x80000000u);
+            std::atomic<uint32_t>& slot = lowest[topology.origins[h]];
+            uint32_t current = slot.load(std::memory_order_relaxed);
+            while (key < current && !slot.compare_exchange_weak(current, key, std::memory_order_relaxed)) {
+            }
+        }
+    });
+    topology.outgoing.resize(weldedTotal);
+    pool.parallelFor(weldedTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            const uint32_t key = lowest[v].load(std::memory_order_relaxed);
+            topology.outgoing[v] = key == kEmpty ? -1 : static_cast<int32_t>(key & 0x7FFFFFFFu);
+        }
+    });
+
+    TopologyStats& stats = topology.statistics;
+    stats.weldedVertices = weldedTotal;
+    for (const EdgeCounts& counts : bucketCounts) {
+        stats.edges += counts.edges;
+        stats.borderEdges += counts.border;
+        stats.nonManifoldEdges += counts.nonManifold;
+        stats.degenerateEdges += counts.degenerate;
+    }
+    stats.buildMs =
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - buildStart).count();
+    return topology;
+}
+
+void MeshTopology::clear() {
+    std::vector<int32_t>().swap(twins);
+    std::vector<int32_t>().swap(origins);
+    std::vector<int32_t>().swap(welded);
+    std::vector<int32_t>().swap(outgoing);
+    statistics = TopologyStats();
+}
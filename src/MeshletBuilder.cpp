@@ -0,0 +1,209 @@
+#include "MeshletBuilder.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// Triangles per scan block, and meshlets per bounds task
+const size_t kGrainSize = 1 << 16;
+
+// Vertex set of the open meshlet: open addressing over twice the largest vertex limit
+const size_t kSlotCount = 512;
+
+// Cones whose normals reach further than ~84 degrees from the axis never cull anything useful
+const float kMinConeDot = 0.1f;
+
+// Cutoff that no normalized dot product reaches
+const float kNoCone = 2.0f;
+
+/**
+ * Distinct vertices of the meshlet being filled. Slots are stamped with the
+ * meshlet they belong to, so starting a meshlet does not clear the table.
+ */
+class VertexSet {
+public:
+    VertexSet() : vertices(kSlotCount, 0), stamps(kSlotCount, 0), stamp(1) {}
+
+    void reset() { stamp++; }
+
+    bool contains(unsigned int vertex) const { return stamps[find(vertex)] == stamp; }
+
+    void insert(unsigned int vertex) {
+        const size_t slot = find(vertex);
+        vertices[slot] = vertex;
+        stamps[slot] = stamp;
+    }
+
+private:
+    size_t find(unsigned int vertex) const {
+        size_t slot = (vertex * 2654435761u) & (kSlotCount - 1);
+        while (stamps[slot] == stamp && vertices[slot] != vertex) {
+            slot = (slot + 1) & (kSlotCount - 1);
+        }
+        return slot;
+    }
+
+    std::vector<unsigned int> vertices;
+    std::vector<uint32_t> stamps;
+    uint32_t stamp;
+};
+
+} // namespace
+
+MeshletReport MeshletBuilder::build(const PositionArray& positions, const std::vector<unsigned int>& indices,
+                                    std::vector<Meshlet>& meshlets, const MeshletOptions& options) {
+    auto buildStart = std::chrono::high_resolution_clock::now();
+    MeshletReport report;
+    ThreadPool& pool = ThreadPool::global();
+    meshlets.clear();
+    const size_t triangleTotal = indices.size() / 3;
+    const uint32_t maxVertices = std::max(3u, std::min(options.maxVertices, static_cast<unsigned int>(kSlotCount / 2)));
+    const uint32_t maxTriangles = std::max(1u, options.maxTriangles);
+    if (triangleTotal == 0) {
+        return report;
+    }
+
+    // Cut every block into runs that stay within the limits
+    const size_t blockCount = (triangleTotal + kGrainSize - 1) / kGrainSize;
+    std::vector<std::vector<Meshlet>> blockMeshlets(blockCount);
+    pool.parallelFor(triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+        std::vector<Meshlet>& local = blockMeshlets[begin / kGrainSize];
+        VertexSet vertexSet;
+        Meshlet current = Meshlet();
+        current.firstIndex = static_cast<uint32_t>(3 * begin);
+        for (size_t t = begin; t < end; t++) {
+            const unsigned int a = indices[3 * t], b = indices[3 * t + 1], c = indices[3 * t + 2];
+            const uint32_t added = (vertexSet.contains(a) ? 0 : 1) + (b != a && !vertexSet.contains(b) ? 1 : 0) +
+                                   (c != a && c != b && !vertexSet.contains(c) ? 1 : 0);
+            if (current.triangleCount == maxTriangles || current.vertexCount + added > maxVertices) {
+                local.push_back(current);
+                current = Meshlet();
+                current.firstIndex = static_cast<uint32_t>(3 * t);
+                vertexSet.reset();
+                current.vertexCount = 1 + (b != a ? 1 : 0) + (c != a && c != b ? 1 : 0);
+            } else {
+                current.vertexCount += added;
+            }
+            vertexSet.insert(a);
+            vertexSet.insert(b);
+            vertexSet.insert(c);
+            current.triangleCount++;
+        }
+        local.push_back(current);
+    });
+
+    size_t meshletTotal = 0;
+    for (const std::vector<Meshlet>& local : blockMeshlets) {
+        meshletTotal += local.size();
+    }
+    meshlets.reserve(meshletTotal);
+    for (std::vector<Meshlet>& local : blockMeshlets) {
+        meshlets.insert(meshlets.end(), local.begin(), local.end());
+        std::vector<Meshlet>().swap(local);
+    }
+
+    pool.parallelFor(meshlets.size(), kGrainSize / 64, [&](size_t begin, size_t end) {
+        for (size_t m = begin; m < end; m++) {
+            computeBounds(positions, indices, meshlets[m]);
+        }
+    });
+
+    size_t vertexSum = 0;
+    for (const Meshlet& meshlet : meshlets) {
+        vertexSum += meshlet.vertexCount;
+        report.cullableCones += meshlet.coneCutoff <= 1.0f ? 1 : 0;
+    }
+    report.meshlets = meshlets.size();
+    report.averageTriangles = static_cast<double>(triangleTotal) / static_cast<double>(report.meshlets);
+    report.averageVertices = static_cast<double>(vertexSum) / static_cast<double>(report.meshlets);
+    report.buildMs =
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - buildStart).count();
+    return report;
+}
+
+void MeshletBuilder::computeBounds(const PositionArray& positions, const std::vector<unsigned int>& indices,
+                                   Meshlet& meshlet) {
+    const unsigned int* corners = indices.data() + meshlet.firstIndex;
+    const size_t cornerCount = 3 * static_cast<size_t>(meshlet.triangleCount);
+
+    // Ritter's sphere: start from the most distant pair of axis extremes, then grow over the outliers
+    size_t extremes[6] = { 0, 0, 0, 0, 0, 0 };
+    for (size_t k = 1; k < cornerCount; k++) {
+        const glm::vec3 p = positions[corners[k]];
+        for (int axis = 0; axis < 3; axis++) {
+            if (p[axis] < positions[corners[extremes[2 * axis]]][axis]) {
+                extremes[2 * axis] = k;
+            }
+            if (p[axis] > positions[corners[extremes[2 * axis + 1]]][axis]) {
+                extremes[2 * axis + 1] = k;
+            }
+        }
+    }
+    glm::vec3 low = positions[corners[extremes[0]]], high = positions[corners[extremes[1]]];
+    for (int axis = 1; axis < 3; axis++) {
+        const glm::vec3 axisLow = positions[corners[extremes[2 * axis]]];
+        const glm::vec3 axisHigh = positions[corners[extremes[2 * axis + 1]]];
+        if (glm::dot(axisHigh - axisLow, axisHigh - axisLow) > glm::dot(high - low, high - low)) {
+            low = axisLow;
+            high = axisHigh;
+        }
+    }
+    glm::vec3 center = (low + high) * 0.5f;
+    float radius = glm::length(high - low) * 0.5f;
+    for (size_t k = 0; k < cornerCount; k++) {
+        const glm::vec3 p = positions[corners[k]];
+        const float distance = glm::length(p - center);
+        if (distance > radius) {
+            const float grown = (radius + distance) * 0.5f;
+            center += (p - center) * ((grown - radius) / distance);
+            radius = grown;
+        }
+    }
+    meshlet.center = center;
+    meshlet.radius = radius;
+
+    // Normal cone: mean facing as the axis, the widest normal as the spread
+    glm::vec3 axisSum(0.0f);
+    for (size_t k = 0; k < cornerCount; k += 3) {
+        const glm::vec3 p0 = positions[corners[k]];
+        const glm::vec3 normal = glm::cross(positions[corners[k + 1]] - p0, positions[corners[k + 2]] - p0);
+        const float length = glm::length(normal);
+        if (length > 0.0f && std::isfinite(length)) {
+            axisSum += normal / length;
+        }
+    }
+    meshlet.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    meshlet.coneApex = center;
+    meshlet.coneCutoff = kNoCone;
+    const float axisLength = glm::length(axisSum);
+    if (!(axisLength > 0.0f) || !std::isfinite(axisLength)) {
+        return;
+    }
+    const glm::vec3 axis = axisSum / axisLength;
+    meshlet.coneAxis = axis;
+
+    float minDot = 1.0f;
+    float maxDistance = 0.0f;
+    for (size_t k = 0; k < cornerCount; k += 3) {
+        const glm::vec3 p0 = positions[corners[k]];
+        const glm::vec3 normal = glm::cross(positions[corners[k + 1]] - p0, positions[corners[k + 2]] - p0);
+        const float length = glm::length(normal);
+        if (!(length > 0.0f) || !std::isfinite(length)) {
+            continue;
+        }
+        const glm::vec3 unit = normal / length;
+        const float facing = glm::dot(axis, unit);
+        minDot = std::min(minDot, facing);
+        if (facing > kMinConeDot) {
+            // Distance along -axis that puts the apex behind this triangle's plane
+            maxDistance = std::max(maxDistance, glm::dot(center - p0, unit) / facing);
+        }
+    }
+    if (minDot <= kMinConeDot) {
+        return;
+    }
+    meshlet.coneApex = center - axis * maxDistance;
+    meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
@@ -0,0 +1,629 @@
+#include "Multigrid.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+namespace {
+
+// Rows or vector elements per parallel task
+const size_t kGrainSize = 1 << 12;
+
+// Rows per task of the matrix products, which allocate a dense accumulator per task
+const size_t kProductGrain = 1 << 14;
+
+// Operators up to this size are factored densely
+const size_t kCoarsestSize = 512;
+
+// Coarsest operators above this size (coarsening stalled) are smoothed instead
+const size_t kDenseLimit = 2048;
+
+// Jacobi sweeps replacing the dense solve on a stalled coarsest level
+const int kCoarseSweeps = 10;
+
+const size_t kMaxLevels = 16;
+
+// Strength of connection threshold for aggregation
+const double kStrengthThreshold = 0.08;
+
+/**
+ * Builds a CSR matrix row by row in parallel. emitRange(begin, end, columns,
+ * values) appends rows [begin, end) to task-local buffers and sets
+ * result.rowOffsets[row + 1] to the buffer size after every row; the
+ * buffers are then concatenated in task order.
+ */
+template <typename EmitRange>
+void buildRows(SparseMatrix& result, size_t grain, EmitRange emitRange) {
+    const size_t rows = result.rows;
+    const size_t taskCount = (rows + grain - 1) / grain;
+    std::vector<std::vector<uint32_t>> taskColumns(taskCount);
+    std::vector<std::vector<double>> taskValues(taskCount);
+    result.rowOffsets.assign(rows + 1, 0);
+    ThreadPool::global().parallelFor(rows, grain, [&](size_t begin, size_t end) {
+        emitRange(begin, end, taskColumns[begin / grain], taskValues[begin / grain]);
+    });
+
+    std::vector<size_t> taskBase(taskCount + 1, 0);
+    for (size_t task = 0; task < taskCount; task++) {
+        taskBase[task + 1] = taskBase[task] + taskColumns[task].size();
+    }
+    result.columnIndices.resize(taskBase[taskCount]);
+    result.values.resize(taskBase[taskCount]);
+    ThreadPool::global().parallelFor(rows, grain, [&](size_t begin, size_t end) {
+        const size_t task = begin / grain;
+        for (size_t row = begin; row < end; row++) {
+            result.rowOffsets[row + 1] += taskBase[task];
+        }
+        std::copy(taskColumns[task].begin(), taskColumns[task].end(), result.columnIndices.begin() + taskBase[task]);
+        std::copy(taskValues[task].begin(), taskValues[task].end(), result.values.begin() + taskBase[task]);
+        std::vector<uint32_t>().swap(taskColumns[task]);
+        std::vector<double>().swap(taskValues[task]);
+    });
+}
+
+/**
+ * C = A * B with a dense accumulator per task; entries of a row are summed
+ * in the order of A's row, so the result does not depend on the thread count.
+ */
+SparseMatrix product(const SparseMatrix& a, const SparseMatrix& b) {
+    SparseMatrix result;
+    result.rows = a.rows;
+    result.columns = b.columns;
+    buildRows(result, kProductGrain, [&](size_t begin, size_t end, std::vector<uint32_t>& columns,
+                                         std::vector<double>& values) {
+        std::vector<double> accumulator(b.columns, 0.0);
+        std::vector<char> used(b.columns, 0);
+        std::vector<uint32_t> touched;
+        for (size_t row = begin; row < end; row++) {
+            touched.clear();
+            for (size_t k = a.rowOffsets[row]; k < a.rowOffsets[row + 1]; k++) {
+                const double scale = a.values[k];
+                const uint32_t inner = a.columnIndices[k];
+                for (size_t m = b.rowOffsets[inner]; m < b.rowOffsets[inner + 1]; m++) {
+                    const uint32_t column = b.columnIndices[m];
+                    if (!used[column]) {
+                        used[column] = 1;
+                        touched.push_back(column);
+                    }
+                    accumulator[column] += scale * b.values[m];
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            for (uint32_t column : touched) {
+                columns.push_back(column);
+                values.push_back(accumulator[column]);
+                accumulator[column] = 0.0;
+                used[column] = 0;
+            }
+            result.rowOffsets[row + 1] = columns.size();
+        }
+    });
+    return result;
+}
+
+SparseMatrix transpose(const SparseMatrix& a) {
+    SparseMatrix result;
+    result.rows = a.columns;
+    result.columns = a.rows;
+    result.rowOffsets.assign(a.columns + 1, 0);
+    for (uint32_t column : a.columnIndices) {
+        result.rowOffsets[column + 1]++;
+    }
+    for (size_t row = 0; row < result.rows; row++) {
+        result.rowOffsets[row + 1] += result.rowOffsets[row];
+    }
+    result.columnIndices.resize(a.nonZeros());
+    result.values.resize(a.nonZeros());
+    std::vector<size_t> cursor(result.rowOffsets.begin(), result.rowOffsets.end() - 1);
+    for (size_t row = 0; row < a.rows; row++) {
+        for (size_t k = a.rowOffsets[row]; k < a.rowOffsets[row + 1]; k++) {
+            const size_t slot = cursor[a.columnIndices[k]]++;
+            result.columnIndices[slot] = static_cast<uint32_t>(row);
+            result.values[slot] = a.values[k];
+        }
+    }
+    return result;
+}
+
+double dot(const double* a, const double* b, size_t count) {
+    const size_t taskCount = (count + kGrainSize - 1) / kGrainSize;
+    std::vector<double> partials(taskCount, 0.0);
+    ThreadPool::global().parallelFor(count, kGrainSize, [&](size_t begin, size_t end) {
+        double sum = 0.0;
+        for (size_t i = begin; i < end; i++) {
+            sum += a[i] * b[i];
+        }
+        partials[begin / kGrainSize] = sum;
+    });
+    double sum = 0.0;
+    for (double partial : partials) {
+        sum += partial;
+    }
+    return sum;
+}
+
+/**
+ * r = b - A x
+ */
+void computeResidual(const SparseMatrix& matrix, const double* x, const double* b, double* r) {
+    ThreadPool::global().parallelFor(matrix.rows, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++) {
+            double sum = b[row];
+            for (size_t k = matrix.rowOffsets[row]; k < matrix.rowOffsets[row + 1]; k++) {
+                sum -= matrix.values[k] * x[matrix.columnIndices[k]];
+            }
+            r[row] = sum;
+        }
+    });
+}
+
+/**
+ * Largest eigenvalue of D^-1 A by power iteration from a fixed start vector.
+ */
+double estimateSpectralRadius(const SparseMatrix& matrix, const std::vector<double>& inverseDiagonal) {
+    const size_t n = matrix.rows;
+    std::vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = 0.5 + static_cast<double>((i * 2654435761u) & 1023) / 1023.0;
+    }
+    double radius = 1.0;
+    for (int iteration = 0; iteration < 12; iteration++) {
+        matrix.multiply(x.data(), y.data());
+        ThreadPool::global().parallelFor(n, kGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                y[i] *= inverseDiagonal[i];
+            }
+        });
+        const double xNorm = std::sqrt(dot(x.data(), x.data(), n));
+        const double yNorm = std::sqrt(dot(y.data(), y.data(), n));
+        if (!(yNorm > 0.0) || !(xNorm > 0.0)) {
+            break;
+        }
+        radius = yNorm / xNorm;
+        const double scale = 1.0 / yNorm;
+        ThreadPool::global().parallelFor(n, kGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                x[i] = y[i] * scale;
+            }
+        });
+    }
+    return radius;
+}
+
+/**
+ * Greedy three-phase aggregation on the strong node couplings: seed
+ * aggregates from nodes whose strong neighborhood is still free, attach the
+ * remaining nodes to a neighboring aggregate, then group leftovers. Nodes
+ * without strong couplings (e.g. identity rows) stay unaggregated (-1).
+ */
+size_t aggregateNodes(const SparseMatrix& matrix, unsigned int blockSize, std::vector<int>& aggregateOf) {
+    const size_t nodeCount = matrix.rows / blockSize;
+
+    // Frobenius norm of every diagonal block
+    std::vector<double> diagonalNorm(nodeCount, 0.0);
+    ThreadPool::global().parallelFor(nodeCount, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t node = begin; node < end; node++) {
+            double sum = 0.0;
+            for (size_t row = node * blockSize; row < (node + 1) * blockSize; row++) {
+                for (size_t k = matrix.rowOffsets[row]; k < matrix.rowOffsets[row + 1]; k++) {
+                    if (matrix.columnIndices[k] / blockSize == node) {
+                        sum += matrix.values[k] * matrix.values[k];
+                    }
+                }
+            }
+            diagonalNorm[node] = std::sqrt(sum);
+        }
+    });
+
+    // Strong neighbors: |A_ij| >= threshold * sqrt(|A_ii| |A_jj|) with block Frobenius norms
+    SparseMatrix strength;
+    strength.rows = nodeCount;
+    strength.columns = nodeCount;
+    buildRows(strength, kGrainSize, [&](size_t begin, size_t end, std::vector<uint32_t>& columns,
+                                        std::vector<double>& values) {
+        std::vector<std::pair<uint32_t, double>> blocks;
+        for (size_t node = begin; node < end; node++) {
+            blocks.clear();
+            for (size_t row = node * blockSize; row < (node + 1) * blockSize; row++) {
+                for (size_t k = matrix.rowOffsets[row]; k < matrix.rowOffsets[row + 1]; k++) {
+                    blocks.emplace_back(matrix.columnIndices[k] / blockSize, matrix.values[k] * matrix.values[k]);
+                }
+            }
+            std::stable_sort(blocks.begin(), blocks.end(),
+                             [](const std::pair<uint32_t, double>& a, const std::pair<uint32_t, double>& b) {
+                                 return a.first < b.first;
+                             });
+            for (size_t k = 0; k < blocks.size();) {
+                const uint32_t other = blocks[k].first;
+                double sum = 0.0;
+                for (; k < blocks.size() && blocks[k].first == other; k++) {
+                    sum += blocks[k].second;
+                }
+                const double threshold = kStrengthThreshold * std::sqrt(diagonalNorm[node] * diagonalNorm[other]);
+                if (other != node && sum > 0.0 && std::sqrt(sum) >= threshold) {
+                    columns.push_back(other);
+                    values.push_back(1.0);
+                }
+            }
+            strength.rowOffsets[node + 1] = columns.size();
+        }
+    });
+
+    aggregateOf.assign(nodeCount, -1);
+    int aggregateCount = 0;
+    auto strongBegin = [&](size_t node) { return strength.columnIndices.begin() + strength.rowOffsets[node]; };
+    auto strongEnd = [&](size_t node) { return strength.columnIndices.begin() + strength.rowOffsets[node + 1]; };
+
+    for (size_t node = 0; node < nodeCount; node++) {
+        if (aggregateOf[node] >= 0 || strongBegin(node) == strongEnd(node)) {
+            continue;
+        }
+        bool free = std::all_of(strongBegin(node), strongEnd(node), [&](uint32_t other) { return aggregateOf[other] < 0; });
+        if (free) {
+            aggregateOf[node] = aggregateCount;
+            for (auto it = strongBegin(node); it != strongEnd(node); ++it) {
+                aggregateOf[*it] = aggregateCount;
+            }
+            aggregateCount++;
+        }
+    }
+    for (size_t node = 0; node < nodeCount; node++) {
+        if (aggregateOf[node] >= 0) {
+            continue;
+        }
+        for (auto it = strongBegin(node); it != strongEnd(node); ++it) {
+            if (aggregateOf[*it] >= 0) {
+                aggregateOf[node] = aggregateOf[*it];
+                break;
+            }
+        }
+    }
+    for (size_t node = 0; node < nodeCount; node++) {
+        if (aggregateOf[node] >= 0 || strongBegin(node) == strongEnd(node)) {
+            continue;
+        }
+        aggregateOf[node] = aggregateCount;
+        for (auto it = strongBegin(node); it != strongEnd(node); ++it) {
+            if (aggregateOf[*it] < 0) {
+                aggregateOf[*it] = aggregateCount;
+            }
+        }
+        aggregateCount++;
+    }
+    return static_cast<size_t>(aggregateCount);
+}
+
+/**
+ * Tentative prolongator: on every aggregate the near-null vectors are
+ * orthonormalized (modified Gram-Schmidt) and the result becomes the
+ * aggregate's block of P0, so P0 reproduces them exactly. The R factors are
+ * the near-null vectors of the coarse level. Rank-deficient columns (e.g.
+ * rotations on a single-node aggregate) become zero columns.
+ */
+SparseMatrix tentativeProlongation(size_t rows, const std::vector<double>& nullSpace, size_t vectorCount,
+                                   const std::vector<int>& aggregateOf, size_t aggregateCount, unsigned int blockSize,
+                                   std::vector<double>& coarseNullSpace) {
+    const size_t m = vectorCount;
+
+    // Rows of every aggregate, in row order
+    std::vector<size_t> aggregateOffsets(aggregateCount + 1, 0);
+    for (int aggregate : aggregateOf) {
+        if (aggregate >= 0) {
+            aggregateOffsets[aggregate + 1] += blockSize;
+        }
+    }
+    for (size_t a = 0; a < aggregateCount; a++) {
+        aggregateOffsets[a + 1] += aggregateOffsets[a];
+    }
+    std::vector<uint32_t> aggregateRows(aggregateOffsets[aggregateCount]);
+    {
+        std::vector<size_t> cursor(aggregateOffsets.begin(), aggregateOffsets.end() - 1);
+        for (size_t row = 0; row < rows; row++) {
+            const int aggregate = aggregateOf[row / blockSize];
+            if (aggregate >= 0) {
+                aggregateRows[cursor[aggregate]++] = static_cast<uint32_t>(row);
+            }
+        }
+    }
+
+    SparseMatrix result;
+    result.rows = rows;
+    result.columns = aggregateCount * m;
+    result.rowOffsets.assign(rows + 1, 0);
+    for (size_t row = 0; row < rows; row++) {
+        result.rowOffsets[row + 1] = result.rowOffsets[row] + (aggregateOf[row / blockSize] >= 0 ? m : 0);
+    }
+    result.columnIndices.resize(result.rowOffsets[rows]);
+    result.values.assign(result.rowOffsets[rows], 0.0);
+    coarseNullSpace.assign(aggregateCount * m * m, 0.0);
+
+    ThreadPool::global().parallelFor(aggregateCount, kGrainSize, [&](size_t begin, size_t end) {
+        std::vector<double> q;
+        for (size_t a = begin; a < end; a++) {
+            const size_t first = aggregateOffsets[a];
+            const size_t count = aggregateOffsets[a + 1] - first;
+            q.resize(count * m);
+            for (size_t i = 0; i < count; i++) {
+                for (size_t j = 0; j < m; j++) {
+                    q[i * m + j] = nullSpace[aggregateRows[first + i] * m + j];
+                }
+            }
+            double* r = &coarseNullSpace[a * m * m];
+            for (size_t j = 0; j < m; j++) {
+                double original = 0.0;
+                for (size_t i = 0; i < count; i++) {
+                    original += q[i * m + j] * q[i * m + j];
+                }
+                for (size_t k = 0; k < j; k++) {
+                    double projection = 0.0;
+                    for (size_t i = 0; i < count; i++) {
+                        projection += q[i * m + k] * q[i * m + j];
+                    }
+                    r[k * m + j] = projection;
+                    for (size_t i = 0; i < count; i++) {
+                        q[i * m + j] -= projection * q[i * m + k];
+                    }
+                }
+                double norm = 0.0;
+                for (size_t i = 0; i < count; i++) {
+                    norm += q[i * m + j] * q[i * m + j];
+                }
+                norm = std::sqrt(norm);
+                const bool independent = norm > 1e-10 * std::sqrt(original);
+                r[j * m + j] = independent ? norm : 0.0;
+                for (size_t i = 0; i < count; i++) {
+                    q[i * m + j] = independent ? q[i * m + j] / norm : 0.0;
+                }
+            }
+            for (size_t i = 0; i < count; i++) {
+                const size_t offset = result.rowOffsets[aggregateRows[first + i]];
+                for (size_t j = 0; j < m; j++) {
+                    result.columnIndices[offset + j] = static_cast<uint32_t>(a * m + j);
+                    result.values[offset + j] = q[i * m + j];
+                }
+            }
+        }
+    });
+    return result;
+}
+
+/**
+ * P = P0 - omega D^-1 (A P0)
+ */
+SparseMatrix smoothProlongation(const SparseMatrix& matrix, const std::vector<double>& inverseDiagonal, double omega,
+                                const SparseMatrix& tentative) {
+    const SparseMatrix product0 = product(matrix, tentative);
+    SparseMatrix result;
+    result.rows = tentative.rows;
+    result.columns = tentative.columns;
+    buildRows(result, kGrainSize, [&](size_t begin, size_t end, std::vector<uint32_t>& columns,
+                                      std::vector<double>& values) {
+        for (size_t row = begin; row < end; row++) {
+            const double scale = omega * inverseDiagonal[row];
+            size_t a = tentative.rowOffsets[row], b = product0.rowOffsets[row];
+            const size_t aEnd = tentative.rowOffsets[row + 1], bEnd = product0.rowOffsets[row + 1];
+            while (a < aEnd || b < bEnd) {
+                const uint32_t aColumn = a < aEnd ? tentative.columnIndices[a] : UINT32_MAX;
+                const uint32_t bColumn = b < bEnd ? product0.columnIndices[b] : UINT32_MAX;
+                const uint32_t column = std::min(aColumn, bColumn);
+                double value = 0.0;
+                if (aColumn == column) {
+                    value += tentative.values[a++];
+                }
+                if (bColumn == column) {
+                    value -= scale * product0.values[b++];
+                }
+                columns.push_back(column);
+                values.push_back(value);
+            }
+            result.rowOffsets[row + 1] = columns.size();
+        }
+    });
+    return result;
+}
+
+} // namespace
+
+void MultigridPreconditioner::build(const SparseMatrix& matrix, unsigned int blockSize,
+                                    const std::vector<double>& nearNullSpace) {
+    fineMatrix = &matrix;
+    levels.clear();
+    levels.emplace_back();
+    blockSize = std::max(1u, blockSize);
+
+    // Near-null space of the current level, row-major
+    size_t vectorCount = matrix.rows > 0 ? nearNullSpace.size() / matrix.rows : 0;
+    std::vector<double> nullSpace = nearNullSpace;
+    if (vectorCount == 0) {
+        vectorCount = blockSize;
+        nullSpace.assign(matrix.rows * vectorCount, 0.0);
+        for (size_t row = 0; row < matrix.rows; row++) {
+            nullSpace[row * vectorCount + row % blockSize] = 1.0;
+        }
+    }
+
+    while (true) {
+        const size_t level = levels.size() - 1;
+        const SparseMatrix& operatorMatrix = matrixOf(level);
+        const size_t n = operatorMatrix.rows;
+
+        std::vector<double> inverseDiagonal;
+        operatorMatrix.diagonal(inverseDiagonal);
+        for (double& d : inverseDiagonal) {
+            d = d > 0.0 ? 1.0 / d : 0.0;
+        }
+        const double radius = estimateSpectralRadius(operatorMatrix, inverseDiagonal);
+        const double omega = 4.0 / (3.0 * radius);
+
+        levels[level].inverseDiagonal.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            levels[level].inverseDiagonal[i] = omega * inverseDiagonal[i];
+        }
+        levels[level].rhs.resize(n);
+        levels[level].solution.resize(n);
+        levels[level].residual.resize(n);
+
+        if (n <= kCoarsestSize || levels.size() >= kMaxLevels || n % blockSize != 0) {
+            break;
+        }
+        std::vector<int> aggregateOf;
+        const size_t aggregateCount = aggregateNodes(operatorMatrix, blockSize, aggregateOf);
+        if (aggregateCount == 0 || aggregateCount * vectorCount > n * 3 / 4) {
+            // Coarsening stalled
+            break;
+        }
+
+        std::vector<double> coarseNullSpace;
+        SparseMatrix tentative = tentativeProlongation(n, nullSpace, vectorCount, aggregateOf, aggregateCount,
+                                                       blockSize, coarseNullSpace);
+        SparseMatrix prolongation = smoothProlongation(operatorMatrix, inverseDiagonal, omega, tentative);
+        tentative = SparseMatrix();
+        SparseMatrix restriction = transpose(prolongation);
+        SparseMatrix coarse = product(restriction, product(operatorMatrix, prolongation));
+        levels[level].prolongation = std::move(prolongation);
+        levels[level].restriction = std::move(restriction);
+        levels.emplace_back();
+        levels.back().matrix = std::move(coarse);
+
+        // Coarse nodes carry one unknown per near-null vector
+        nullSpace = std::move(coarseNullSpace);
+        blockSize = static_cast<unsigned int>(vectorCount);
+    }
+    factorCoarsest();
+}
+
+double MultigridPreconditioner::operatorComplexity() const {
+    if (!fineMatrix || fineMatrix->nonZeros() == 0) {
+        return 0.0;
+    }
+    size_t total = fineMatrix->nonZeros();
+    for (size_t level = 1; level < levels.size(); level++) {
+        total += levels[level].matrix.nonZeros();
+    }
+    return static_cast<double>(total) / fineMatrix->nonZeros();
+}
+
+void MultigridPreconditioner::factorCoarsest() {
+    coarseFactor.clear();
+    coarsePivotValid.clear();
+    const SparseMatrix& coarse = matrixOf(levels.size() - 1);
+    const size_t n = coarse.rows;
+    if (n > kDenseLimit) {
+        return;
+    }
+
+    // Dense Cholesky; pivots that vanish (rows decoupled from everything) are skipped
+    coarseFactor.assign(n * n, 0.0);
+    coarsePivotValid.assign(n, 0);
+    for (size_t row = 0; row < n; row++) {
+        for (size_t k = coarse.rowOffsets[row]; k < coarse.rowOffsets[row + 1]; k++) {
+            if (coarse.columnIndices[k] <= row) {
+                coarseFactor[row * n + coarse.columnIndices[k]] = coarse.values[k];
+            }
+        }
+    }
+    for (size_t j = 0; j < n; j++) {
+        const double original = coarseFactor[j * n + j];
+        double pivot = original;
+        for (size_t k = 0; k < j; k++) {
+            pivot -= coarseFactor[j * n + k] * coarseFactor[j * n + k];
+        }
+        if (!(pivot > 1e-12 * std::fabs(original)) || !(original > 0.0)) {
+            for (size_t i = j; i < n; i++) {
+                coarseFactor[i * n + j] = 0.0;
+            }
+            continue;
+        }
+        coarsePivotValid[j] = 1;
+        const double diagonal = std::sqrt(pivot);
+        coarseFactor[j * n + j] = diagonal;
+        for (size_t i = j + 1; i < n; i++) {
+            double sum = coarseFactor[i * n + j];
+            for (size_t k = 0; k < j; k++) {
+                sum -= coarseFactor[i * n + k] * coarseFactor[j * n + k];
+            }
+            coarseFactor[i * n + j] = sum / diagonal;
+        }
+    }
+}
+
+void MultigridPreconditioner::apply(const double* residual, double* result) const {
+    if (levels.empty()) {
+        return;
+    }
+    std::copy(residual, residual + fineMatrix->rows, levels[0].rhs.begin());
+    cycle(0);
+    std::copy(levels[0].solution.begin(), levels[0].solution.end(), result);
+}
+
+void MultigridPreconditioner::cycle(size_t level) const {
+    const Level& current = levels[level];
+    const SparseMatrix& operatorMatrix = matrixOf(level);
+    const size_t n = operatorMatrix.rows;
+    ThreadPool& pool = ThreadPool::global();
+    double* x = current.solution.data();
+    const double* b = current.rhs.data();
+    double* r = current.residual.data();
+
+    auto jacobiSweep = [&]() {
+        computeResidual(operatorMatrix, x, b, r);
+        pool.parallelFor(n, kGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                x[i] += current.inverseDiagonal[i] * r[i];
+            }
+        });
+    };
+
+    if (level + 1 == levels.size()) {
+        if (!coarseFactor.empty()) {
+            // Forward and back substitution with the dense factor
+            for (size_t i = 0; i < n; i++) {
+                double sum = b[i];
+                for (size_t k = 0; k < i; k++) {
+                    sum -= coarseFactor[i * n + k] * x[k];
+                }
+                x[i] = coarsePivotValid[i] ? sum / coarseFactor[i * n + i] : 0.0;
+            }
+            for (size_t i = n; i-- > 0;) {
+                double sum = x[i];
+                for (size_t k = i + 1; k < n; k++) {
+                    sum -= coarseFactor[k * n + i] * x[k];
+                }
+                x[i] = coarsePivotValid[i] ? sum / coarseFactor[i * n + i] : 0.0;
+            }
+        } else {
+            std::fill(current.solution.begin(), current.solution.end(), 0.0);
+            for (int sweep = 0; sweep < kCoarseSweeps; sweep++) {
+                jacobiSweep();
+            }
+        }
+        return;
+    }
+
+    // Pre-smoothing: one damped Jacobi sweep from zero
+    pool.parallelFor(n, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            x[i] = current.inverseDiagonal[i] * b[i];
+        }
+    });
+
+    // Coarse grid correction
+    const Level& coarse = levels[level + 1];
+    computeResidual(operatorMatrix, x, b, r);
+    current.restriction.multiply(r, coarse.rhs.data());
+    cycle(level + 1);
+    const SparseMatrix& prolongation = current.prolongation;
+    pool.parallelFor(n, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++) {
+            double sum = 0.0;
+            for (size_t k = prolongation.rowOffsets[row]; k < prolongation.rowOffsets[row + 1]; k++) {
+                sum += prolongation.values[k] * coarse.solution[prolongation.columnIndices[k]];
+            }
+            x[row] += sum;
+        }
+    });
+
+    // Post-smoothing, mirroring the pre-smoother to keep the cycle symmetric
+    jacobiSweep();
+}
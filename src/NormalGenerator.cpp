@@ -0,0 +1,262 @@
+#include "NormalGenerator.h"
+#include "MeshKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// Items per parallel task
+const size_t kGrainSize = 1 << 16;
+
+// Corners are partitioned into this many contiguous position ranges
+const size_t kRangeCount = 256;
+
+/**
+ * Corners of one position whose faces lie within the crease angle.
+ */
+struct NormalGroup {
+    glm::vec3 seed;  ///< Unit face normal the group was started with
+    glm::vec3 sum;  ///< Weighted face normals of its corners
+};
+
+/**
+ * Vertex of one position assigned to one normal group.
+ */
+struct GroupVertex {
+    unsigned int vertex;  ///< Vertex as referenced by the indices
+    unsigned int group;
+    unsigned int target;  ///< Vertex the corners move to, or the local split index for duplicates
+    bool duplicate;
+};
+
+/**
+ * Vertices one position range duplicates, numbered locally until the
+ * ranges are concatenated.
+ */
+struct RangeSplits {
+    std::vector<unsigned int> sources;  ///< Original vertex of every duplicate
+    std::vector<glm::vec3> normals;  ///< Normal of every duplicate
+    std::vector<std::pair<unsigned int, unsigned int>> corners;  ///< Corner and local duplicate it moves to
+};
+
+/**
+ * First position of range r: ranges hold the positions p with p * kRangeCount / positionCount == r.
+ */
+size_t rangeStart(size_t r, size_t positionCount) {
+    return (r * positionCount + kRangeCount - 1) / kRangeCount;
+}
+
+size_t rangeOf(unsigned int position, size_t positionCount) {
+    return static_cast<size_t>(static_cast<uint64_t>(position) * kRangeCount / positionCount);
+}
+
+glm::vec3 normalizeOr(const glm::vec3& v, const glm::vec3& fallback) {
+    const float length = glm::length(v);
+    return length > 0.0f && std::isfinite(length) ? v / length : fallback;
+}
+
+} // namespace
+
+NormalReport NormalGenerator::generate(const PositionArray& positions, const std::vector<unsigned int>& positionIds,
+                                       size_t positionCount, std::vector<unsigned int>& indices,
+                                       std::vector<glm::vec3>& normals, std::vector<unsigned int>& sourceVertices,
+                                       const NormalOptions& options) {
+    auto generateStart = std::chrono::high_resolution_clock::now();
+    NormalReport report;
+    ThreadPool& pool = ThreadPool::global();
+    const size_t vertexTotal = positions.size();
+    const size_t triangleTotal = indices.size() / 3;
+    const size_t cornerTotal = triangleTotal * 3;
+    normals.assign(vertexTotal, glm::vec3(0.0f, 1.0f, 0.0f));
+    sourceVertices.clear();
+    report.triangles = triangleTotal;
+    if (triangleTotal == 0 || positionCount == 0) {
+        return report;
+    }
+
+    // Area weighted face normals (the cross product is twice the area) and corner angles
+    std::vector<glm::vec3> faceNormals(triangleTotal);
+    std::vector<float> cornerAngles(cornerTotal);
+    const size_t chunkCount = (triangleTotal + kGrainSize - 1) / kGrainSize;
+    std::vector<size_t> chunkDegenerate(chunkCount, 0);
+    pool.parallelFor(triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+        size_t degenerate = 0;
+        float* cosines = &cornerAngles[3 * begin];
+        std::vector<float> sines(3 * (end - begin), 0.0f);
+        for (size_t t = begin; t < end; t++) {
+            const glm::vec3 p0 = positions[indices[3 * t]], p1 = positions[indices[3 * t + 1]],
+                            p2 = positions[indices[3 * t + 2]];
+            const glm::vec3 cross = glm::cross(p1 - p0, p2 - p0);
+            const float doubleArea = glm::length(cross);
+            const size_t local = 3 * (t - begin);
+            if (!(doubleArea > 0.0f) || !std::isfinite(doubleArea)) {
+                faceNormals[t] = glm::vec3(0.0f);
+                cosines[local] = cosines[local + 1] = cosines[local + 2] = 0.0f;
+                degenerate++;
+                continue;
+            }
+            faceNormals[t] = cross;
+
+            // |e1 x e2| is the same at every corner, so the angles differ only in the dot product
+            const glm::vec3 corners[3] = { p0, p1, p2 };
+            for (int k = 0; k < 3; k++) {
+                const glm::vec3 e1 = corners[(k + 1) % 3] - corners[k], e2 = corners[(k + 2) % 3] - corners[k];
+                sines[local + k] = doubleArea;
+                cosines[local + k] = glm::dot(e1, e2);
+            }
+        }
+        // atan2(0, 0) is 0, so degenerate corners get no weight
+        MeshKernels::atan2Approx(sines.data(), cosines, sines.size(), cosines);
+        chunkDegenerate[begin / kGrainSize] = degenerate;
+    });
+    for (size_t degenerate : chunkDegenerate) {
+        report.degenerateTriangles += degenerate;
+    }
+
+    // Stable partition of the corners into position ranges, range-major like MeshTopology's buckets
+    const size_t cornerChunks = (cornerTotal + kGrainSize - 1) / kGrainSize;
+    std::vector<size_t> cursors(cornerChunks * kRangeCount, 0);
+    pool.parallelFor(cornerTotal, kGrainSize, [&](size_t begin, size_t end) {
+        size_t* counts = &cursors[begin / kGrainSize * kRangeCount];
+        for (size_t c = begin; c < end; c++) {
+            counts[rangeOf(positionIds[indices[c]], positionCount)]++;
+        }
+    });
+    std::vector<size_t> rangeOffsets(kRangeCount + 1, 0);
+    size_t running = 0;
+    for (size_t r = 0; r < kRangeCount; r++) {
+        rangeOffsets[r] = running;
+        for (size_t c = 0; c < cornerChunks; c++) {
+            const size_t chunkItems = cursors[c * kRangeCount + r];
+            cursors[c * kRangeCount + r] = running;
+            running += chunkItems;
+        }
+    }
+    rangeOffsets[kRangeCount] = running;
+    std::vector<unsigned int> rangeCorners(cornerTotal);
+    pool.parallelFor(cornerTotal, kGrainSize, [&](size_t begin, size_t end) {
+        size_t* cursor = &cursors[begin / kGrainSize * kRangeCount];
+        for (size_t c = begin; c < end; c++) {
+            rangeCorners[cursor[rangeOf(positionIds[indices[c]], positionCount)]++] = static_cast<unsigned int>(c);
+        }
+    });
+    cursors = std::vector<size_t>();
+
+    // Resolve every position of a range: group its corners, then give every (vertex, group) pair a vertex
+    const float creaseCos = options.creaseAngle >= 180.0f ? -2.0f : std::cos(glm::radians(options.creaseAngle));
+    std::vector<RangeSplits> splits(kRangeCount);
+    pool.run(kRangeCount, [&](size_t r) {
+        const size_t firstPosition = rangeStart(r, positionCount);
+        const size_t positionSpan = rangeStart(r + 1, positionCount) - firstPosition;
+        const size_t first = rangeOffsets[r], count = rangeOffsets[r + 1] - first;
+
+        // Counting sort by position inside the range, keeping corner order
+        std::vector<unsigned int> positionStart(positionSpan + 1, 0);
+        for (size_t k = first; k < first + count; k++) {
+            positionStart[positionIds[indices[rangeCorners[k]]] - firstPosition + 1]++;
+        }
+        for (size_t p = 0; p < positionSpan; p++) {
+            positionStart[p + 1] += positionStart[p];
+        }
+        std::vector<unsigned int> sorted(count);
+        {
+            std::vector<unsigned int> cursor(positionStart.begin(), positionStart.end() - 1);
+            for (size_t k = first; k < first + count; k++) {
+                const unsigned int c = rangeCorners[k];
+                sorted[cursor[positionIds[indices[c]] - firstPosition]++] = c;
+            }
+        }
+
+        RangeSplits& rangeSplits = splits[r];
+        std::vector<NormalGroup> groups;
+        std::vector<unsigned int> cornerGroups;
+        std::vector<GroupVertex> groupVertices;
+        for (size_t p = 0; p < positionSpan; p++) {
+            const unsigned int* corners = sorted.data() + positionStart[p];
+            const size_t cornerCount = positionStart[p + 1] - positionStart[p];
+            groups.clear();
+            cornerGroups.resize(cornerCount);
+            for (size_t k = 0; k < cornerCount; k++) {
+                const unsigned int c = corners[k];
+                const glm::vec3 faceNormal = faceNormals[c / 3];
+                const glm::vec3 unit = normalizeOr(faceNormal, glm::vec3(0.0f));
+                const bool degenerate = unit == glm::vec3(0.0f);
+
+                // Join the first group within the crease angle; degenerate corners join any group
+                size_t g = 0;
+                while (g < groups.size()) {
+                    if (groups[g].seed == glm::vec3(0.0f)) {
+                        groups[g].seed = unit;
+                        break;
+                    }
+                    if (degenerate || glm::dot(groups[g].seed, unit) >= creaseCos) {
+                        break;
+                    }
+                    g++;
+                }
+                if (g == groups.size()) {
+                    groups.push_back(NormalGroup{ unit, glm::vec3(0.0f) });
+                }
+                groups[g].sum += faceNormal * cornerAngles[c];
+                cornerGroups[k] = static_cast<unsigned int>(g);
+            }
+
+            // The first group of a vertex keeps it, every further group gets a duplicate
+            groupVertices.clear();
+            for (size_t k = 0; k < cornerCount; k++) {
+                const unsigned int c = corners[k], v = indices[c], g = cornerGroups[k];
+                const NormalGroup& group = groups[g];
+                bool seenVertex = false;
+                const GroupVertex* match = nullptr;
+                for (const GroupVertex& entry : groupVertices) {
+                    seenVertex = seenVertex || entry.vertex == v;
+                    if (entry.vertex == v && entry.group == g) {
+                        match = &entry;
+                        break;
+                    }
+                }
+                if (!match) {
+                    const glm::vec3 normal = normalizeOr(group.sum, normalizeOr(group.seed, glm::vec3(0.0f, 1.0f, 0.0f)));
+                    if (!seenVertex) {
+                        normals[v] = normal;
+                        groupVertices.push_back(GroupVertex{ v, g, v, false });
+                    } else {
+                        const unsigned int local = static_cast<unsigned int>(rangeSplits.sources.size());
+                        rangeSplits.sources.push_back(v);
+                        rangeSplits.normals.push_back(normal);
+                        groupVertices.push_back(GroupVertex{ v, g, local, true });
+                    }
+                    match = &groupVertices.back();
+                }
+                if (match->duplicate) {
+                    rangeSplits.corners.emplace_back(c, match->target);
+                }
+            }
+        }
+    });
+    rangeCorners = std::vector<unsigned int>();
+
+    // Append the duplicates range by range and move their corners
+    std::vector<size_t> splitBase(kRangeCount + 1, 0);
+    for (size_t r = 0; r < kRangeCount; r++) {
+        splitBase[r + 1] = splitBase[r] + splits[r].sources.size();
+    }
+    report.creaseVertices = splitBase[kRangeCount];
+    normals.resize(vertexTotal + report.creaseVertices);
+    sourceVertices.resize(report.creaseVertices);
+    pool.run(kRangeCount, [&](size_t r) {
+        const RangeSplits& rangeSplits = splits[r];
+        const size_t base = splitBase[r];
+        std::copy(rangeSplits.sources.begin(), rangeSplits.sources.end(), sourceVertices.begin() + base);
+        std::copy(rangeSplits.normals.begin(), rangeSplits.normals.end(), normals.begin() + vertexTotal + base);
+        for (const std::pair<unsigned int, unsigned int>& corner : rangeSplits.corners) {
+            indices[corner.first] = static_cast<unsigned int>(vertexTotal + base + corner.second);
+        }
+    });
+
+    report.generateMs =
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - generateStart).count();
+    return report;
+}
@@ -0,0 +1,759 @@
+#include "ObjParser.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace {
+
+// Powers of ten that are exactly representable as doubles
+const double kPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Mantissas up to 2^53 convert to double without rounding
+const uint64_t kMaxExactMantissa = uint64_t(1) << 53;
+
+inline bool isDigit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+inline const char* skipLine(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return newline ? static_cast<const char*>(newline) + 1 : end;
+}
+
+inline const char* skipToken(const char* p, const char* end) {
+    while (p < end && !isBlank(*p) && *p != '\n') {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * Slow path for numbers the fast scanner cannot convert exactly (more than
+ * 19 significant digits, huge exponents, "nan", "inf"). The token is copied
+ * into a null-terminated buffer and handed to strtof.
+ */
+const char* scanFloatFallback(const char* start, const char* end, float& value) {
+    const char* tokenEnd = skipToken(start, end);
+    char buffer[64];
+    size_t length = static_cast<size_t>(tokenEnd - start);
+    if (length < sizeof(buffer)) {
+        std::memcpy(buffer, start, length);
+        buffer[length] = '\0';
+        value = std::strtof(buffer, nullptr);
+    } else {
+        value = std::strtof(std::string(start, length).c_str(), nullptr);
+    }
+    return tokenEnd;
+}
+
+/**
+ * Scans a decimal floating point number starting at p (leading blanks are
+ * skipped). Returns the position after the number. Missing numbers leave
+ * value untouched and return the position of the next non-blank character.
+ */
+const char* scanFloat(const char* p, const char* end, float& value) {
+    p = skipBlanks(p, end);
+    const char* start = p;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool sawDigit = false;
+    bool truncated = false;
+
+    while (p < end && isDigit(*p)) {
+        sawDigit = true;
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            if (mantissa != 0) {
+                ++significantDigits;
+            }
+        } else {
+            ++exponent;
+            truncated = true;
+        }
+        ++p;
+    }
+
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && isDigit(*p)) {
+            sawDigit = true;
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                if (mantissa != 0) {
+                    ++significantDigits;
+                }
+                --exponent;
+            } else {
+                truncated = true;
+            }
+            ++p;
+        }
+    }
+
+    if (!sawDigit) {
+        if (p == start && (p >= end || *p == '\n')) {
+            return p;
+        }
+        return scanFloatFallback(start, end, value);
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* exponentStart = p;
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+        if (p < end && isDigit(*p)) {
+            int explicitExponent = 0;
+            while (p < end && isDigit(*p)) {
+                if (explicitExponent < 10000) {
+                    explicitExponent = explicitExponent * 10 + (*p - '0');
+                }
+                ++p;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        } else {
+            // Not an exponent after all ("1e" or "1e-"), stop before it
+            p = exponentStart;
+        }
+    }
+
+    if (truncated || mantissa > kMaxExactMantissa || exponent < -22 || exponent > 22) {
+        return scanFloatFallback(start, end, value);
+    }
+
+    double result = static_cast<double>(mantissa);
+    result = exponent < 0 ? result / kPowersOfTen[-exponent] : result * kPowersOfTen[exponent];
+    value = static_cast<float>(negative ? -result : result);
+    return p;
+}
+
+/**
+ * Scans an optionally signed decimal integer. Returns start unchanged when
+ * no digits are present.
+ */
+inline const char* scanInt(const char* p, const char* end, long long& value) {
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    if (p >= end || !isDigit(*p)) {
+        return start;
+    }
+    long long result = 0;
+    while (p < end && isDigit(*p)) {
+        if (result < (1LL << 40)) {
+            result = result * 10 + (*p - '0');
+        }
+        ++p;
+    }
+    value = negative ? -result : result;
+    return p;
+}
+
+/**
+ * A face with more than three corners. Its corners are kept aside until all
+ * positions are known; the (cornerCount - 2) triangles it produces have
+ * their slots reserved in the corner list at parse time.
+ */
+struct ObjPolygon {
+    size_t firstSlot;  ///< First reserved triangle corner in ObjData::corners
+    size_t firstCorner;  ///< First entry in ObjChunk::polygonCorners
+    size_t cornerCount;  ///< Number of polygon corners
+};
+
+/**
+ * Parse state of one newline-aligned slice of the file. Indices are stored
+ * as they can be resolved without knowing what precedes the chunk:
+ * positive OBJ indices are absolute already, negative (relative) ones are
+ * stored relative to the start of the chunk and listed in relativeRefs so
+ * the merge step can add the number of elements defined by earlier chunks.
+ */
+struct ObjChunk {
+    ObjData data;
+    std::vector<size_t> relativeRefs;  ///< corner * 3 + attribute (0 position, 1 texcoord, 2 normal)
+    std::vector<ObjPolygon> polygons;  ///< Faces waiting for triangulation
+    std::vector<ObjCorner> polygonCorners;  ///< Corners of all polygons, back to back
+    std::vector<size_t> polygonRelativeRefs;  ///< Same encoding as relativeRefs, into polygonCorners
+    std::vector<ObjCorner> faceCorners;  ///< Scratch for the face being scanned
+    std::vector<unsigned int> faceRelativeMasks;  ///< Scratch for the face being scanned
+    bool valid;
+
+    ObjChunk() : valid(true) {}
+};
+
+// Chunks smaller than this are not worth handing to another thread
+const size_t kMinChunkBytes = size_t(1) << 20;
+
+/**
+ * Converts an OBJ index into a chunk-local 0-based index. Returns false if the
+ * index is 0, which OBJ does not allow, or if the result does not fit an int
+ * (instead of wrapping around to some valid index).
+ */
+inline bool resolveIndex(long long index, size_t localCount, int& resolved, bool& relative) {
+    const long long value = index > 0 ? index - 1 : static_cast<long long>(localCount) + index;
+    if (index == 0 || value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+        resolved = -1;
+        relative = false;
+        return false;
+    }
+    resolved = static_cast<int>(value);
+    relative = index < 0;
+    return true;
+}
+
+/**
+ * Scans one "v", "v/vt", "v//vn" or "v/vt/vn" face corner. Returns start
+ * unchanged if no corner is present. relativeMask receives a bit per
+ * attribute that used a relative index.
+ */
+const char* scanCorner(const char* p, const char* end, const ObjData& data,
+                       ObjCorner& corner, unsigned int& relativeMask, bool& valid) {
+    long long index = 0;
+    const char* next = scanInt(p, end, index);
+    if (next == p) {
+        return p;
+    }
+    p = next;
+
+    bool relative = false;
+    relativeMask = 0;
+    corner.texcoord = -1;
+    corner.normal = -1;
+    valid = resolveIndex(index, data.positions.size(), corner.position, relative) && valid;
+    relativeMask |= relative ? 1u : 0u;
+
+    if (p < end && *p == '/') {
+        ++p;
+        next = scanInt(p, end, index);
+        if (next != p) {
+            valid = resolveIndex(index, data.texcoords.size(), corner.texcoord, relative) && valid;
+            relativeMask |= relative ? 2u : 0u;
+            p = next;
+        }
+        if (p < end && *p == '/') {
+            ++p;
+            next = scanInt(p, end, index);
+            if (next != p) {
+                valid = resolveIndex(index, data.normals.size(), corner.normal, relative) && valid;
+                relativeMask |= relative ? 4u : 0u;
+                p = next;
+            }
+        }
+    }
+    return p;
+}
+
+/**
+ * Records which attributes of a corner used relative indices.
+ */
+inline void appendRelativeRefs(unsigned int relativeMask, size_t corner, std::vector<size_t>& refs) {
+    for (unsigned int attribute = 0; attribute < 3; attribute++) {
+        if (relativeMask & (1u << attribute)) {
+            refs.push_back(corner * 3 + attribute);
+        }
+    }
+}
+
+/**
+ * Parses the records of one chunk. The chunk must start at the beginning of
+ * a line and end after a newline (or at the end of the file).
+ */
+void parseChunk(const char* begin, const char* end, ObjChunk& chunk) {
+    ObjData& out = chunk.data;
+    const char* p = begin;
+    while (p < end) {
+        p = skipBlanks(p, end);
+        if (p >= end) {
+            break;
+        }
+
+        const char c0 = *p;
+        const char c1 = p + 1 < end ? p[1] : '\n';
+
+        if (c0 == 'v' && isBlank(c1)) {
+            glm::vec3 position(0.0f);
+            p = scanFloat(p + 1, end, position.x);
+            p = scanFloat(p, end, position.y);
+            p = scanFloat(p, end, position.z);
+            out.positions.push_back(position);
+        }
+        else if (c0 == 'v' && c1 == 't' && p + 2 < end && isBlank(p[2])) {
+            glm::vec2 uv(0.0f);
+            p = scanFloat(p + 2, end, uv.x);
+            p = scanFloat(p, end, uv.y);
+            out.texcoords.push_back(uv);
+        }
+        else if (c0 == 'v' && c1 == 'n' && p + 2 < end && isBlank(p[2])) {
+            glm::vec3 normal(0.0f);
+            p = scanFloat(p + 2, end, normal.x);
+            p = scanFloat(p, end, normal.y);
+            p = scanFloat(p, end, normal.z);
+            out.normals.push_back(normal);
+        }
+        else if (c0 == 'f' && isBlank(c1)) {
+            chunk.faceCorners.clear();
+            chunk.faceRelativeMasks.clear();
+            bool faceValid = true;
+            p = p + 1;
+            while (true) {
+                p = skipBlanks(p, end);
+                ObjCorner corner;
+                unsigned int relativeMask = 0;
+                const char* next = scanCorner(p, end, out, corner, relativeMask, faceValid);
+                if (next == p) {
+                    break;
+                }
+                p = next;
+                chunk.faceCorners.push_back(corner);
+                chunk.faceRelativeMasks.push_back(relativeMask);
+            }
+
+            const size_t cornerCount = chunk.faceCorners.size();
+            if (cornerCount >= 3) {
+                chunk.valid = chunk.valid && faceValid;
+                // Relative references into earlier chunks are still negative here, see rebaseRelativeRefs
+                for (size_t i = 0; i < cornerCount; i++) {
+                    const ObjCorner& corner = chunk.faceCorners[i];
+                    const unsigned int relativeMask = chunk.faceRelativeMasks[i];
+                    out.hasTexcoords = out.hasTexcoords || corner.texcoord >= 0 || (relativeMask & 2u) != 0;
+                    out.hasNormals = out.hasNormals || corner.normal >= 0 || (relativeMask & 4u) != 0;
+                }
+
+                if (cornerCount == 3) {
+                    for (size_t i = 0; i < 3; i++) {
+                        appendRelativeRefs(chunk.faceRelativeMasks[i], out.corners.size(), chunk.relativeRefs);
+                        out.corners.push_back(chunk.faceCorners[i]);
+                    }
+                } else {
+                    // Triangulated once every position is known, see triangulatePolygon
+                    ObjPolygon polygon;
+                    polygon.firstSlot = out.corners.size();
+                    polygon.firstCorner = chunk.polygonCorners.size();
+                    polygon.cornerCount = cornerCount;
+                    chunk.polygons.push_back(polygon);
+                    for (size_t i = 0; i < cornerCount; i++) {
+                        appendRelativeRefs(chunk.faceRelativeMasks[i], chunk.polygonCorners.size(), chunk.polygonRelativeRefs);
+                        chunk.polygonCorners.push_back(chunk.faceCorners[i]);
+                    }
+                    out.corners.resize(out.corners.size() + (cornerCount - 2) * 3);
+                }
+            }
+        }
+
+        p = skipLine(p, end);
+    }
+}
+
+/**
+ * Splits [begin, end) into at most chunkCount ranges that each start at the
+ * beginning of a line. Returns chunk boundaries, including begin and end.
+ */
+std::vector<const char*> splitLines(const char* begin, const char* end, size_t chunkCount) {
+    std::vector<const char*> bounds;
+    bounds.push_back(begin);
+    size_t size = static_cast<size_t>(end - begin);
+    for (size_t i = 1; i < chunkCount; i++) {
+        const char* target = begin + size / chunkCount * i;
+        if (target <= bounds.back()) {
+            continue;
+        }
+        const char* lineStart = skipLine(target, end);
+        if (lineStart >= end) {
+            break;
+        }
+        if (lineStart > bounds.back()) {
+            bounds.push_back(lineStart);
+        }
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+/**
+ * Adds the element counts of preceding chunks to the relative references
+ * in refs. Returns false if a reference points before the start of the file.
+ */
+bool rebaseRelativeRefs(const std::vector<size_t>& refs, ObjCorner* corners,
+                        size_t positionBase, size_t texcoordBase, size_t normalBase) {
+    bool valid = true;
+    for (size_t ref : refs) {
+        ObjCorner& corner = corners[ref / 3];
+        switch (ref % 3) {
+        case 0:
+            corner.position += static_cast<int>(positionBase);
+            valid = valid && corner.position >= 0;
+            break;
+        case 1:
+            corner.texcoord += static_cast<int>(texcoordBase);
+            valid = valid && corner.texcoord >= 0;
+            break;
+        default:
+            corner.normal += static_cast<int>(normalBase);
+            valid = valid && corner.normal >= 0;
+            break;
+        }
+    }
+    return valid;
+}
+
+/**
+ * Checks that every corner in [begin, end) references an existing attribute.
+ */
+bool cornersInRange(const ObjCorner* begin, const ObjCorner* end, const ObjData& merged) {
+    const int positionCount = static_cast<int>(merged.positions.size());
+    const int texcoordCount = static_cast<int>(merged.texcoords.size());
+    const int normalCount = static_cast<int>(merged.normals.size());
+    for (const ObjCorner* corner = begin; corner < end; ++corner) {
+        if (corner->position < 0 || corner->position >= positionCount
+            || corner->texcoord >= texcoordCount || corner->normal >= normalCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Twice the signed area of the 2D triangle (a, b, c).
+ */
+inline float cross2(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+/**
+ * Splits a polygon into cornerCount - 2 triangles written to out.
+ *
+ * Convex polygons (the common case, including every planar quad) are fanned
+ * from the first corner. Concave polygons are ear clipped in the plane that
+ * best fits them (Newell normal, dominant axis dropped). Winding order is
+ * preserved either way. Scratch storage is reused per thread, so no memory
+ * is allocated once it has grown to the largest polygon.
+ */
+void triangulatePolygon(const ObjCorner* polygon, size_t cornerCount,
+                        const std::vector<glm::vec3>& positions, ObjCorner* out) {
+    static thread_local std::vector<glm::vec2> projected;
+    static thread_local std::vector<size_t> previous;
+    static thread_local std::vector<size_t> next;
+
+    auto emit = [&](size_t a, size_t b, size_t c) {
+        *out++ = polygon[a];
+        *out++ = polygon[b];
+        *out++ = polygon[c];
+    };
+    auto emitFan = [&]() {
+        for (size_t i = 1; i + 1 < cornerCount; i++) {
+            emit(0, i, i + 1);
+        }
+    };
+
+    // Newell normal of the polygon
+    glm::vec3 normal(0.0f);
+    for (size_t i = 0; i < cornerCount; i++) {
+        const glm::vec3& a = positions[polygon[i].position];
+        const glm::vec3& b = positions[polygon[(i + 1) % cornerCount].position];
+        normal.x += (a.y - b.y) * (a.z + b.z);
+        normal.y += (a.z - b.z) * (a.x + b.x);
+        normal.z += (a.x - b.x) * (a.y + b.y);
+    }
+
+    // Project onto the plane of the two axes the normal is least aligned with
+    glm::vec3 magnitude(std::fabs(normal.x), std::fabs(normal.y), std::fabs(normal.z));
+    int uAxis = 1, vAxis = 2;
+    if (magnitude.y >= magnitude.x && magnitude.y >= magnitude.z) {
+        uAxis = 2;
+        vAxis = 0;
+    } else if (magnitude.z >= magnitude.x && magnitude.z >= magnitude.y) {
+        uAxis = 0;
+        vAxis = 1;
+    }
+
+    projected.resize(cornerCount);
+    for (size_t i = 0; i < cornerCount; i++) {
+        const glm::vec3& position = positions[polygon[i].position];
+        projected[i] = glm::vec2(position[uAxis], position[vAxis]);
+    }
+
+    float area = 0.0f;
+    for (size_t i = 0; i < cornerCount; i++) {
+        const glm::vec2& a = projected[i];
+        const glm::vec2& b = projected[(i + 1) % cornerCount];
+        area += a.x * b.y - b.x * a.y;
+    }
+    if (area == 0.0f) {
+        emitFan();
+        return;
+    }
+    const float orientation = area > 0.0f ? 1.0f : -1.0f;
+
+    bool convex = true;
+    for (size_t i = 0; i < cornerCount && convex; i++) {
+        size_t prev = (i + cornerCount - 1) % cornerCount;
+        size_t succ = (i + 1) % cornerCount;
+        convex = cross2(projected[prev], projected[i], projected[succ]) * orientation >= 0.0f;
+    }
+    if (convex) {
+        emitFan();
+        return;
+    }
+
+    previous.resize(cornerCount);
+    next.resize(cornerCount);
+    for (size_t i = 0; i < cornerCount; i++) {
+        previous[i] = (i + cornerCount - 1) % cornerCount;
+        next[i] = (i + 1) % cornerCount;
+    }
+
+    auto isEar = [&](size_t corner) {
+        const size_t a = previous[corner];
+        const size_t c = next[corner];
+        const glm::vec2& pa = projected[a];
+        const glm::vec2& pb = projected[corner];
+        const glm::vec2& pc = projected[c];
+        if (cross2(pa, pb, pc) * orientation <= 0.0f) {
+            return false;
+        }
+        for (size_t other = next[c]; other != a; other = next[other]) {
+            const glm::vec2& point = projected[other];
+            if (cross2(pa, pb, point) * orientation >= 0.0f
+                && cross2(pb, pc, point) * orientation >= 0.0f
+                && cross2(pc, pa, point) * orientation >= 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    size_t remaining = cornerCount;
+    size_t corner = 0;
+    size_t stalled = 0;
+    while (remaining > 3) {
+        if (isEar(corner)) {
+            emit(previous[corner], corner, next[corner]);
+            next[previous[corner]] = next[corner];
+            previous[next[corner]] = previous[corner];
+            corner = next[corner];
+            remaining--;
+            stalled = 0;
+        } else if (++stalled > remaining) {
+            // Self-intersecting or degenerate outline, fan what is left
+            size_t anchor = corner;
+            for (size_t i = next[anchor]; next[i] != anchor; i = next[i]) {
+                emit(anchor, i, next[i]);
+            }
+            return;
+        } else {
+            corner = next[corner];
+        }
+    }
+    emit(previous[corner], corner, next[corner]);
+}
+
+/**
+ * Rebases the relative references of a chunk, triangulates its polygons and
+ * validates every corner against the final pool sizes. Returns false on any
+ * dangling index.
+ */
+bool resolveChunkCorners(ObjChunk& chunk, const ObjData& merged, size_t cornerOffset, size_t cornerEnd,
+                         size_t positionBase, size_t texcoordBase, size_t normalBase,
+                         std::vector<ObjCorner>& corners) {
+    bool valid = chunk.valid;
+    valid = rebaseRelativeRefs(chunk.relativeRefs, corners.data() + cornerOffset,
+                               positionBase, texcoordBase, normalBase) && valid;
+    valid = rebaseRelativeRefs(chunk.polygonRelativeRefs, chunk.polygonCorners.data(),
+                               positionBase, texcoordBase, normalBase) && valid;
+
+    // Positions must be known to be valid before polygons can look at them
+    const ObjCorner* polygonCorners = chunk.polygonCorners.data();
+    valid = valid && cornersInRange(polygonCorners, polygonCorners + chunk.polygonCorners.size(), merged);
+    if (valid) {
+        for (const ObjPolygon& polygon : chunk.polygons) {
+            triangulatePolygon(polygonCorners + polygon.firstCorner, polygon.cornerCount,
+                               merged.positions, corners.data() + cornerOffset + polygon.firstSlot);
+        }
+    }
+
+    return valid && cornersInRange(corners.data() + cornerOffset, corners.data() + cornerEnd, merged);
+}
+
+/**
+ * Hash of an index triple (murmur3 finalizer over a multiplicative mix).
+ */
+inline uint32_t hashCorner(const ObjCorner& corner) {
+    uint32_t h = static_cast<uint32_t>(corner.position) * 0x9E3779B1u;
+    h ^= static_cast<uint32_t>(corner.texcoord) * 0x85EBCA77u;
+    h ^= static_cast<uint32_t>(corner.normal) * 0xC2B2AE3Du;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+inline bool sameCorner(const ObjCorner& a, const ObjCorner& b) {
+    return a.position == b.position && a.texcoord == b.texcoord && a.normal == b.normal;
+}
+
+} // namespace
+
+void ObjData::clear() {
+    positions.clear();
+    texcoords.clear();
+    normals.clear();
+    corners.clear();
+    hasTexcoords = false;
+    hasNormals = false;
+}
+
+bool ObjParser::parseFile(const std::string& filename, ObjData& out, bool multithreaded) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    return parse(file.data(), file.data() + file.size(), out, multithreaded);
+}
+
+bool ObjParser::parse(const char* begin, const char* end, ObjData& out, bool multithreaded) {
+    out.clear();
+
+    ThreadPool& pool = ThreadPool::global();
+    size_t size = static_cast<size_t>(end - begin);
+    size_t chunkCount = 1;
+    if (multithreaded && pool.size() > 1) {
+        // Several chunks per thread so uneven record mixes still balance
+        chunkCount = std::min<size_t>(pool.size() * 4, std::max<size_t>(1, size / kMinChunkBytes));
+    }
+
+    std::vector<const char*> bounds = splitLines(begin, end, chunkCount);
+    std::vector<ObjChunk> chunks(bounds.size() - 1);
+    pool.run(chunks.size(), [&](size_t i) {
+        parseChunk(bounds[i], bounds[i + 1], chunks[i]);
+    });
+
+    // Element counts of all preceding chunks, in file order
+    std::vector<size_t> positionBase(chunks.size()), texcoordBase(chunks.size());
+    std::vector<size_t> normalBase(chunks.size()), cornerBase(chunks.size() + 1);
+    size_t positionCount = 0, texcoordCount = 0, normalCount = 0, cornerCount = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const ObjData& data = chunks[i].data;
+        positionBase[i] = positionCount;
+        texcoordBase[i] = texcoordCount;
+        normalBase[i] = normalCount;
+        cornerBase[i] = cornerCount;
+        positionCount += data.positions.size();
+        texcoordCount += data.texcoords.size();
+        normalCount += data.normals.size();
+        cornerCount += data.corners.size();
+        out.hasTexcoords = out.hasTexcoords || data.hasTexcoords;
+        out.hasNormals = out.hasNormals || data.hasNormals;
+    }
+    cornerBase[chunks.size()] = cornerCount;
+
+    if (chunks.size() == 1) {
+        // Nothing to merge, take the pools as they are
+        ObjChunk& chunk = chunks.front();
+        out.positions.swap(chunk.data.positions);
+        out.texcoords.swap(chunk.data.texcoords);
+        out.normals.swap(chunk.data.normals);
+        out.corners.swap(chunk.data.corners);
+    } else {
+        out.positions.resize(positionCount);
+        out.texcoords.resize(texcoordCount);
+        out.normals.resize(normalCount);
+        out.corners.resize(cornerCount);
+
+        pool.run(chunks.size(), [&](size_t i) {
+            ObjData& data = chunks[i].data;
+            std::copy(data.positions.begin(), data.positions.end(), out.positions.begin() + positionBase[i]);
+            std::copy(data.texcoords.begin(), data.texcoords.end(), out.texcoords.begin() + texcoordBase[i]);
+            std::copy(data.normals.begin(), data.normals.end(), out.normals.begin() + normalBase[i]);
+            std::copy(data.corners.begin(), data.corners.end(), out.corners.begin() + cornerBase[i]);
+
+            // Drop the chunk's copy right away to keep peak memory near the size of the merged pools
+            data = ObjData();
+        });
+    }
+
+    // Separate pass: polygons may reference positions merged from any other chunk
+    std::vector<char> chunkValid(chunks.size(), 1);
+    pool.run(chunks.size(), [&](size_t i) {
+        chunkValid[i] = resolveChunkCorners(chunks[i], out, cornerBase[i], cornerBase[i + 1], positionBase[i],
+                                            texcoordBase[i], normalBase[i], out.corners) ? 1 : 0;
+    });
+
+    bool valid = std::find(chunkValid.begin(), chunkValid.end(), 0) == chunkValid.end();
+    if (!valid) {
+        std::cerr << "Error: OBJ face references an attribute that does not exist" << std::endl;
+    }
+    return valid;
+}
+
+void ObjParser::weldCorners(const std::vector<ObjCorner>& corners,
+                            std::vector<ObjCorner>& uniqueCorners,
+                            std::vector<unsigned int>& indices) {
+    const uint32_t kEmpty = 0xFFFFFFFFu;
+
+    // Power-of-two table at most half full, so linear probes stay short
+    size_t capacity = 16;
+    while (capacity < corners.size() * 2) {
+        capacity <<= 1;
+    }
+    const uint32_t mask = static_cast<uint32_t>(capacity - 1);
+    std::vector<uint32_t> slots(capacity, kEmpty);
+
+    uniqueCorners.clear();
+    indices.resize(corners.size());
+
+    for (size_t i = 0; i < corners.size(); i++) {
+        const ObjCorner& corner = corners[i];
+        uint32_t slot = hashCorner(corner) & mask;
+        while (true) {
+            uint32_t vertex = slots[slot];
+            if (vertex == kEmpty) {
+                vertex = static_cast<uint32_t>(uniqueCorners.size());
+                slots[slot] = vertex;
+                uniqueCorners.push_back(corner);
+                indices[i] = vertex;
+                break;
+            }
+            if (sameCorner(uniqueCorners[vertex], corner)) {
+                indices[i] = vertex;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+}
@@ -30,6 +30,16 @@ Renderer::Renderer(int width, int height)
     , detailStrength(0.7f)
     , rimLightStrength(0.3f)
     , showUI(true)
+    , projectionChoice(0)
+    , frustumCulling(true)
+    , coneCulling(false)  // Back faces are drawn (no GL_CULL_FACE), so hiding them is opt-in
+    , visibleMeshlets(0)
+    , drawnTriangles(0)
+    , timerQueries{ 0, 0 }
+    , timerQueryIssued{ false, false }
+    , frameIndex(0)
+    , cpuFrameMs(0.0f)
+    , gpuDrawMs(0.0f)
 {
 }
 
@@ -104,16 +114,77 @@ bool Renderer::init() {
     // The buffer swap (to show the rendered image) will occur once per vertical refresh
     glfwSwapInterval(1);
 
+    // Two timer queries so the result of the previous frame can be read without stalling
+    glGenQueries(2, timerQueries);
+
     std::cout << "Renderer initialized successfully" << std::endl;
     return true;
 }
 
+bool Renderer::takeProjectionRequest(std::string& projection) {
+    if (requestedProjection.empty()) {
+        return false;
+    }
+    projection.swap(requestedProjection);
+    requestedProjection.clear();
+    return true;
+}
+
 void Renderer::updateCamera() {
     glm::vec3 direction = cameraRotation * glm::vec3(0.0f, 0.0f, -1.0f);
     cameraPos = cameraTarget - direction * cameraDistance;
 }
 
-void Renderer::renderUI() {
+void Renderer::cullMeshlets(const Mesh& mesh, const glm::mat4& modelViewProjection, const glm::vec3& modelCamera) {
+    // Frustum planes (left, right, bottom, top, near, far) from the rows of the clip transform, in model space
+    glm::vec4 planes[6];
+    const glm::mat4 m = glm::transpose(modelViewProjection);
+    for (int axis = 0; axis < 3; axis++) {
+        planes[2 * axis] = m[3] + m[axis];
+        planes[2 * axis + 1] = m[3] - m[axis];
+    }
+    for (glm::vec4& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    drawCounts.clear();
+    drawOffsets.clear();
+    visibleMeshlets = 0;
+    drawnTriangles = 0;
+    size_t rangeEnd = 0;
+    for (const Meshlet& meshlet : mesh.getMeshlets()) {
+        bool visible = true;
+        if (frustumCulling) {
+            for (const glm::vec4& plane : planes) {
+                if (glm::dot(glm::vec3(plane), meshlet.center) + plane.w < -meshlet.radius) {
+                    visible = false;
+                    break;
+                }
+            }
+        }
+        // A camera inside the cone's back region sees only back faces
+        if (visible && coneCulling &&
+            glm::dot(glm::normalize(meshlet.coneApex - modelCamera), meshlet.coneAxis) >= meshlet.coneCutoff) {
+            visible = false;
+        }
+        if (!visible) {
+            continue;
+        }
+        const GLsizei count = static_cast<GLsizei>(3 * meshlet.triangleCount);
+        if (!drawCounts.empty() && rangeEnd == meshlet.firstIndex) {
+            drawCounts.back() += count;
+        } else {
+            drawCounts.push_back(count);
+            drawOffsets.push_back(reinterpret_cast<const void*>(static_cast<size_t>(meshlet.firstIndex) *
+                                                                sizeof(unsigned int)));
+        }
+        rangeEnd = static_cast<size_t>(meshlet.firstIndex) + count;
+        visibleMeshlets++;
+        drawnTriangles += meshlet.triangleCount;
+    }
+}
+
+void Renderer::renderUI(const Mesh& mesh) {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -156,6 +227,32 @@ void Renderer::renderUI() {
             ImGui::SliderFloat("Rim Lighting", &rimLightStrength, 0.0f, 1.0f);
         }
 
+        if (ImGui::CollapsingHeader("UV Mapping")) {
+            static const char* const projections[] = { "auto",      "best",      "planar", "box", "cylindrical",
+                                                       "spherical", "segmented", "hybrid", "lscm", "abf" };
+            ImGui::Combo("Projection", &projectionChoice, projections, IM_ARRAYSIZE(projections));
+            if (ImGui::Button("Regenerate UVs")) {
+                requestedProjection = projections[projectionChoice];
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Performance")) {
+            const VertexFormat& format = mesh.getVertexFormat();
+            ImGui::Text("Vertex format: %s", format.describe().c_str());
+            ImGui::Text("Vertex buffer: %.2f MB (%u vertices)",
+                        static_cast<double>(mesh.getVertexBufferBytes()) / (1024.0 * 1024.0), mesh.getVertexCount());
+            ImGui::Text("CPU frame: %.3f ms", cpuFrameMs);
+            ImGui::Text("GPU draw: %.3f ms", gpuDrawMs);
+            if (!mesh.getMeshlets().empty()) {
+                ImGui::Checkbox("Frustum culling", &frustumCulling);
+                // The cones are built from counter-clockwise front faces; clockwise models lose their visible side
+                ImGui::Checkbox("Backface cone culling (CCW front faces)", &coneCulling);
+                ImGui::Text("Meshlets: %zu / %zu drawn in %zu ranges", visibleMeshlets, mesh.getMeshlets().size(),
+                            drawCounts.size());
+                ImGui::Text("Triangles: %zu / %u", drawnTriangles, mesh.getIndexCount() / 3);
+            }
+        }
+
         ImGui::End();
     }
 
@@ -178,6 +275,7 @@ void Renderer::render(const Mesh& mesh, const Shader& shader, const Texture& tex
     // lastFrameTime is initialized statically so it retains its value across multiple calls to render()
     static auto lastFrameTime = std::chrono::high_resolution_clock::now();
     auto currentFrameTime = std::chrono::high_resolution_clock::now();
+    const auto frameStart = currentFrameTime;
     float deltaTime = std::chrono::duration<float>(currentFrameTime - lastFrameTime).count();
     lastFrameTime = currentFrameTime;
 
@@ -220,17 +318,65 @@ void Renderer::render(const Mesh& mesh, const Shader& shader, const Texture& tex
     shader.setFloat("detailStrength", enhanceDetails ? detailStrength : 0.0f);
     shader.setFloat("rimLightStrength", enhanceDetails ? rimLightStrength : 0.0f);
 
+    // Pass the decode constants of the mesh's vertex format
+    const VertexDecode& decode = mesh.getVertexDecode();
+    shader.setVec3("positionOffset", decode.positionOffset);
+    shader.setVec3("positionScale", decode.positionScale);
+    shader.setVec2("uvOffset", decode.uvOffset);
+    shader.setVec2("uvScale", decode.uvScale);
+    shader.setBool("octahedralNormals", decode.octahedralNormals);
+    shader.setBool("hasTangents", mesh.getVertexFormat().tangent != TangentEncoding::None);
+
+    // Read the draw time of the previous frame if the GPU has finished it
+    const unsigned int query = frameIndex & 1u;
+    const unsigned int previousQuery = query ^ 1u;
+    if (timerQueryIssued[previousQuery]) {
+        GLint available = 0;
+        glGetQueryObjectiv(timerQueries[previousQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(timerQueries[previousQuery], GL_QUERY_RESULT, &elapsed);
+            gpuDrawMs = glm::mix(gpuDrawMs, static_cast<float>(elapsed) * 1e-6f, 0.1f);
+            timerQueryIssued[previousQuery] = false;
+        }
+    }
+
     // Bind texture and draw mesh
     // Binding doesn't upload data, it selects which already-uploaded data to use
     texture.bind();    // Make this texture active for rendering, bind to GL_TEXTURE0 (default)
     mesh.bind();       // Make this mesh's vertex data active
-    glDrawElements(GL_TRIANGLES, mesh.getIndexCount(), GL_UNSIGNED_INT, 0);
+    const bool timeDraw = timerQueries[query] && !timerQueryIssued[query];
+    if (timeDraw) {
+        glBeginQuery(GL_TIME_ELAPSED, timerQueries[query]);
+    }
+    if (!mesh.getMeshlets().empty() && (frustumCulling || coneCulling)) {
+        // Culling runs in model space, which the uniform model scale keeps angle preserving
+        cullMeshlets(mesh, projection * view * model, glm::vec3(glm::inverse(model) * glm::vec4(cameraPos, 1.0f)));
+        if (!drawCounts.empty()) {
+            glMultiDrawElements(GL_TRIANGLES, drawCounts.data(), GL_UNSIGNED_INT, drawOffsets.data(),
+                                static_cast<GLsizei>(drawCounts.size()));
+        }
+    } else {
+        glDrawElements(GL_TRIANGLES, mesh.getIndexCount(), GL_UNSIGNED_INT, 0);
+        visibleMeshlets = mesh.getMeshlets().size();
+        drawnTriangles = mesh.getIndexCount() / 3;
+        drawCounts.assign(1, static_cast<GLsizei>(mesh.getIndexCount()));
+        drawOffsets.assign(1, nullptr);
+    }
+    if (timeDraw) {
+        glEndQuery(GL_TIME_ELAPSED);
+        timerQueryIssued[query] = true;
+    }
+    frameIndex++;
 
     // Render UI
     if (showUI) {
-        renderUI();
+        renderUI(mesh);
     }
 
+    auto frameEnd = std::chrono::high_resolution_clock::now();
+    cpuFrameMs = glm::mix(cpuFrameMs, std::chrono::duration<float, std::milli>(frameEnd - frameStart).count(), 0.1f);
+
     // Swap buffers and poll events
     glfwSwapBuffers(window);
     glfwPollEvents();
@@ -241,6 +387,11 @@ void Renderer::render(const Mesh& mesh, const Shader& shader, const Texture& tex
 
 void Renderer::cleanup() {
     if (window) {
+        if (timerQueries[0]) {
+            glDeleteQueries(2, timerQueries);
+            timerQueries[0] = timerQueries[1] = 0;
+        }
+
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
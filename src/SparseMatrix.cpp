@@ -0,0 +1,228 @@
+#include "SparseMatrix.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Rows or vector elements per parallel task
+const size_t kGrainSize = 1 << 12;
+
+size_t taskCountFor(size_t count) {
+    return (count + kGrainSize - 1) / kGrainSize;
+}
+
+double sumPartials(const std::vector<double>& partials, size_t stride, size_t component) {
+    double sum = 0.0;
+    for (size_t task = 0; task * stride < partials.size(); task++) {
+        sum += partials[task * stride + component];
+    }
+    return sum;
+}
+
+/**
+ * q = A p and returns p . q, in one pass over the matrix.
+ */
+double multiplyAndDot(const SparseMatrix& matrix, const double* p, double* q, std::vector<double>& partials) {
+    partials.assign(taskCountFor(matrix.rows), 0.0);
+    ThreadPool::global().parallelFor(matrix.rows, kGrainSize, [&](size_t begin, size_t end) {
+        double dot = 0.0;
+        for (size_t row = begin; row < end; row++) {
+            double sum = 0.0;
+            for (size_t k = matrix.rowOffsets[row]; k < matrix.rowOffsets[row + 1]; k++) {
+                sum += matrix.values[k] * p[matrix.columnIndices[k]];
+            }
+            q[row] = sum;
+            dot += p[row] * sum;
+        }
+        partials[begin / kGrainSize] = dot;
+    });
+    return sumPartials(partials, 1, 0);
+}
+
+} // namespace
+
+void SparseMatrix::multiply(const double* x, double* y) const {
+    ThreadPool::global().parallelFor(rows, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++) {
+            double sum = 0.0;
+            for (size_t k = rowOffsets[row]; k < rowOffsets[row + 1]; k++) {
+                sum += values[k] * x[columnIndices[k]];
+            }
+            y[row] = sum;
+        }
+    });
+}
+
+void SparseMatrix::diagonal(std::vector<double>& diagonal) const {
+    diagonal.assign(std::min(rows, columns), 0.0);
+    ThreadPool::global().parallelFor(diagonal.size(), kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++) {
+            const uint32_t* first = columnIndices.data() + rowOffsets[row];
+            const uint32_t* last = columnIndices.data() + rowOffsets[row + 1];
+            const uint32_t* entry = std::lower_bound(first, last, static_cast<uint32_t>(row));
+            if (entry != last && *entry == row) {
+                diagonal[row] = values[entry - columnIndices.data()];
+            }
+        }
+    });
+}
+
+SparseMatrix SparseMatrix::blockPattern(const std::vector<size_t>& neighborOffsets,
+                                        const std::vector<unsigned int>& neighbors, unsigned int blockSize) {
+    const size_t nodeTotal = neighborOffsets.empty() ? 0 : neighborOffsets.size() - 1;
+    const size_t b = blockSize;
+    SparseMatrix matrix;
+    matrix.rows = matrix.columns = b * nodeTotal;
+    matrix.rowOffsets.resize(matrix.rows + 1);
+    matrix.columnIndices.resize(b * b * neighbors.size());
+    matrix.values.assign(b * b * neighbors.size(), 0.0);
+    ThreadPool::global().parallelFor(nodeTotal, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t node = begin; node < end; node++) {
+            const size_t first = neighborOffsets[node];
+            const size_t degree = neighborOffsets[node + 1] - first;
+            for (size_t r = 0; r < b; r++) {
+                const size_t row = b * b * first + r * b * degree;
+                matrix.rowOffsets[b * node + r] = row;
+                for (size_t k = 0; k < degree; k++) {
+                    for (size_t c = 0; c < b; c++) {
+                        matrix.columnIndices[row + b * k + c] = static_cast<uint32_t>(b * neighbors[first + k] + c);
+                    }
+                }
+            }
+        }
+    });
+    matrix.rowOffsets[matrix.rows] = matrix.values.size();
+    return matrix;
+}
+
+SolverReport SparseSolver::conjugateGradient(const SparseMatrix& matrix, const std::vector<double>& rhs,
+                                             std::vector<double>& solution, double tolerance,
+                                             unsigned int maxIterations, const Preconditioner* preconditioner) {
+    SolverReport report;
+    const size_t n = matrix.rows;
+    if (solution.size() != n) {
+        solution.assign(n, 0.0);
+    }
+    if (n == 0) {
+        report.converged = true;
+        return report;
+    }
+
+    ThreadPool& pool = ThreadPool::global();
+    std::vector<double> partials;
+
+    // Jacobi preconditioner unless another one is given; rows without a
+    // diagonal are never updated
+    std::vector<double> inverseDiagonal;
+    if (!preconditioner) {
+        matrix.diagonal(inverseDiagonal);
+        for (double& d : inverseDiagonal) {
+            d = d > 0.0 ? 1.0 / d : 0.0;
+        }
+    }
+
+    // z = M^-1 r and returns r . z; the Jacobi case is fused into the residual
+    // update, so this only runs for an explicit preconditioner
+    std::vector<double> r(n), z(n), p(n), q(n);
+    auto precondition = [&]() {
+        preconditioner->apply(r.data(), z.data());
+        partials.assign(taskCountFor(n), 0.0);
+        pool.parallelFor(n, kGrainSize, [&](size_t begin, size_t end) {
+            double rz = 0.0;
+            for (size_t i = begin; i < end; i++) {
+                rz += r[i] * z[i];
+            }
+            partials[begin / kGrainSize] = rz;
+        });
+        return sumPartials(partials, 1, 0);
+    };
+
+    // r = b - A x, z = M^-1 r, p = z
+    matrix.multiply(solution.data(), q.data());
+    partials.assign(taskCountFor(n) * 3, 0.0);
+    pool.parallelFor(n, kGrainSize, [&](size_t begin, size_t end) {
+        double rz = 0.0, rr = 0.0, bb = 0.0;
+        for (size_t i = begin; i < end; i++) {
+            r[i] = rhs[i] - q[i];
+            if (!preconditioner) {
+                z[i] = inverseDiagonal[i] * r[i];
+                rz += r[i] * z[i];
+            }
+            rr += r[i] * r[i];
+            bb += rhs[i] * rhs[i];
+        }
+        double* partial = &partials[(begin / kGrainSize) * 3];
+        partial[0] = rz;
+        partial[1] = rr;
+        partial[2] = bb;
+    });
+    double rz = sumPartials(partials, 3, 0);
+    double rr = sumPartials(partials, 3, 1);
+    const double rhsNorm = std::sqrt(sumPartials(partials, 3, 2));
+    if (rhsNorm == 0.0) {
+        // The minimum-norm answer to A x = 0
+        std::fill(solution.begin(), solution.end(), 0.0);
+        report.converged = true;
+        return report;
+    }
+    const double threshold = tolerance * rhsNorm;
+    if (preconditioner && std::sqrt(rr) > threshold) {
+        rz = precondition();
+    }
+    std::copy(z.begin(), z.end(), p.begin());
+
+    while (true) {
+        report.relativeResidual = std::sqrt(rr) / rhsNorm;
+        if (std::sqrt(rr) <= threshold) {
+            report.converged = true;
+            break;
+        }
+        if (report.iterations >= maxIterations) {
+            break;
+        }
+
+        double pq = multiplyAndDot(matrix, p.data(), q.data(), partials);
+        if (!(pq > 0.0)) {
+            // Search direction in the null space (or numerical breakdown)
+            break;
+        }
+        const double alpha = rz / pq;
+
+        // x += alpha p, r -= alpha q (and z = M^-1 r for Jacobi)
+        partials.assign(taskCountFor(n) * 2, 0.0);
+        pool.parallelFor(n, kGrainSize, [&](size_t begin, size_t end) {
+            double rzNext = 0.0, rrNext = 0.0;
+            for (size_t i = begin; i < end; i++) {
+                solution[i] += alpha * p[i];
+                r[i] -= alpha * q[i];
+                if (!preconditioner) {
+                    z[i] = inverseDiagonal[i] * r[i];
+                    rzNext += r[i] * z[i];
+                }
+                rrNext += r[i] * r[i];
+            }
+            double* partial = &partials[(begin / kGrainSize) * 2];
+            partial[0] = rzNext;
+            partial[1] = rrNext;
+        });
+        double rzNext = sumPartials(partials, 2, 0);
+        rr = sumPartials(partials, 2, 1);
+        report.iterations++;
+        if (std::sqrt(rr) <= threshold) {
+            continue;
+        }
+        if (preconditioner) {
+            rzNext = precondition();
+        }
+        const double beta = rzNext / rz;
+        rz = rzNext;
+
+        pool.parallelFor(n, kGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                p[i] = z[i] + beta * p[i];
+            }
+        });
+    }
+    return report;
+}
@@ -0,0 +1,320 @@
+#include "TangentGenerator.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+// Items per parallel task
+const size_t kGrainSize = 1 << 16;
+
+// Corners are partitioned into this many contiguous vertex ranges
+const size_t kRangeCount = 256;
+
+// Triangle flags, named after their MikkTSpace counterparts
+const uint8_t kOrientPreserving = 1;  ///< Positive UV area
+const uint8_t kGroupWithAny = 2;  ///< No usable UV derivatives, joins any group
+const uint8_t kDegenerate = 4;  ///< No area, takes the tangent of its vertices
+
+const unsigned int kUnassigned = 0xFFFFFFFFu;
+
+/**
+ * Corners of one vertex connected through shared edges with the same orientation.
+ */
+struct TangentGroup {
+    bool orientPreserving;
+    glm::vec3 sum;  ///< Projected UV derivative directions weighted by corner angle
+    glm::vec4 tangent;  ///< Resolved tangent and bitangent sign
+    unsigned int target;  ///< Vertex the corners move to, or the local split index for duplicates
+    bool duplicate;
+};
+
+/**
+ * Vertices one range duplicates, numbered locally until the ranges are concatenated.
+ */
+struct RangeSplits {
+    std::vector<unsigned int> sources;  ///< Original vertex of every duplicate
+    std::vector<glm::vec4> tangents;  ///< Tangent of every duplicate
+    std::vector<std::pair<unsigned int, unsigned int>> corners;  ///< Corner and local duplicate it moves to
+};
+
+/**
+ * First vertex of range r: ranges hold the vertices v with v * kRangeCount / vertexCount == r.
+ */
+size_t rangeStart(size_t r, size_t vertexCount) {
+    return (r * vertexCount + kRangeCount - 1) / kRangeCount;
+}
+
+size_t rangeOf(unsigned int vertex, size_t vertexCount) {
+    return static_cast<size_t>(static_cast<uint64_t>(vertex) * kRangeCount / vertexCount);
+}
+
+bool notZero(float value) {
+    return std::fabs(value) > FLT_MIN;
+}
+
+glm::vec3 normalizeNotZero(const glm::vec3& v) {
+    const float length = glm::length(v);
+    return notZero(length) ? v / length : v;
+}
+
+/**
+ * Some unit vector perpendicular to n, for vertices no triangle gives a direction.
+ */
+glm::vec3 anyPerpendicular(const glm::vec3& n) {
+    const glm::vec3 axis = std::fabs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::vec3 t = glm::cross(n, axis);
+    const float length = glm::length(t);
+    return length > 0.0f ? t / length : glm::vec3(1.0f, 0.0f, 0.0f);
+}
+
+} // namespace
+
+TangentReport TangentGenerator::generate(const PositionArray& positions, const std::vector<glm::vec3>& normals,
+                                         const std::vector<glm::vec2>& uvs, std::vector<unsigned int>& indices,
+                                         std::vector<glm::vec4>& tangents, std::vector<unsigned int>& sourceVertices) {
+    auto generateStart = std::chrono::high_resolution_clock::now();
+    TangentReport report;
+    ThreadPool& pool = ThreadPool::global();
+    const size_t vertexTotal = positions.size();
+    const size_t triangleTotal = indices.size() / 3;
+    const size_t cornerTotal = triangleTotal * 3;
+    tangents.assign(vertexTotal, glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    sourceVertices.clear();
+    report.triangles = triangleTotal;
+    if (triangleTotal == 0 || normals.size() != vertexTotal || uvs.size() != vertexTotal) {
+        return report;
+    }
+
+    // UV derivative direction (normalized, signed by orientation) and flags of every triangle
+    std::vector<glm::vec3> directions(triangleTotal);
+    std::vector<uint8_t> flags(triangleTotal);
+    const size_t chunkCount = (triangleTotal + kGrainSize - 1) / kGrainSize;
+    std::vector<size_t> chunkDegenerate(chunkCount, 0), chunkTextureDegenerate(chunkCount, 0);
+    pool.parallelFor(triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+        size_t degenerate = 0, textureDegenerate = 0;
+        for (size_t t = begin; t < end; t++) {
+            const unsigned int i0 = indices[3 * t], i1 = indices[3 * t + 1], i2 = indices[3 * t + 2];
+            const glm::vec3 p0 = positions[i0], p1 = positions[i1], p2 = positions[i2];
+            const glm::vec2 t21 = uvs[i1] - uvs[i0], t31 = uvs[i2] - uvs[i0];
+            const glm::vec3 d1 = p1 - p0, d2 = p2 - p0;
+            const float signedArea = t21.x * t31.y - t21.y * t31.x;
+            glm::vec3 os = t31.y * d1 - t21.y * d2;
+            const glm::vec3 ot = -t31.x * d1 + t21.x * d2;
+
+            uint8_t flag = kGroupWithAny | (signedArea > 0.0f ? kOrientPreserving : 0);
+            if (notZero(signedArea)) {
+                const float absArea = std::fabs(signedArea);
+                const float lengthOs = glm::length(os), lengthOt = glm::length(ot);
+                const float sign = signedArea > 0.0f ? 1.0f : -1.0f;
+                if (notZero(lengthOs)) {
+                    os *= sign / lengthOs;
+                }
+                if (notZero(lengthOs / absArea) && notZero(lengthOt / absArea)) {
+                    flag &= ~kGroupWithAny;
+                }
+            }
+            if (p0 == p1 || p1 == p2 || p0 == p2) {
+                flag |= kDegenerate;
+                degenerate++;
+            } else if (flag & kGroupWithAny) {
+                textureDegenerate++;
+            }
+            directions[t] = os;
+            flags[t] = flag;
+        }
+        chunkDegenerate[begin / kGrainSize] = degenerate;
+        chunkTextureDegenerate[begin / kGrainSize] = textureDegenerate;
+    });
+    for (size_t c = 0; c < chunkCount; c++) {
+        report.degenerateTriangles += chunkDegenerate[c];
+        report.textureDegenerateTriangles += chunkTextureDegenerate[c];
+    }
+
+    // Stable partition of the corners into vertex ranges, range-major like MeshTopology's buckets
+    const size_t cornerChunks = (cornerTotal + kGrainSize - 1) / kGrainSize;
+    std::vector<size_t> cursors(cornerChunks * kRangeCount, 0);
+    pool.parallelFor(cornerTotal, kGrainSize, [&](size_t begin, size_t end) {
+        size_t* counts = &cursors[begin / kGrainSize * kRangeCount];
+        for (size_t c = begin; c < end; c++) {
+            counts[rangeOf(indices[c], vertexTotal)]++;
+        }
+    });
+    std::vector<size_t> rangeOffsets(kRangeCount + 1, 0);
+    size_t running = 0;
+    for (size_t r = 0; r < kRangeCount; r++) {
+        rangeOffsets[r] = running;
+        for (size_t c = 0; c < cornerChunks; c++) {
+            const size_t chunkItems = cursors[c * kRangeCount + r];
+            cursors[c * kRangeCount + r] = running;
+            running += chunkItems;
+        }
+    }
+    rangeOffsets[kRangeCount] = running;
+    std::vector<unsigned int> rangeCorners(cornerTotal);
+    pool.parallelFor(cornerTotal, kGrainSize, [&](size_t begin, size_t end) {
+        size_t* cursor = &cursors[begin / kGrainSize * kRangeCount];
+        for (size_t c = begin; c < end; c++) {
+            rangeCorners[cursor[rangeOf(indices[c], vertexTotal)]++] = static_cast<unsigned int>(c);
+        }
+    });
+    cursors = std::vector<size_t>();
+
+    // Resolve every vertex of a range: group its corners, evaluate the groups, give every group a vertex
+    std::vector<RangeSplits> splits(kRangeCount);
+    pool.run(kRangeCount, [&](size_t r) {
+        const size_t firstVertex = rangeStart(r, vertexTotal);
+        const size_t vertexSpan = rangeStart(r + 1, vertexTotal) - firstVertex;
+        const size_t first = rangeOffsets[r], count = rangeOffsets[r + 1] - first;
+
+        // Counting sort by vertex inside the range, keeping corner order
+        std::vector<unsigned int> vertexStart(vertexSpan + 1, 0);
+        for (size_t k = first; k < first + count; k++) {
+            vertexStart[indices[rangeCorners[k]] - firstVertex + 1]++;
+        }
+        for (size_t v = 0; v < vertexSpan; v++) {
+            vertexStart[v + 1] += vertexStart[v];
+        }
+        std::vector<unsigned int> sorted(count);
+        {
+            std::vector<unsigned int> cursor(vertexStart.begin(), vertexStart.end() - 1);
+            for (size_t k = first; k < first + count; k++) {
+                const unsigned int c = rangeCorners[k];
+                sorted[cursor[indices[c] - firstVertex]++] = c;
+            }
+        }
+
+        RangeSplits& rangeSplits = splits[r];
+        std::vector<TangentGroup> groups;
+        std::vector<unsigned int> cornerGroups, stack;
+        for (size_t local = 0; local < vertexSpan; local++) {
+            const unsigned int v = static_cast<unsigned int>(firstVertex + local);
+            const unsigned int* corners = sorted.data() + vertexStart[local];
+            const size_t cornerCount = vertexStart[local + 1] - vertexStart[local];
+            if (cornerCount == 0) {
+                continue;
+            }
+            auto previousOf = [&](unsigned int c) { return indices[c - c % 3 + (c % 3 + 2) % 3]; };
+            auto nextOf = [&](unsigned int c) { return indices[c - c % 3 + (c % 3 + 1) % 3]; };
+
+            // Grow groups across shared edges in triangle order, like Build4RuleGroups
+            groups.clear();
+            cornerGroups.assign(cornerCount, kUnassigned);
+            for (size_t k = 0; k < cornerCount; k++) {
+                if (cornerGroups[k] != kUnassigned || (flags[corners[k] / 3] & kDegenerate)) {
+                    continue;
+                }
+                const unsigned int g = static_cast<unsigned int>(groups.size());
+                const bool orient = (flags[corners[k] / 3] & kOrientPreserving) != 0;
+                groups.push_back(TangentGroup{ orient, glm::vec3(0.0f), glm::vec4(0.0f), v, false });
+                cornerGroups[k] = g;
+                stack.assign(1, static_cast<unsigned int>(k));
+                while (!stack.empty()) {
+                    const unsigned int x = stack.back();
+                    stack.pop_back();
+                    const unsigned int previousX = previousOf(corners[x]), nextX = nextOf(corners[x]);
+                    for (size_t y = 0; y < cornerCount; y++) {
+                        const uint8_t flag = flags[corners[y] / 3];
+                        if (cornerGroups[y] != kUnassigned || (flag & kDegenerate)) {
+                            continue;
+                        }
+                        // Neighbours share an edge with opposite winding
+                        if (previousOf(corners[y]) != nextX && nextOf(corners[y]) != previousX) {
+                            continue;
+                        }
+                        const bool orientY = (flag & kGroupWithAny) ? orient : (flag & kOrientPreserving) != 0;
+                        if (orientY != orient) {
+                            continue;
+                        }
+                        cornerGroups[y] = g;
+                        stack.push_back(static_cast<unsigned int>(y));
+                    }
+                }
+            }
+
+            // Angle weighted sum of the directions projected onto the normal plane, like EvalTspace
+            const glm::vec3 n = normals[v];
+            const glm::vec3 p = positions[v];
+            for (size_t k = 0; k < cornerCount; k++) {
+                const unsigned int c = corners[k], t = c / 3;
+                if (cornerGroups[k] == kUnassigned || (flags[t] & kGroupWithAny)) {
+                    continue;
+                }
+                const glm::vec3 os = normalizeNotZero(directions[t] - glm::dot(n, directions[t]) * n);
+                glm::vec3 e1 = positions[previousOf(c)] - p, e2 = positions[nextOf(c)] - p;
+                e1 = normalizeNotZero(e1 - glm::dot(n, e1) * n);
+                e2 = normalizeNotZero(e2 - glm::dot(n, e2) * n);
+                const float angle = std::acos(glm::clamp(glm::dot(e1, e2), -1.0f, 1.0f));
+                groups[cornerGroups[k]].sum += angle * os;
+            }
+
+            // Degenerate triangles take the tangent of the first group around the vertex
+            for (size_t k = 0; k < cornerCount; k++) {
+                if (cornerGroups[k] != kUnassigned) {
+                    continue;
+                }
+                if (groups.empty()) {
+                    groups.push_back(TangentGroup{ true, glm::vec3(0.0f), glm::vec4(0.0f), v, false });
+                }
+                cornerGroups[k] = 0;
+            }
+
+            // The first group keeps the vertex; later ones reuse an identical frame or get a duplicate
+            for (size_t g = 0; g < groups.size(); g++) {
+                TangentGroup& group = groups[g];
+                const float length = glm::length(group.sum);
+                const glm::vec3 direction = notZero(length) ? group.sum / length : anyPerpendicular(n);
+                group.tangent = glm::vec4(direction, group.orientPreserving ? 1.0f : -1.0f);
+                if (g == 0) {
+                    tangents[v] = group.tangent;
+                    continue;
+                }
+                size_t same = 0;
+                while (same < g && groups[same].tangent != group.tangent) {
+                    same++;
+                }
+                if (same < g) {
+                    group.target = groups[same].target;
+                    group.duplicate = groups[same].duplicate;
+                } else {
+                    group.target = static_cast<unsigned int>(rangeSplits.sources.size());
+                    group.duplicate = true;
+                    rangeSplits.sources.push_back(v);
+                    rangeSplits.tangents.push_back(group.tangent);
+                }
+            }
+            for (size_t k = 0; k < cornerCount; k++) {
+                const TangentGroup& group = groups[cornerGroups[k]];
+                if (group.duplicate) {
+                    rangeSplits.corners.emplace_back(corners[k], group.target);
+                }
+            }
+        }
+    });
+    rangeCorners = std::vector<unsigned int>();
+
+    // Append the duplicates range by range and move their corners
+    std::vector<size_t> splitBase(kRangeCount + 1, 0);
+    for (size_t r = 0; r < kRangeCount; r++) {
+        splitBase[r + 1] = splitBase[r] + splits[r].sources.size();
+    }
+    report.splitVertices = splitBase[kRangeCount];
+    tangents.resize(vertexTotal + report.splitVertices);
+    sourceVertices.resize(report.splitVertices);
+    pool.run(kRangeCount, [&](size_t r) {
+        const RangeSplits& rangeSplits = splits[r];
+        const size_t base = splitBase[r];
+        std::copy(rangeSplits.sources.begin(), rangeSplits.sources.end(), sourceVertices.begin() + base);
+        std::copy(rangeSplits.tangents.begin(), rangeSplits.tangents.end(), tangents.begin() + vertexTotal + base);
+        for (const std::pair<unsigned int, unsigned int>& corner : rangeSplits.corners) {
+            indices[corner.first] = static_cast<unsigned int>(vertexTotal + base + corner.second);
+        }
+    });
+
+    report.generateMs =
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - generateStart).count();
+    return report;
+}
@@ -0,0 +1,63 @@
+#include "TexelDensity.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+/**
+ * Areas of one chart, in double so long thin charts keep their precision.
+ */
+struct ChartAreas {
+    double surface = 0.0;
+    double texture = 0.0;
+};
+
+} // namespace
+
+TexelDensityReport TexelDensity::equalize(std::vector<UVChart>& charts) {
+    auto equalizeStart = std::chrono::high_resolution_clock::now();
+    TexelDensityReport report;
+    std::vector<ChartAreas> areas(charts.size());
+    ThreadPool::global().run(charts.size(), [&](size_t c) {
+        UVChart& chart = charts[c];
+        ChartAreas& area = areas[c];
+        glm::dvec2 centroid(0.0);
+        for (size_t t = 0; t < chart.triangleCount(); t++) {
+            const unsigned int i0 = chart.indices[3 * t], i1 = chart.indices[3 * t + 1], i2 = chart.indices[3 * t + 2];
+            area.surface += 0.5 * static_cast<double>(glm::length(
+                glm::cross(chart.positions[i1] - chart.positions[i0], chart.positions[i2] - chart.positions[i0])));
+            const glm::vec2 e1 = chart.uvs[i1] - chart.uvs[i0], e2 = chart.uvs[i2] - chart.uvs[i0];
+            const double textureArea = 0.5 * std::abs(static_cast<double>(e1.x) * e2.y - static_cast<double>(e1.y) * e2.x);
+            area.texture += textureArea;
+            centroid += glm::dvec2(chart.uvs[i0] + chart.uvs[i1] + chart.uvs[i2]) * (textureArea / 3.0);
+        }
+        if (!(area.surface > 0.0) || !(area.texture > 0.0) || !std::isfinite(area.surface / area.texture)) {
+            return;
+        }
+        const glm::vec2 center(centroid * (1.0 / area.texture));
+        const float scale = static_cast<float>(std::sqrt(area.surface / area.texture));
+        for (glm::vec2& uv : chart.uvs) {
+            uv = center + (uv - center) * scale;
+        }
+    });
+
+    // Densities as texture length per surface length
+    double densityMin = 0.0, densityMax = 0.0;
+    for (const ChartAreas& area : areas) {
+        report.surfaceArea += area.surface;
+        if (!(area.surface > 0.0) || !(area.texture > 0.0) || !std::isfinite(area.surface / area.texture)) {
+            report.degenerateCharts++;
+            continue;
+        }
+        const double density = std::sqrt(area.texture / area.surface);
+        densityMin = report.charts == 0 ? density : std::min(densityMin, density);
+        densityMax = report.charts == 0 ? density : std::max(densityMax, density);
+        report.charts++;
+    }
+    report.spreadBefore = report.charts > 0 ? densityMax / densityMin : 1.0;
+    report.equalizeMs =
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - equalizeStart).count();
+    return report;
+}
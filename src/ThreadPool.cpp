@@ -0,0 +1,104 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+// Set while the current thread executes a pool task
+thread_local bool insideTask = false;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : currentTask(nullptr), taskCount(0), nextTask(0), pendingTasks(0), jobGeneration(0), stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(threadCount - 1);
+    for (unsigned int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    // Serial fallback for single tasks, single-threaded pools and nested calls
+    if (count == 1 || workers.empty() || insideTask) {
+        for (size_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(submitMutex);
+    std::unique_lock<std::mutex> lock(mutex);
+    currentTask = &task;
+    taskCount = count;
+    nextTask = 0;
+    pendingTasks = count;
+    jobGeneration++;
+    jobAvailable.notify_all();
+
+    drainTasks(lock);
+    jobFinished.wait(lock, [this] { return pendingTasks == 0; });
+    currentTask = nullptr;
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = std::max<size_t>(grainSize, 1);
+    size_t rangeCount = (count + grainSize - 1) / grainSize;
+    run(rangeCount, [&](size_t range) {
+        size_t begin = range * grainSize;
+        size_t end = std::min(count, begin + grainSize);
+        body(begin, end);
+    });
+}
+
+void ThreadPool::workerLoop() {
+    size_t seenGeneration = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        jobAvailable.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+        if (stopping) {
+            return;
+        }
+        seenGeneration = jobGeneration;
+        drainTasks(lock);
+    }
+}
+
+void ThreadPool::drainTasks(std::unique_lock<std::mutex>& lock) {
+    while (currentTask && nextTask < taskCount) {
+        size_t index = nextTask++;
+        const std::function<void(size_t)>* task = currentTask;
+
+        lock.unlock();
+        insideTask = true;
+        (*task)(index);
+        insideTask = false;
+        lock.lock();
+
+        if (--pendingTasks == 0) {
+            jobFinished.notify_all();
+        }
+    }
+}
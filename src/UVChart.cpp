@@ -0,0 +1,111 @@
+#include "UVChart.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+
+// Vertices per parallel task
+const size_t kGrainSize = 1 << 12;
+
+} // namespace
+
+void UVChart::vertexCorners(std::vector<size_t>& offsets, std::vector<unsigned int>& corners) const {
+    const size_t vertexTotal = vertexCount();
+    offsets.assign(vertexTotal + 1, 0);
+    for (unsigned int v : indices) {
+        offsets[v + 1]++;
+    }
+    for (size_t v = 0; v < vertexTotal; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    corners.resize(indices.size());
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t corner = 0; corner < indices.size(); corner++) {
+        corners[cursor[indices[corner]]++] = static_cast<unsigned int>(corner);
+    }
+}
+
+void UVChart::vertexNeighbors(const std::vector<size_t>& cornerOffsets, const std::vector<unsigned int>& corners,
+                              std::vector<size_t>& offsets, std::vector<unsigned int>& neighbors) const {
+    const size_t vertexTotal = vertexCount();
+    ThreadPool& pool = ThreadPool::global();
+
+    // Gathers the sorted unique vertices of the triangles around v
+    auto gather = [&](size_t v, std::vector<unsigned int>& list) {
+        list.clear();
+        for (size_t k = cornerOffsets[v]; k < cornerOffsets[v + 1]; k++) {
+            const size_t t = corners[k] / 3;
+            list.insert(list.end(), indices.begin() + 3 * t, indices.begin() + 3 * t + 3);
+        }
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    };
+
+    // Count, then fill: the lists are gathered twice instead of being stored
+    offsets.assign(vertexTotal + 1, 0);
+    pool.parallelFor(vertexTotal, kGrainSize, [&](size_t begin, size_t end) {
+        std::vector<unsigned int> list;
+        for (size_t v = begin; v < end; v++) {
+            gather(v, list);
+            offsets[v + 1] = list.size();
+        }
+    });
+    for (size_t v = 0; v < vertexTotal; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    neighbors.resize(offsets[vertexTotal]);
+    pool.parallelFor(vertexTotal, kGrainSize, [&](size_t begin, size_t end) {
+        std::vector<unsigned int> list;
+        for (size_t v = begin; v < end; v++) {
+            gather(v, list);
+            std::copy(list.begin(), list.end(), neighbors.begin() + offsets[v]);
+        }
+    });
+}
+
+std::vector<UVChart> UVChart::fromSegmentation(const PositionArray& positions,
+                                               const std::vector<unsigned int>& indices,
+                                               const std::vector<unsigned int>& chartOfFace, size_t chartCount) {
+    const size_t triangleTotal = indices.size() / 3;
+
+    // Bucket the triangles by chart, keeping mesh order inside each bucket
+    std::vector<size_t> chartOffsets(chartCount + 1, 0);
+    for (size_t t = 0; t < triangleTotal; t++) {
+        chartOffsets[chartOfFace[t] + 1]++;
+    }
+    for (size_t chart = 0; chart < chartCount; chart++) {
+        chartOffsets[chart + 1] += chartOffsets[chart];
+    }
+    std::vector<unsigned int> chartTriangles(triangleTotal);
+    {
+        std::vector<size_t> cursor(chartOffsets.begin(), chartOffsets.end() - 1);
+        for (size_t t = 0; t < triangleTotal; t++) {
+            chartTriangles[cursor[chartOfFace[t]]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    // Seam vertices belong to several charts, so every chart numbers its
+    // vertices on its own: sorted mesh indices, looked up by binary search
+    std::vector<UVChart> charts(chartCount);
+    ThreadPool::global().run(chartCount, [&](size_t c) {
+        UVChart& chart = charts[c];
+        chart.faces.assign(chartTriangles.begin() + chartOffsets[c], chartTriangles.begin() + chartOffsets[c + 1]);
+        chart.indices.resize(chart.faces.size() * 3);
+        for (size_t k = 0; k < chart.faces.size(); k++) {
+            std::copy(indices.begin() + 3 * chart.faces[k], indices.begin() + 3 * chart.faces[k] + 3,
+                      chart.indices.begin() + 3 * k);
+        }
+        chart.vertices = chart.indices;
+        std::sort(chart.vertices.begin(), chart.vertices.end());
+        chart.vertices.erase(std::unique(chart.vertices.begin(), chart.vertices.end()), chart.vertices.end());
+        for (unsigned int& index : chart.indices) {
+            index = static_cast<unsigned int>(std::lower_bound(chart.vertices.begin(), chart.vertices.end(), index) -
+                                              chart.vertices.begin());
+        }
+        chart.positions.resize(chart.vertices.size());
+        for (size_t i = 0; i < chart.vertices.size(); i++) {
+            chart.positions[i] = positions[chart.vertices[i]];
+        }
+    });
+    return charts;
+}
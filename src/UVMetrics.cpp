@@ -0,0 +1,288 @@
+#include "UVMetrics.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+// Triangles per parallel task
+const size_t kGrainSize = 1 << 14;
+
+const double kRadiansToDegrees = 180.0 / 3.14159265358979323846;
+
+/**
+ * Sums of one task of the distortion pass.
+ */
+struct TaskSums {
+    size_t triangles = 0, collapsed = 0, flipped = 0;
+    double stretchSquared = 0.0, stretchLinf = 0.0;
+    double angleSum = 0.0, angleMax = 0.0, corners = 0.0;
+    double areaDistortion = 0.0, density = 0.0, densitySquared = 0.0, surfaceArea = 0.0;
+};
+
+/**
+ * Interior angles of a triangle from its edge vectors.
+ */
+template <typename Vector, typename Cross>
+void cornerAngles(const Vector* p, Cross crossLength, double* angles) {
+    for (int k = 0; k < 3; k++) {
+        const Vector a = p[(k + 1) % 3] - p[k];
+        const Vector b = p[(k + 2) % 3] - p[k];
+        angles[k] = std::atan2(static_cast<double>(crossLength(a, b)), static_cast<double>(glm::dot(a, b)));
+    }
+}
+
+/**
+ * Edge a -> b of a counter-clockwise triangle owns the texel centers on it
+ * if it is a top or left edge, so triangles sharing an edge never both do.
+ */
+bool isTopLeft(const glm::vec2& a, const glm::vec2& b) {
+    const glm::vec2 d = b - a;
+    return d.y < 0.0f || (d.y == 0.0f && d.x < 0.0f);
+}
+
+/**
+ * Adds the texel centers a triangle covers to a saturating coverage grid,
+ * wrapping coordinates like GL_REPEAT. Spans are capped at one period.
+ */
+void rasterizeWrapped(glm::vec2 a, glm::vec2 b, glm::vec2 c, unsigned int resolution, unsigned char* grid) {
+    const float scale = static_cast<float>(resolution);
+    a *= scale;
+    b *= scale;
+    c *= scale;
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (area == 0.0f || !std::isfinite(area)) {
+        return;
+    }
+    if (area < 0.0f) {
+        std::swap(b, c);
+    }
+    const glm::vec2 lo = glm::min(a, glm::min(b, c)), hi = glm::max(a, glm::max(b, c));
+    const long x0 = static_cast<long>(std::ceil(lo.x - 0.5f)), y0 = static_cast<long>(std::ceil(lo.y - 0.5f));
+    const long x1 = std::min(static_cast<long>(std::floor(hi.x - 0.5f)), x0 + static_cast<long>(resolution) - 1);
+    const long y1 = std::min(static_cast<long>(std::floor(hi.y - 0.5f)), y0 + static_cast<long>(resolution) - 1);
+    const glm::vec2 corners[3] = { a, b, c };
+    bool topLeft[3];
+    for (int k = 0; k < 3; k++) {
+        topLeft[k] = isTopLeft(corners[k], corners[(k + 1) % 3]);
+    }
+    const long period = static_cast<long>(resolution);
+    for (long y = y0; y <= y1; y++) {
+        unsigned char* row = grid + static_cast<size_t>(((y % period) + period) % period) * resolution;
+        for (long x = x0; x <= x1; x++) {
+            const glm::vec2 center(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f);
+            bool inside = true;
+            for (int k = 0; k < 3 && inside; k++) {
+                const glm::vec2 edge = corners[(k + 1) % 3] - corners[k];
+                const glm::vec2 offset = center - corners[k];
+                const float w = edge.x * offset.y - edge.y * offset.x;
+                inside = w > 0.0f || (w == 0.0f && topLeft[k]);
+            }
+            if (inside) {
+                unsigned char& texel = row[((x % period) + period) % period];
+                texel = texel < 2 ? texel + 1 : 2;
+            }
+        }
+    }
+}
+
+} // namespace
+
+UVMetricsReport UVMetrics::measure(const PositionArray& positions, const std::vector<unsigned int>& indices,
+                                   const std::vector<glm::vec2>& uvs, const UVMetricsOptions& options,
+                                   std::vector<TriangleUVMetrics>* perTriangle) {
+    auto measureStart = std::chrono::high_resolution_clock::now();
+    UVMetricsReport report;
+    const size_t triangleTotal = uvs.size() == positions.size() ? indices.size() / 3 : 0;
+    if (perTriangle) {
+        perTriangle->assign(triangleTotal, TriangleUVMetrics());
+    }
+    if (triangleTotal == 0) {
+        return report;
+    }
+    ThreadPool& pool = ThreadPool::global();
+    const size_t taskCount = (triangleTotal + kGrainSize - 1) / kGrainSize;
+
+    // Total surface and texture areas, and the dominant orientation
+    std::vector<double> areaPartials(taskCount * 3, 0.0);
+    pool.parallelFor(triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+        double surface = 0.0, texture = 0.0, oriented = 0.0;
+        for (size_t t = begin; t < end; t++) {
+            const glm::vec3 p0 = positions[indices[3 * t]];
+            const glm::vec2 q0 = uvs[indices[3 * t]];
+            const glm::vec2 e1 = uvs[indices[3 * t + 1]] - q0, e2 = uvs[indices[3 * t + 2]] - q0;
+            const double signedArea = 0.5 * (static_cast<double>(e1.x) * e2.y - static_cast<double>(e1.y) * e2.x);
+            surface += 0.5 * glm::length(glm::cross(positions[indices[3 * t + 1]] - p0, positions[indices[3 * t + 2]] - p0));
+            texture += std::fabs(signedArea);
+            oriented += signedArea;
+        }
+        double* partial = &areaPartials[(begin / kGrainSize) * 3];
+        partial[0] = surface;
+        partial[1] = texture;
+        partial[2] = oriented;
+    });
+    double surfaceTotal = 0.0, textureTotal = 0.0, orientedTotal = 0.0;
+    for (size_t task = 0; task < taskCount; task++) {
+        surfaceTotal += areaPartials[3 * task];
+        textureTotal += areaPartials[3 * task + 1];
+        orientedTotal += areaPartials[3 * task + 2];
+    }
+    if (!(surfaceTotal > 0.0) || !(textureTotal > 0.0)) {
+        report.collapsedTriangles = triangleTotal;
+        return report;
+    }
+    const double areaScale = textureTotal / surfaceTotal;
+    const double stretchScale = std::sqrt(areaScale);
+    const double orientation = orientedTotal < 0.0 ? -1.0 : 1.0;
+
+    // Per-triangle stretch (singular values of the texture -> surface Jacobian), angles and areas
+    std::vector<TaskSums> sums(taskCount);
+    pool.parallelFor(triangleTotal, kGrainSize, [&](size_t begin, size_t end) {
+        TaskSums& sum = sums[begin / kGrainSize];
+        for (size_t t = begin; t < end; t++) {
+            glm::vec3 p[3];
+            glm::vec2 q[3];
+            for (int k = 0; k < 3; k++) {
+                p[k] = positions[indices[3 * t + k]];
+                q[k] = uvs[indices[3 * t + k]];
+            }
+            const double surface = 0.5 * glm::length(glm::cross(p[1] - p[0], p[2] - p[0]));
+            if (!(surface > 0.0)) {
+                continue;
+            }
+            sum.triangles++;
+            const double signedArea =
+                0.5 * (static_cast<double>(q[1].x - q[0].x) * (q[2].y - q[0].y) -
+                       static_cast<double>(q[1].y - q[0].y) * (q[2].x - q[0].x));
+            if (signedArea == 0.0) {
+                sum.collapsed++;
+                continue;
+            }
+            TriangleUVMetrics metrics;
+            const glm::vec3 ss = (p[0] * (q[1].y - q[2].y) + p[1] * (q[2].y - q[0].y) + p[2] * (q[0].y - q[1].y)) /
+                                 static_cast<float>(2.0 * signedArea);
+            const glm::vec3 st = (p[0] * (q[2].x - q[1].x) + p[1] * (q[0].x - q[2].x) + p[2] * (q[1].x - q[0].x)) /
+                                 static_cast<float>(2.0 * signedArea);
+            const double a = glm::dot(ss, ss), b = glm::dot(ss, st), c = glm::dot(st, st);
+            const double root = std::sqrt((a - c) * (a - c) + 4.0 * b * b);
+            const double l2 = std::sqrt(0.5 * (a + c)) * stretchScale;
+            const double linf = std::sqrt(0.5 * (a + c + root)) * stretchScale;
+            metrics.stretchL2 = static_cast<float>(l2);
+            metrics.stretchLinf = static_cast<float>(linf);
+            sum.stretchSquared += surface * l2 * l2;
+            sum.stretchLinf = std::max(sum.stretchLinf, linf);
+
+            double surfaceAngles[3], textureAngles[3], deviation = 0.0;
+            cornerAngles(p, [](const glm::vec3& u, const glm::vec3& v) { return glm::length(glm::cross(u, v)); },
+                         surfaceAngles);
+            cornerAngles(q, [](const glm::vec2& u, const glm::vec2& v) { return std::fabs(u.x * v.y - u.y * v.x); },
+                         textureAngles);
+            for (int k = 0; k < 3; k++) {
+                const double corner = std::fabs(textureAngles[k] - surfaceAngles[k]) * kRadiansToDegrees;
+                deviation += corner;
+                sum.angleMax = std::max(sum.angleMax, corner);
+            }
+            sum.angleSum += deviation;
+            sum.corners += 3.0;
+            metrics.angleDistortion = static_cast<float>(deviation / 3.0);
+
+            const double ratio = std::fabs(signedArea) / surface / areaScale;
+            const double density = options.resolution * std::sqrt(std::fabs(signedArea) / surface);
+            metrics.areaRatio = static_cast<float>(ratio);
+            sum.areaDistortion += surface * std::max(ratio, 1.0 / ratio);
+            sum.density += surface * density;
+            sum.densitySquared += surface * density * density;
+            sum.surfaceArea += surface;
+
+            metrics.flipped = signedArea * orientation < 0.0;
+            sum.flipped += metrics.flipped ? 1 : 0;
+            if (perTriangle) {
+                (*perTriangle)[t] = metrics;
+            }
+        }
+    });
+
+    TaskSums total;
+    for (const TaskSums& sum : sums) {
+        total.triangles += sum.triangles;
+        total.collapsed += sum.collapsed;
+        total.flipped += sum.flipped;
+        total.stretchSquared += sum.stretchSquared;
+        total.stretchLinf = std::max(total.stretchLinf, sum.stretchLinf);
+        total.angleSum += sum.angleSum;
+        total.angleMax = std::max(total.angleMax, sum.angleMax);
+        total.corners += sum.corners;
+        total.areaDistortion += sum.areaDistortion;
+        total.density += sum.density;
+        total.densitySquared += sum.densitySquared;
+        total.surfaceArea += sum.surfaceArea;
+    }
+    report.triangles = total.triangles;
+    report.collapsedTriangles = total.collapsed;
+    report.flippedTriangles = total.flipped;
+    report.stretchLinf = total.stretchLinf;
+    report.angleDistortionMax = total.angleMax;
+    if (total.surfaceArea > 0.0) {
+        report.stretchL2 = std::sqrt(total.stretchSquared / total.surfaceArea);
+        report.areaDistortion = total.areaDistortion / total.surfaceArea;
+        report.texelDensity = total.density / total.surfaceArea;
+        report.texelDensityDeviation = std::sqrt(
+            std::max(0.0, total.densitySquared / total.surfaceArea - report.texelDensity * report.texelDensity));
+    }
+    report.angleDistortionMean = total.corners > 0.0 ? total.angleSum / total.corners : 0.0;
+
+    // Overlap: coverage counts saturate at 2 and add commutatively, so one
+    // grid per thread gives the same result for any thread count
+    if (options.measureOverlap && options.resolution > 0) {
+        const size_t resolution = options.resolution, texelTotal = resolution * resolution;
+        const size_t gridCount = std::min<size_t>(pool.size(), taskCount);
+        std::vector<std::vector<unsigned char>> grids(gridCount);
+        pool.run(gridCount, [&](size_t g) {
+            grids[g].assign(texelTotal, 0);
+            const size_t first = triangleTotal * g / gridCount, last = triangleTotal * (g + 1) / gridCount;
+            for (size_t t = first; t < last; t++) {
+                rasterizeWrapped(uvs[indices[3 * t]], uvs[indices[3 * t + 1]], uvs[indices[3 * t + 2]],
+                                 options.resolution, grids[g].data());
+            }
+        });
+        std::vector<size_t> rowCounts(resolution * 2, 0);
+        pool.parallelFor(resolution, 16, [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; y++) {
+                size_t covered = 0, overlapped = 0;
+                for (size_t x = y * resolution; x < (y + 1) * resolution; x++) {
+                    unsigned int count = 0;
+                    for (size_t g = 0; g < gridCount; g++) {
+                        count += grids[g][x];
+                    }
+                    covered += count > 0 ? 1 : 0;
+                    overlapped += count > 1 ? 1 : 0;
+                }
+                rowCounts[2 * y] = covered;
+                rowCounts[2 * y + 1] = overlapped;
+            }
+        });
+        size_t covered = 0, overlapped = 0;
+        for (size_t y = 0; y < resolution; y++) {
+            covered += rowCounts[2 * y];
+            overlapped += rowCounts[2 * y + 1];
+        }
+        report.coverage = static_cast<double>(covered) / static_cast<double>(texelTotal);
+        report.overlap = covered > 0 ? static_cast<double>(overlapped) / static_cast<double>(covered) : 0.0;
+    }
+
+    report.measureMs =
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - measureStart).count();
+    return report;
+}
+
+double UVMetrics::score(const UVMetricsReport& report) {
+    if (report.triangles == 0 || !(report.stretchL2 > 0.0)) {
+        return std::numeric_limits<double>::infinity();
+    }
+    const double broken = static_cast<double>(report.flippedTriangles + report.collapsedTriangles) /
+                          static_cast<double>(report.triangles);
+    return report.stretchL2 * (1.0 + report.overlap) * (1.0 + broken);
+}
@@ -0,0 +1,292 @@
+#include "UVOverlap.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// Triangles per parallel task
+const size_t kGrainSize = 1 << 14;
+
+// Grid cells per parallel task
+const size_t kCellGrain = 1 << 10;
+
+// Cells per side at most, 4M cells in total
+const unsigned int kMaxGridSize = 2048;
+
+/**
+ * Texture space bounds of one triangle, moved to the period of its lower
+ * corner when wrapping. Invalid triangles have an empty box.
+ */
+struct TriangleBox {
+    glm::vec2 offset;  // Period the corners were moved by
+    glm::vec2 lo, hi;  // Bounds after the move
+    int32_t x0, x1, y0, y1;  // Covered cells, unwrapped
+    bool valid;
+};
+
+/**
+ * One copy of a triangle in a cell list: the periods it is moved back by to
+ * land on the cell. A triangle crossing a period boundary can cover a cell
+ * twice with different shifts.
+ */
+struct CellEntry {
+    uint32_t triangle;
+    uint16_t shiftX, shiftY;
+};
+
+/**
+ * A triangle as seen from one cell: corners in the cell's period and its
+ * lower cell in that period.
+ */
+struct CellTriangle {
+    uint32_t triangle;
+    glm::vec2 lo, hi;
+    glm::dvec2 corner[3];
+    double area;
+    int32_t x0, y0;
+};
+
+double cross(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+/**
+ * Area of the intersection of two counter-clockwise triangles: the first is
+ * clipped by the three edge half-planes of the second (Sutherland-Hodgman).
+ */
+double intersectionArea(const glm::dvec2* a, const glm::dvec2* b) {
+    glm::dvec2 buffers[2][9];
+    glm::dvec2* polygon = buffers[0];
+    glm::dvec2* clipped = buffers[1];
+    int count = 3;
+    std::copy(a, a + 3, polygon);
+    for (int e = 0; e < 3 && count > 0; e++) {
+        const glm::dvec2& p = b[e];
+        const glm::dvec2& q = b[(e + 1) % 3];
+        int clippedCount = 0;
+        for (int i = 0; i < count; i++) {
+            const glm::dvec2& s = polygon[i];
+            const glm::dvec2& t = polygon[(i + 1) % count];
+            const double ds = cross(p, q, s);
+            const double dt = cross(p, q, t);
+            if (ds >= 0.0) {
+                clipped[clippedCount++] = s;
+            }
+            if ((ds >= 0.0) != (dt >= 0.0)) {
+                clipped[clippedCount++] = s + (t - s) * (ds / (ds - dt));
+            }
+        }
+        std::swap(polygon, clipped);
+        count = clippedCount;
+    }
+    double area = 0.0;
+    for (int i = 0; i < count; i++) {
+        const glm::dvec2& s = polygon[i];
+        const glm::dvec2& t = polygon[(i + 1) % count];
+        area += s.x * t.y - s.y * t.x;
+    }
+    return area * 0.5;
+}
+
+/**
+ * Pairs and sums of one task of the cell pass.
+ */
+struct TaskPairs {
+    std::vector<UVOverlapPair> pairs;
+    size_t candidates = 0;
+    double area = 0.0;
+};
+
+} // namespace
+
+UVOverlapReport UVOverlap::detect(const std::vector<unsigned int>& indices, const std::vector<glm::vec2>& uvs,
+                                  const UVOverlapOptions& options) {
+    auto detectStart = std::chrono::high_resolution_clock::now();
+    UVOverlapReport report;
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || triangleCount > UINT32_MAX) {
+        return report;
+    }
+    ThreadPool& pool = ThreadPool::global();
+
+    // Bounds of every triangle, in its own period when wrapping
+    std::vector<TriangleBox> boxes(triangleCount);
+    const size_t taskCount = (triangleCount + kGrainSize - 1) / kGrainSize;
+    std::vector<size_t> validCounts(taskCount, 0);
+    std::vector<glm::vec2> taskMin(taskCount, glm::vec2(INFINITY)), taskMax(taskCount, glm::vec2(-INFINITY));
+    pool.parallelFor(triangleCount, kGrainSize, [&](size_t begin, size_t end) {
+        const size_t task = begin / kGrainSize;
+        for (size_t t = begin; t < end; t++) {
+            TriangleBox& box = boxes[t];
+            box.valid = false;
+            const unsigned int i0 = indices[t * 3], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+            if (i0 >= uvs.size() || i1 >= uvs.size() || i2 >= uvs.size()) {
+                continue;
+            }
+            const glm::vec2 &a = uvs[i0], &b = uvs[i1], &c = uvs[i2];
+            const float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+            if (area == 0.0f || !std::isfinite(area)) {
+                continue;
+            }
+            box.lo = glm::min(a, glm::min(b, c));
+            box.hi = glm::max(a, glm::max(b, c));
+            box.offset = options.wrap ? glm::floor(box.lo) : glm::vec2(0.0f);
+            box.lo -= box.offset;
+            box.hi -= box.offset;
+            box.valid = true;
+            validCounts[task]++;
+            taskMin[task] = glm::min(taskMin[task], box.lo);
+            taskMax[task] = glm::max(taskMax[task], box.hi);
+        }
+    });
+    size_t validTriangles = 0;
+    glm::vec2 boundsMin(INFINITY), boundsMax(-INFINITY);
+    for (size_t task = 0; task < taskCount; task++) {
+        validTriangles += validCounts[task];
+        boundsMin = glm::min(boundsMin, taskMin[task]);
+        boundsMax = glm::max(boundsMax, taskMax[task]);
+    }
+    if (validTriangles < 2) {
+        return report;
+    }
+
+    // About one triangle per cell; the wrapped grid spans one period
+    const int32_t gridSize = static_cast<int32_t>(
+        std::min<size_t>(kMaxGridSize, std::max<size_t>(1, static_cast<size_t>(std::sqrt(double(validTriangles))))));
+    report.gridSize = static_cast<unsigned int>(gridSize);
+    const glm::vec2 origin = options.wrap ? glm::vec2(0.0f) : boundsMin;
+    const glm::vec2 extent = options.wrap ? glm::vec2(1.0f) : glm::max(boundsMax - boundsMin, glm::vec2(1e-30f));
+    const glm::vec2 cellScale = static_cast<float>(gridSize) / extent;
+    auto cellOf = [&](float value, float start, float scale) {
+        const float cell = std::floor((value - start) * scale);
+        if (options.wrap) {
+            return static_cast<int32_t>(std::min(cell, 2.0f * gridSize));
+        }
+        return static_cast<int32_t>(std::min(std::max(cell, 0.0f), static_cast<float>(gridSize - 1)));
+    };
+    pool.parallelFor(triangleCount, kGrainSize, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            TriangleBox& box = boxes[t];
+            if (!box.valid) {
+                continue;
+            }
+            box.x0 = cellOf(box.lo.x, origin.x, cellScale.x);
+            box.y0 = cellOf(box.lo.y, origin.y, cellScale.y);
+            // Spans are capped at one period and a cell
+            box.x1 = std::min(cellOf(box.hi.x, origin.x, cellScale.x), box.x0 + gridSize);
+            box.y1 = std::min(cellOf(box.hi.y, origin.y, cellScale.y), box.y0 + gridSize);
+        }
+    });
+
+    // Cell lists by counting sort; triangles stay in ascending order per cell
+    const size_t cellCount = static_cast<size_t>(gridSize) * gridSize;
+    std::vector<uint32_t> cellStart(cellCount + 1, 0);
+    for (const TriangleBox& box : boxes) {
+        if (!box.valid) {
+            continue;
+        }
+        for (int32_t y = box.y0; y <= box.y1; y++) {
+            const size_t row = static_cast<size_t>(y % gridSize) * gridSize;
+            for (int32_t x = box.x0; x <= box.x1; x++) {
+                cellStart[row + x % gridSize + 1]++;
+            }
+        }
+    }
+    for (size_t cell = 0; cell < cellCount; cell++) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+    std::vector<CellEntry> cellEntries(cellStart[cellCount]);
+    {
+        std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+        for (size_t t = 0; t < triangleCount; t++) {
+            const TriangleBox& box = boxes[t];
+            if (!box.valid) {
+                continue;
+            }
+            for (int32_t y = box.y0; y <= box.y1; y++) {
+                const size_t row = static_cast<size_t>(y % gridSize) * gridSize;
+                for (int32_t x = box.x0; x <= box.x1; x++) {
+                    cellEntries[fill[row + x % gridSize]++] = { static_cast<uint32_t>(t),
+                                                                static_cast<uint16_t>(x / gridSize),
+                                                                static_cast<uint16_t>(y / gridSize) };
+                }
+            }
+        }
+    }
+
+    // Pairs of every cell; a pair is tested only in the cell holding the
+    // lower corner of its bounding box intersection
+    const size_t cellTasks = (cellCount + kCellGrain - 1) / kCellGrain;
+    std::vector<TaskPairs> taskPairs(cellTasks);
+    pool.parallelFor(cellCount, kCellGrain, [&](size_t begin, size_t end) {
+        TaskPairs& result = taskPairs[begin / kCellGrain];
+        std::vector<CellTriangle> local;
+        for (size_t cell = begin; cell < end; cell++) {
+            const uint32_t first = cellStart[cell], last = cellStart[cell + 1];
+            if (last - first < 2) {
+                continue;
+            }
+            const int32_t cx = static_cast<int32_t>(cell % gridSize);
+            const int32_t cy = static_cast<int32_t>(cell / gridSize);
+            local.resize(last - first);
+            for (uint32_t k = first; k < last; k++) {
+                const uint32_t t = cellEntries[k].triangle;
+                const int32_t shiftX = cellEntries[k].shiftX, shiftY = cellEntries[k].shiftY;
+                const TriangleBox& box = boxes[t];
+                CellTriangle& entry = local[k - first];
+                const glm::vec2 shift(static_cast<float>(shiftX), static_cast<float>(shiftY));
+                entry.triangle = t;
+                entry.lo = box.lo - shift;
+                entry.hi = box.hi - shift;
+                entry.x0 = box.x0 - shiftX * gridSize;
+                entry.y0 = box.y0 - shiftY * gridSize;
+                const glm::dvec2 move = glm::dvec2(box.offset) + glm::dvec2(shift);
+                for (int c = 0; c < 3; c++) {
+                    entry.corner[c] = glm::dvec2(uvs[indices[t * 3 + c]]) - move;
+                }
+                entry.area = cross(entry.corner[0], entry.corner[1], entry.corner[2]);
+                if (entry.area < 0.0) {
+                    std::swap(entry.corner[1], entry.corner[2]);
+                    entry.area = -entry.area;
+                }
+                entry.area *= 0.5;
+            }
+            for (size_t i = 0; i + 1 < local.size(); i++) {
+                const CellTriangle& a = local[i];
+                for (size_t j = i + 1; j < local.size(); j++) {
+                    const CellTriangle& b = local[j];
+                    if (a.triangle == b.triangle || a.lo.x >= b.hi.x || b.lo.x >= a.hi.x || a.lo.y >= b.hi.y || b.lo.y >= a.hi.y ||
+                        std::max(a.x0, b.x0) != cx || std::max(a.y0, b.y0) != cy) {
+                        continue;
+                    }
+                    result.candidates++;
+                    const double area = intersectionArea(a.corner, b.corner);
+                    if (area > options.minRelativeArea * std::min(a.area, b.area)) {
+                        result.pairs.push_back({ a.triangle, b.triangle, static_cast<float>(area) });
+                        result.area += area;
+                    }
+                }
+            }
+        }
+    });
+
+    // Merge in cell order
+    std::vector<unsigned char> overlapping(triangleCount, 0);
+    for (const TaskPairs& result : taskPairs) {
+        report.candidatePairs += result.candidates;
+        report.overlapArea += result.area;
+        report.pairCount += result.pairs.size();
+        for (const UVOverlapPair& pair : result.pairs) {
+            report.overlappingTriangles += !overlapping[pair.first] + !overlapping[pair.second];
+            overlapping[pair.first] = overlapping[pair.second] = 1;
+            if (report.pairs.size() < options.maxPairs) {
+                report.pairs.push_back(pair);
+            }
+        }
+    }
+    report.detectMs =
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - detectStart).count();
+    return report;
+}
@@ -0,0 +1,836 @@
+#include "UVProjector.h"
+#include "ABF.h"
+#include "ChartSegmenter.h"
+#include "LSCM.h"
+#include "MeshTopology.h"
+#include "MeshKernels.h"
+#include "TexelDensity.h"
+#include "ThreadPool.h"
+#include "UVChart.h"
+#include "UVMetrics.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+const float kPi = 3.14159f;
+
+// Vertices per parallel span and per scratch block inside a span
+const size_t kBlockSize = 4096;
+
+/**
+ * Splits a span into scratch-sized blocks: body(blockFirst, blockCount).
+ */
+template <typename Body>
+void forEachBlock(size_t first, size_t count, Body body) {
+    for (size_t offset = 0; offset < count; offset += kBlockSize) {
+        body(first + offset, std::min(kBlockSize, count - offset));
+    }
+}
+
+void computeAtan2(bool strictMath, const float* y, const float* x, size_t count, float* out) {
+    if (strictMath) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = std::atan2(y[i], x[i]);
+        }
+    } else {
+        MeshKernels::atan2Approx(y, x, count, out);
+    }
+}
+
+void computeAsin(bool strictMath, const float* x, size_t count, float* out) {
+    if (strictMath) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = std::asin(glm::clamp(x[i], -1.0f, 1.0f));
+        }
+    } else {
+        MeshKernels::asinApprox(x, count, out);
+    }
+}
+
+/**
+ * The two axes spanning the plane perpendicular to an axis.
+ */
+void perpendicularAxes(int axis, int& first, int& second) {
+    first = axis == 0 ? 1 : 0;
+    second = axis == 2 ? 1 : 2;
+}
+
+/**
+ * Planar mapping onto the plane perpendicular to the thinnest bounding box axis.
+ */
+class PlanarProjector : public UVProjector {
+public:
+    const char* name() const override { return "planar"; }
+
+    void prepare(const UVProjectionContext& context) override {
+        glm::vec3 extents = context.maxBounds - context.minBounds;
+        int normalAxis = 0;
+        for (int axis = 1; axis < 3; axis++) {
+            if (extents[axis] < extents[normalAxis]) {
+                normalAxis = axis;
+            }
+        }
+        perpendicularAxes(normalAxis, axisU, axisV);
+    }
+
+    void project(const UVProjectionContext& context, size_t first, size_t count, glm::vec2* uvs) const override {
+        const glm::vec3 dimensions = context.maxBounds - context.minBounds;
+        const size_t scratchSize = std::min(kBlockSize, count);
+        std::vector<float> scratch(scratchSize * 3);
+        float* normalized[3] = { scratch.data(), scratch.data() + scratchSize, scratch.data() + 2 * scratchSize };
+        forEachBlock(first, count, [&](size_t blockFirst, size_t blockCount) {
+            MeshKernels::normalizeToBox(*context.positions, blockFirst, blockCount, context.minBounds, dimensions,
+                                        normalized[0], normalized[1], normalized[2]);
+            glm::vec2* out = uvs + (blockFirst - first);
+            for (size_t j = 0; j < blockCount; j++) {
+                out[j] = glm::vec2(normalized[axisU][j], normalized[axisV][j]);
+            }
+        });
+    }
+
+private:
+    int axisU = 0;  ///< Box axis mapped to u
+    int axisV = 2;  ///< Box axis mapped to v
+};
+
+/**
+ * Box (triplanar) mapping: every vertex is projected along the dominant axis
+ * of its normal, or of its direction from the center if it has no normal.
+ */
+class BoxProjector : public UVProjector {
+public:
+    const char* name() const override { return "box"; }
+
+    void project(const UVProjectionContext& context, size_t first, size_t count, glm::vec2* uvs) const override {
+        const glm::vec3 dimensions = context.maxBounds - context.minBounds;
+        const glm::vec3 center = (context.minBounds + context.maxBounds) * 0.5f;
+        const bool hasNormals = context.normals && context.normals->size() == context.positions->size();
+        const size_t scratchSize = std::min(kBlockSize, count);
+        std::vector<float> scratch(scratchSize * 3);
+        float* normalized[3] = { scratch.data(), scratch.data() + scratchSize, scratch.data() + 2 * scratchSize };
+        forEachBlock(first, count, [&](size_t blockFirst, size_t blockCount) {
+            MeshKernels::normalizeToBox(*context.positions, blockFirst, blockCount, context.minBounds, dimensions,
+                                        normalized[0], normalized[1], normalized[2]);
+            glm::vec2* out = uvs + (blockFirst - first);
+            for (size_t j = 0; j < blockCount; j++) {
+                const size_t i = blockFirst + j;
+                glm::vec3 direction = hasNormals ? (*context.normals)[i] : (*context.positions)[i] - center;
+                glm::vec3 magnitude = glm::abs(direction);
+                int axis = magnitude.x >= magnitude.y ? (magnitude.x >= magnitude.z ? 0 : 2)
+                                                      : (magnitude.y >= magnitude.z ? 1 : 2);
+                int axisU, axisV;
+                perpendicularAxes(axis, axisU, axisV);
+                out[j] = glm::vec2(normalized[axisU][j], normalized[axisV][j]);
+            }
+        });
+    }
+};
+
+/**
+ * Cylindrical mapping around the longest bounding box axis: u is the angle
+ * around the axis, v the height along it.
+ */
+class CylindricalProjector : public UVProjector {
+public:
+    const char* name() const override { return "cylindrical"; }
+
+    void prepare(const UVProjectionContext& context) override {
+        glm::vec3 extents = context.maxBounds - context.minBounds;
+        axis = 0;
+        for (int candidate = 1; candidate < 3; candidate++) {
+            if (extents[candidate] > extents[axis]) {
+                axis = candidate;
+            }
+        }
+    }
+
+    void project(const UVProjectionContext& context, size_t first, size_t count, glm::vec2* uvs) const override {
+        const glm::vec3 center = (context.minBounds + context.maxBounds) * 0.5f;
+        const float height = context.maxBounds[axis] - context.minBounds[axis];
+        int axisA, axisB;
+        perpendicularAxes(axis, axisA, axisB);
+        const float* coordinates[3] = { context.positions->x.data(), context.positions->y.data(),
+                                        context.positions->z.data() };
+
+        const size_t scratchSize = std::min(kBlockSize, count);
+        std::vector<float> scratch(scratchSize * 3);
+        float* offsetA = scratch.data();
+        float* offsetB = offsetA + scratchSize;
+        float* theta = offsetB + scratchSize;
+        forEachBlock(first, count, [&](size_t blockFirst, size_t blockCount) {
+            for (size_t j = 0; j < blockCount; j++) {
+                offsetA[j] = coordinates[axisA][blockFirst + j] - center[axisA];
+                offsetB[j] = coordinates[axisB][blockFirst + j] - center[axisB];
+            }
+            computeAtan2(context.strictMath, offsetB, offsetA, blockCount, theta);
+            glm::vec2* out = uvs + (blockFirst - first);
+            for (size_t j = 0; j < blockCount; j++) {
+                float u = (theta[j] + kPi) / (2.0f * kPi);
+                float v = height > 0.0f ? (coordinates[axis][blockFirst + j] - context.minBounds[axis]) / height : 0.0f;
+                out[j] = glm::vec2(u, v);
+            }
+        });
+    }
+
+private:
+    int axis = 1;  ///< Cylinder axis
+};
+
+/**
+ * Spherical (latitude/longitude) mapping around the bounding box center.
+ */
+class SphericalProjector : public UVProjector {
+public:
+    const char* name() const override { return "spherical"; }
+
+    void project(const UVProjectionContext& context, size_t first, size_t count, glm::vec2* uvs) const override {
+        const glm::vec3 center = (context.minBounds + context.maxBounds) * 0.5f;
+        const size_t scratchSize = std::min(kBlockSize, count);
+        std::vector<float> scratch(scratchSize * 5);
+        float* dirX = scratch.data();
+        float* dirY = dirX + scratchSize;
+        float* dirZ = dirY + scratchSize;
+        float* theta = dirZ + scratchSize;
+        float* phi = theta + scratchSize;
+        forEachBlock(first, count, [&](size_t blockFirst, size_t blockCount) {
+            MeshKernels::projectToSphere(*context.positions, blockFirst, blockCount, center, dirX, dirY, dirZ);
+            computeAtan2(context.strictMath, dirZ, dirX, blockCount, theta);
+            computeAsin(context.strictMath, dirY, blockCount, phi);
+            glm::vec2* out = uvs + (blockFirst - first);
+            for (size_t j = 0; j < blockCount; j++) {
+                out[j] = glm::vec2(0.5f + theta[j] / (2.0f * kPi), 0.5f - phi[j] / kPi);
+            }
+        });
+    }
+};
+
+/**
+ * The original default mapping: planar (XZ) for parts facing up or down,
+ * cylindrical for the sides.
+ */
+class HybridProjector : public UVProjector {
+public:
+    const char* name() const override { return "hybrid"; }
+
+    void project(const UVProjectionContext& context, size_t first, size_t count, glm::vec2* uvs) const override {
+        const glm::vec3 dimensions = context.maxBounds - context.minBounds;
+        const glm::vec3 center = (context.minBounds + context.maxBounds) * 0.5f;
+        const size_t scratchSize = std::min(kBlockSize, count);
+        std::vector<float> scratch(scratchSize * 7);
+        float* posX = scratch.data();
+        float* posY = posX + scratchSize;
+        float* posZ = posY + scratchSize;
+        float* dirX = posZ + scratchSize;
+        float* dirY = dirX + scratchSize;
+        float* dirZ = dirY + scratchSize;
+        float* theta = dirZ + scratchSize;
+        forEachBlock(first, count, [&](size_t blockFirst, size_t blockCount) {
+            // Position normalized to the [0,1] box and direction from the center
+            MeshKernels::normalizeToBox(*context.positions, blockFirst, blockCount, context.minBounds, dimensions,
+                                        posX, posY, posZ);
+            MeshKernels::projectToSphere(*context.positions, blockFirst, blockCount, center, dirX, dirY, dirZ);
+            computeAtan2(context.strictMath, dirZ, dirX, blockCount, theta);
+
+            glm::vec2* out = uvs + (blockFirst - first);
+            for (size_t j = 0; j < blockCount; j++) {
+                // dot(direction, up) is the direction's y
+                float upwardness = dirY[j];
+                if (std::fabs(upwardness) > 0.7f) {
+                    // For top/bottom parts, use planar mapping using XZ coordinates
+                    out[j] = glm::vec2(posX[j], posZ[j]);
+                } else {
+                    // For sides, use cylindrical mapping
+                    float u_cylindrical = (theta[j] + kPi) / (2.0f * kPi);
+                    float v_cylindrical = (dirY[j] + 1.0f) * 0.5f;
+                    out[j] = glm::vec2(u_cylindrical, v_cylindrical);
+                }
+            }
+        });
+    }
+};
+
+/**
+ * Segmentation-based mapping for articulated models: the model is split into
+ * height bands with cylindrical mapping for the bottom (legs, tail), a
+ * cylindrical/spherical blend for the middle (body, arms) and spherical
+ * mapping for the top (head, ears), each around its band's centroid. The
+ * result is relaxed over the mesh, leaving the band boundaries and the
+ * wrap-around seams in place.
+ */
+class SegmentedProjector : public UVProjector {
+public:
+    const char* name() const override { return "segmented"; }
+
+    void prepare(const UVProjectionContext& context) override {
+        // Segment centers from per-task partial sums merged in task order, so the
+        // result does not depend on the thread count
+        const PositionArray& positions = *context.positions;
+        const size_t vertexTotal = positions.size();
+        const size_t taskCount = (vertexTotal + kBlockSize - 1) / kBlockSize;
+        std::vector<double> partialSums(taskCount * kSegments * 3, 0.0);
+        std::vector<size_t> partialCounts(taskCount * kSegments, 0);
+        ThreadPool::global().parallelFor(vertexTotal, kBlockSize, [&](size_t begin, size_t end) {
+            const size_t task = begin / kBlockSize;
+            for (size_t i = begin; i < end; i++) {
+                int segment = segmentOf(context, positions.y[i]);
+                double* sum = &partialSums[(task * kSegments + segment) * 3];
+                sum[0] += positions.x[i];
+                sum[1] += positions.y[i];
+                sum[2] += positions.z[i];
+                partialCounts[task * kSegments + segment]++;
+            }
+        });
+
+        size_t segmentCounts[kSegments];
+        for (int segment = 0; segment < kSegments; segment++) {
+            double sum[3] = { 0.0, 0.0, 0.0 };
+            size_t count = 0;
+            for (size_t task = 0; task < taskCount; task++) {
+                for (int axis = 0; axis < 3; axis++) {
+                    sum[axis] += partialSums[(task * kSegments + segment) * 3 + axis];
+                }
+                count += partialCounts[task * kSegments + segment];
+            }
+            segmentCounts[segment] = count;
+            segmentCenters[segment] = count > 0
+                ? glm::vec3(static_cast<float>(sum[0] / count), static_cast<float>(sum[1] / count),
+                            static_cast<float>(sum[2] / count))
+                : glm::vec3(0.0f);
+        }
+
+        // Mean distance to the band center: around the vertical axis for the
+        // cylindrical bands, in all directions for the spherical ones
+        std::vector<double> partialRadii(taskCount * kSegments, 0.0);
+        ThreadPool::global().parallelFor(vertexTotal, kBlockSize, [&](size_t begin, size_t end) {
+            const size_t task = begin / kBlockSize;
+            for (size_t i = begin; i < end; i++) {
+                int segment = segmentOf(context, positions.y[i]);
+                const glm::vec3 offset = positions[i] - segmentCenters[segment];
+                partialRadii[task * kSegments + segment] += segment >= kSphericalSegment
+                    ? glm::length(offset)
+                    : std::sqrt(offset.x * offset.x + offset.z * offset.z);
+            }
+        });
+
+        // Texture length per band: circumference by band height for the
+        // cylindrical bands, circumference by half a great circle for the
+        // spherical ones
+        const float bandHeight = (context.maxBounds.y - context.minBounds.y) / kSegments;
+        glm::vec2 bandLengths[kSegments];
+        float circumferenceSum = 0.0f;
+        int usedSegments = 0;
+        for (int segment = 0; segment < kSegments; segment++) {
+            double radius = 0.0;
+            for (size_t task = 0; task < taskCount; task++) {
+                radius += partialRadii[task * kSegments + segment];
+            }
+            radius = segmentCounts[segment] > 0 ? radius / segmentCounts[segment] : 0.0;
+            const float circumference = 2.0f * kPi * static_cast<float>(radius);
+            bandLengths[segment] =
+                glm::vec2(circumference, segment >= kSphericalSegment ? 0.5f * circumference : bandHeight);
+            if (segmentCounts[segment] > 0) {
+                circumferenceSum += circumference;
+                usedSegments++;
+            }
+        }
+
+        // One density for all bands: the requested one, or the one at which an
+        // average band wraps around kRepeats times. Repeats around a band are
+        // whole numbers, so the wrap-around seam stays continuous.
+        const float meanCircumference = usedSegments > 0 ? circumferenceSum / usedSegments : 0.0f;
+        float repeatsPerUnit = meanCircumference > 0.0f ? kRepeats / meanCircumference : 0.0f;
+        if (context.texelDensity.texelsPerUnit > 0.0f && context.atlas.resolution > 0) {
+            repeatsPerUnit = context.texelDensity.texelsPerUnit / static_cast<float>(context.atlas.resolution);
+        }
+        for (int segment = 0; segment < kSegments; segment++) {
+            const glm::vec2 repeats = bandLengths[segment] * repeatsPerUnit;
+            segmentRepeats[segment] =
+                glm::vec2(std::max(1.0f, std::round(repeats.x)), repeats.y > 0.0f ? repeats.y : kRepeats);
+        }
+    }
+
+    void project(const UVProjectionContext& context, size_t first, size_t count, glm::vec2* uvs) const override {
+        const PositionArray& positions = *context.positions;
+        const glm::vec3 dimensions = context.maxBounds - context.minBounds;
+        const size_t scratchSize = std::min(kBlockSize, count);
+        std::vector<float> scratch(scratchSize * 6);
+        float* dirX = scratch.data();
+        float* dirY = dirX + scratchSize;
+        float* dirZ = dirY + scratchSize;
+        float* theta = dirZ + scratchSize;
+        float* phi = theta + scratchSize;
+        float* radial = phi + scratchSize;
+
+        forEachBlock(first, count, [&](size_t blockFirst, size_t blockCount) {
+            for (size_t j = 0; j < blockCount; j++) {
+                int segment = segmentOf(context, positions.y[blockFirst + j]);
+                glm::vec3 dir = positions[blockFirst + j] - segmentCenters[segment];
+                if (segment >= kBlendedSegment) {
+                    float length = glm::length(dir);
+                    dir = length > 0.0f ? dir / length : glm::vec3(0.0f, 1.0f, 0.0f);
+                }
+                dirX[j] = dir.x;
+                dirY[j] = dir.y;
+                dirZ[j] = dir.z;
+                radial[j] = std::sqrt(dir.x * dir.x + dir.z * dir.z);
+            }
+            computeAtan2(context.strictMath, dirZ, dirX, blockCount, theta);
+            computeAsin(context.strictMath, dirY, blockCount, phi);
+
+            glm::vec2* out = uvs + (blockFirst - first);
+            for (size_t j = 0; j < blockCount; j++) {
+                const float y = positions.y[blockFirst + j];
+                int segment = segmentOf(context, y);
+                float segmentYMin = context.minBounds.y + (segment * dimensions.y) / kSegments;
+                float segmentYMax = context.minBounds.y + ((segment + 1) * dimensions.y) / kSegments;
+                float segmentHeight = segmentYMax - segmentYMin;
+                float heightInSegment = segmentHeight > 0.0f ? (y - segmentYMin) / segmentHeight : 0.0f;
+
+                float u_cylindrical = (theta[j] + kPi) / (2.0f * kPi);
+                float u_spherical = 0.5f + theta[j] / (2.0f * kPi);
+                float v_spherical = 0.5f - phi[j] / kPi;
+
+                glm::vec2 uv;
+                if (segment < kBlendedSegment) {
+                    // Bottom segments - cylindrical mapping, height normalized within the segment
+                    uv = glm::vec2(u_cylindrical, heightInSegment);
+                } else if (segment < kSphericalSegment) {
+                    // Middle segments - cylindrical, blended towards spherical for extremities
+                    float u = u_cylindrical;
+                    float v = heightInSegment;
+                    float distFromAxis = radial[j];
+                    if (distFromAxis > 0.4f) {
+                        float extremityBlend = (distFromAxis - 0.4f) / 0.6f;
+                        u = glm::mix(u, u_spherical, extremityBlend);
+                        v = glm::mix(v, v_spherical, extremityBlend);
+                    }
+                    uv = glm::vec2(u, v);
+                } else {
+                    // Top segments - spherical mapping
+                    uv = glm::vec2(u_spherical, v_spherical);
+                }
+                uv *= segmentRepeats[segment];
+
+                // Ensure UVs are in [0,1] range for proper texture wrapping
+                out[j] = glm::fract(uv);
+            }
+        });
+    }
+
+    void refine(const UVProjectionContext& context, std::vector<glm::vec2>& uvs) override {
+        if (!context.indices || context.indices->empty() || context.smoothing.iterations == 0) {
+            return;
+        }
+        // Reuse the caller's topology, or build it once and leave it there for the next run
+        MeshTopology localTopology;
+        MeshTopology& topology = context.topology ? *context.topology : localTopology;
+        if (topology.empty()) {
+            topology = MeshTopology::build(*context.positions, *context.indices);
+        }
+        UVSmoothingReport report = UVSmoother::smooth(topology, *context.indices, uvs, context.smoothing);
+        std::cout << "Relaxed segmented UVs: " << report.iterations << " Jacobi iterations in " << report.smoothMs
+                  << " ms, last step " << report.lastStep << ", " << report.freeVertices << " free / "
+                  << report.pinnedVertices << " pinned vertices" << std::endl;
+    }
+
+private:
+    static const int kSegments = 10;  ///< Number of height bands
+    static const int kBlendedSegment = 3;  ///< First band blended towards spherical, directions normalized
+    static const int kSphericalSegment = 7;  ///< First band mapped spherically
+    static constexpr float kRepeats = 2.0f;  ///< Texture repeats around a band of average circumference
+
+    static int segmentOf(const UVProjectionContext& context, float y) {
+        const float height = context.maxBounds.y - context.minBounds.y;
+        const float heightRatio = height > 0.0f ? (y - context.minBounds.y) / height : 0.0f;
+        return glm::clamp(static_cast<int>(heightRatio * kSegments), 0, kSegments - 1);
+    }
+
+    glm::vec3 segmentCenters[kSegments];  ///< Centroid of every height band
+    glm::vec2 segmentRepeats[kSegments];  ///< Texture repeats across every band, equal texel density for all
+};
+
+/**
+ * Base of the projectors that segment the mesh into disc charts, flatten
+ * every chart on its own and pack the charts into an atlas. The whole
+ * solve runs in prepare(); project() copies the result and seamSplit()
+ * holds the vertices duplicated along the seams.
+ */
+template <typename Report>
+class ChartProjector : public UVProjector {
+public:
+    void prepare(const UVProjectionContext& context) override {
+        result.assign(context.positions->size(), glm::vec2(0.0f));
+        split = UVSeamSplit();
+        if (!context.indices || context.indices->size() < 3) {
+            std::cerr << "Warning: " << name() << " needs a triangle list, UVs left at zero" << std::endl;
+            return;
+        }
+
+        Segmentation segmentation = ChartSegmenter::segment(*context.positions, *context.indices);
+        std::cout << "Segmented " << context.indices->size() / 3 << " triangles into " << segmentation.chartCount
+                  << " charts (" << segmentation.componentCount << " components, " << segmentation.discSplits
+                  << " disc splits, " << segmentation.seamEdges << " seam edges)" << std::endl;
+        std::vector<UVChart> charts = UVChart::fromSegmentation(*context.positions, *context.indices,
+                                                                segmentation.chartOfFace, segmentation.chartCount);
+        segmentation = Segmentation();
+        std::vector<Report> reports(charts.size());
+
+        // Small charts are solved concurrently, each on one thread; large ones
+        // one after another with the multithreaded assembly and solver
+        std::vector<size_t> smallCharts;
+        for (size_t c = 0; c < charts.size(); c++) {
+            if (charts[c].vertexCount() < kSmallChartVertices) {
+                smallCharts.push_back(c);
+            } else {
+                reports[c] = unwrap(charts[c]);
+            }
+        }
+        ThreadPool::global().run(smallCharts.size(), [&](size_t k) {
+            reports[smallCharts[k]] = unwrap(charts[smallCharts[k]]);
+        });
+        if (!charts.empty()) {
+            summarize(charts, reports);
+            const TexelDensityOptions& density = context.texelDensity;
+            if (density.equalize) {
+                TexelDensityReport equalized = TexelDensity::equalize(charts);
+                std::cout << "Equalized the texel density of " << equalized.charts << " charts in "
+                          << equalized.equalizeMs << " ms (spread " << equalized.spreadBefore << "x, "
+                          << equalized.degenerateCharts << " degenerate)" << std::endl;
+            }
+            AtlasReport atlas = density.texelsPerUnit > 0.0f
+                ? AtlasPacker::packAtDensity(charts, context.atlas, density.texelsPerUnit, density.maxResolution)
+                : AtlasPacker::pack(charts, context.atlas);
+            if (density.texelsPerUnit > 0.0f && atlas.texelsPerUnit < density.texelsPerUnit) {
+                std::cerr << "Warning: " << density.texelsPerUnit << " texels per unit need more than a "
+                          << density.maxResolution << " atlas" << std::endl;
+            }
+            std::cout << "Packed " << charts.size() << " charts into a " << atlas.resolution << "x"
+                      << atlas.resolution << " atlas in " << atlas.packMs << " ms ("
+                      << (context.atlas.rasterPacking ? "raster" : "skyline") << ", " << atlas.attempts
+                      << " passes): " << atlas.utilization * 100.0 << "% utilization, " << atlas.texelsPerUnit
+                      << " texels per unit, " << atlas.rotatedCharts << " charts turned" << std::endl;
+        }
+        cutSeams(context, charts);
+    }
+
+    void project(const UVProjectionContext& context, size_t first, size_t count, glm::vec2* uvs) const override {
+        (void)context;
+        std::copy(result.begin() + first, result.begin() + first + count, uvs);
+    }
+
+    const UVSeamSplit* seamSplit() const override { return split.sourceVertices.empty() ? nullptr : &split; }
+
+protected:
+    /**
+     * Flattens one chart; called concurrently for different charts.
+     */
+    virtual Report unwrap(UVChart& chart) const = 0;
+
+    /**
+     * Logs the statistics of a run.
+     */
+    virtual void summarize(const std::vector<UVChart>& charts, const std::vector<Report>& reports) const = 0;
+
+private:
+    static const size_t kSmallChartVertices = 1 << 14;  ///< Charts below this size are solved serially
+
+    /**
+     * The first chart to use a mesh vertex keeps it; later charts get a copy
+     * appended after the mesh vertices. Charts are visited in order, so the
+     * split does not depend on the thread count.
+     */
+    void cutSeams(const UVProjectionContext& context, const std::vector<UVChart>& charts) {
+        const unsigned int kUnclaimed = ~0u;
+        const size_t vertexTotal = context.positions->size();
+        std::vector<unsigned int> owner(vertexTotal, kUnclaimed);
+        std::vector<std::vector<unsigned int>> chartVertex(charts.size());
+        for (size_t c = 0; c < charts.size(); c++) {
+            const UVChart& chart = charts[c];
+            chartVertex[c].resize(chart.vertexCount());
+            for (size_t i = 0; i < chart.vertexCount(); i++) {
+                const unsigned int v = chart.vertices[i];
+                if (owner[v] == kUnclaimed) {
+                    owner[v] = static_cast<unsigned int>(c);
+                    result[v] = chart.uvs[i];
+                    chartVertex[c][i] = v;
+                } else {
+                    chartVertex[c][i] = static_cast<unsigned int>(vertexTotal + split.sourceVertices.size());
+                    split.sourceVertices.push_back(v);
+                    split.uvs.push_back(chart.uvs[i]);
+                }
+            }
+        }
+        if (split.sourceVertices.empty()) {
+            return;
+        }
+
+        // Every triangle belongs to exactly one chart, so the charts rewrite
+        // their own triangles concurrently
+        split.indices = *context.indices;
+        ThreadPool::global().run(charts.size(), [&](size_t c) {
+            const UVChart& chart = charts[c];
+            for (size_t t = 0; t < chart.triangleCount(); t++) {
+                for (int corner = 0; corner < 3; corner++) {
+                    split.indices[3 * chart.faces[t] + corner] = chartVertex[c][chart.indices[3 * t + corner]];
+                }
+            }
+        });
+    }
+
+    std::vector<glm::vec2> result;  ///< Laid out texture coordinates of all vertices
+    UVSeamSplit split;  ///< Vertices duplicated along the seams
+};
+
+/**
+ * Least Squares Conformal Maps of every chart.
+ */
+class LSCMProjector : public ChartProjector<LSCMReport> {
+public:
+    const char* name() const override { return "lscm"; }
+
+protected:
+    LSCMReport unwrap(UVChart& chart) const override { return LSCM::parameterize(chart); }
+
+    void summarize(const std::vector<UVChart>& charts, const std::vector<LSCMReport>& reports) const override {
+        size_t largest = 0, unconverged = 0;
+        unsigned int maxIterations = 0;
+        for (size_t c = 0; c < charts.size(); c++) {
+            if (reports[c].unknowns > reports[largest].unknowns) {
+                largest = c;
+            }
+            maxIterations = std::max(maxIterations, reports[c].solver.iterations);
+            unconverged += reports[c].unknowns > 0 && !reports[c].solver.converged ? 1 : 0;
+        }
+        const LSCMReport& report = reports[largest];
+        std::cout << "LSCM: " << charts.size() << " charts, largest " << report.unknowns << " unknowns / "
+                  << report.nonZeros << " non-zeros (assembly " << report.assemblyMs << " ms, "
+                  << report.solver.iterations << " CG iterations in " << report.solveMs << " ms, residual "
+                  << report.solver.relativeResidual << "), at most " << maxIterations << " iterations per chart"
+                  << std::endl;
+        if (unconverged > 0) {
+            std::cerr << "Warning: LSCM did not converge on " << unconverged << " charts" << std::endl;
+        }
+    }
+};
+
+/**
+ * ABF++ angle based flattening of every chart.
+ */
+class ABFProjector : public ChartProjector<ABFReport> {
+public:
+    const char* name() const override { return "abf"; }
+
+protected:
+    ABFReport unwrap(UVChart& chart) const override { return ABF::parameterize(chart); }
+
+    void summarize(const std::vector<UVChart>& charts, const std::vector<ABFReport>& reports) const override {
+        // Triangle-weighted mean and overall maximum of the angle distortion
+        size_t largest = 0, kept = 0;
+        unsigned int maxSteps = 0;
+        double triangles = 0.0, initialSum = 0.0, finalSum = 0.0, initialMax = 0.0, finalMax = 0.0;
+        for (size_t c = 0; c < charts.size(); c++) {
+            const ABFReport& report = reports[c];
+            if (charts[c].triangleCount() > charts[largest].triangleCount()) {
+                largest = c;
+            }
+            kept += report.applied ? 0 : 1;
+            maxSteps = std::max(maxSteps, report.newtonIterations);
+            const double weight = static_cast<double>(charts[c].triangleCount());
+            triangles += weight;
+            initialSum += weight * report.initialDistortion.mean;
+            finalSum += weight * report.distortion.mean;
+            initialMax = std::max(initialMax, report.initialDistortion.max);
+            finalMax = std::max(finalMax, report.distortion.max);
+        }
+        const ABFReport& report = reports[largest];
+        std::cout << "ABF++: " << charts.size() << " charts (" << kept << " kept LSCM), at most " << maxSteps
+                  << " Newton steps per chart; largest " << report.newtonIterations << " steps / "
+                  << report.linearIterations << " CG iterations in " << report.angleMs << " ms, gradient "
+                  << report.gradientNorm << ", layout " << report.layout.assemblyMs + report.layout.solveMs
+                  << " ms" << std::endl;
+        if (triangles > 0.0) {
+            std::cout << "ABF++: angle distortion mean " << initialSum / triangles << " -> " << finalSum / triangles
+                      << " deg, max " << initialMax << " -> " << finalMax << " deg (LSCM -> ABF++)" << std::endl;
+        }
+    }
+};
+
+template <typename Projector>
+UVProjectorRegistry::Factory factoryFor() {
+    return [] { return std::unique_ptr<UVProjector>(new Projector()); };
+}
+
+} // namespace
+
+void UVProjector::projectAll(UVProjector& projector, const UVProjectionContext& context, std::vector<glm::vec2>& uvs) {
+    const size_t vertexTotal = context.positions ? context.positions->size() : 0;
+    uvs.assign(vertexTotal, glm::vec2(0.0f));
+    if (vertexTotal == 0) {
+        return;
+    }
+    projector.prepare(context);
+    ThreadPool::global().parallelFor(vertexTotal, kBlockSize, [&](size_t begin, size_t end) {
+        projector.project(context, begin, end - begin, uvs.data() + begin);
+    });
+    projector.refine(context, uvs);
+}
+
+std::string UVProjector::projectBest(const std::vector<std::string>& candidates, const UVProjectionContext& context,
+                                     std::vector<glm::vec2>& uvs) {
+    std::string best;
+    double bestScore = std::numeric_limits<double>::infinity();
+    if (!context.indices) {
+        return best;
+    }
+    std::vector<glm::vec2> trial;
+    for (const std::string& name : candidates) {
+        std::unique_ptr<UVProjector> projector = UVProjectorRegistry::instance().create(name);
+        if (!projector) {
+            continue;
+        }
+        projectAll(*projector, context, trial);
+        if (projector->seamSplit()) {
+            continue;
+        }
+        UVMetricsReport metrics = UVMetrics::measure(*context.positions, *context.indices, trial);
+        const double score = UVMetrics::score(metrics);
+        std::cout << "Candidate " << name << ": score " << score << " (stretch " << metrics.stretchL2 << ", overlap "
+                  << metrics.overlap * 100.0 << "%, " << metrics.flippedTriangles << " flipped)" << std::endl;
+        if (best.empty() || score < bestScore) {
+            best = name;
+            bestScore = score;
+            uvs.swap(trial);
+        }
+    }
+    return best;
+}
+
+ShapeStatistics UVProjector::analyzeShape(const UVProjectionContext& context) {
+    ShapeStatistics statistics;
+    statistics.extents = context.maxBounds - context.minBounds;
+    for (int axis = 0; axis < 3; axis++) {
+        if (statistics.extents[axis] > statistics.extents[statistics.longestAxis]) {
+            statistics.longestAxis = axis;
+        }
+        if (statistics.extents[axis] < statistics.extents[statistics.shortestAxis]) {
+            statistics.shortestAxis = axis;
+        }
+    }
+    const float longest = statistics.extents[statistics.longestAxis];
+    const float shortest = statistics.extents[statistics.shortestAxis];
+    const float middle = statistics.extents.x + statistics.extents.y + statistics.extents.z - longest - shortest;
+    statistics.flatness = longest > 0.0f ? shortest / longest : 0.0f;
+    statistics.elongation = middle > 0.0f ? longest / middle : 1.0f;
+
+    const PositionArray& positions = *context.positions;
+    const size_t vertexTotal = positions.size();
+    if (vertexTotal == 0) {
+        return statistics;
+    }
+
+    // Distances to the centroid: mean and spread, from per-task partial sums
+    const size_t grainSize = 1 << 16;
+    const size_t taskCount = (vertexTotal + grainSize - 1) / grainSize;
+    std::vector<double> partial(taskCount * 3, 0.0);
+    ThreadPool::global().parallelFor(vertexTotal, grainSize, [&](size_t begin, size_t end) {
+        double* sum = &partial[(begin / grainSize) * 3];
+        for (size_t i = begin; i < end; i++) {
+            sum[0] += positions.x[i];
+            sum[1] += positions.y[i];
+            sum[2] += positions.z[i];
+        }
+    });
+    glm::vec3 centroid(0.0f);
+    for (int axis = 0; axis < 3; axis++) {
+        double sum = 0.0;
+        for (size_t task = 0; task < taskCount; task++) {
+            sum += partial[task * 3 + axis];
+        }
+        centroid[axis] = static_cast<float>(sum / vertexTotal);
+    }
+
+    std::fill(partial.begin(), partial.end(), 0.0);
+    ThreadPool::global().parallelFor(vertexTotal, grainSize, [&](size_t begin, size_t end) {
+        double* sum = &partial[(begin / grainSize) * 3];
+        for (size_t i = begin; i < end; i++) {
+            double distance = glm::length(positions[i] - centroid);
+            sum[0] += distance;
+            sum[1] += distance * distance;
+        }
+    });
+    double distanceSum = 0.0, distanceSquaredSum = 0.0;
+    for (size_t task = 0; task < taskCount; task++) {
+        distanceSum += partial[task * 3 + 0];
+        distanceSquaredSum += partial[task * 3 + 1];
+    }
+    double mean = distanceSum / vertexTotal;
+    double variance = std::max(0.0, distanceSquaredSum / vertexTotal - mean * mean);
+    statistics.radialVariation = mean > 0.0 ? static_cast<float>(std::sqrt(variance) / mean) : 0.0f;
+    return statistics;
+}
+
+std::string UVProjector::detect(const ShapeStatistics& statistics) {
+    // Nearly flat: a single planar projection has no distortion
+    if (statistics.flatness < 0.05f) {
+        return "planar";
+    }
+    // All vertices at a similar distance from the centroid: sphere-like
+    if (statistics.radialVariation < 0.12f) {
+        return "spherical";
+    }
+    // One dominant axis: tubes, bottles, limbs
+    if (statistics.elongation > 2.0f) {
+        return "cylindrical";
+    }
+    // Upright with protruding parts: characters and creatures
+    if (statistics.longestAxis == 1 && statistics.radialVariation > 0.25f) {
+        return "lscm";
+    }
+    return "box";
+}
+
+UVProjectorRegistry::UVProjectorRegistry() {
+    add("planar", factoryFor<PlanarProjector>());
+    add("box", factoryFor<BoxProjector>());
+    add("cylindrical", factoryFor<CylindricalProjector>());
+    add("spherical", factoryFor<SphericalProjector>());
+    add("segmented", factoryFor<SegmentedProjector>());
+    add("hybrid", factoryFor<HybridProjector>());
+    add("lscm", factoryFor<LSCMProjector>());
+    add("abf", factoryFor<ABFProjector>());
+}
+
+UVProjectorRegistry& UVProjectorRegistry::instance() {
+    static UVProjectorRegistry registry;
+    return registry;
+}
+
+void UVProjectorRegistry::add(const std::string& name, Factory factory) {
+    for (auto& entry : factories) {
+        if (entry.first == name) {
+            entry.second = std::move(factory);
+            return;
+        }
+    }
+    factories.emplace_back(name, std::move(factory));
+}
+
+std::unique_ptr<UVProjector> UVProjectorRegistry::create(const std::string& name) const {
+    for (const auto& entry : factories) {
+        if (entry.first == name) {
+            return entry.second();
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> UVProjectorRegistry::names() const {
+    std::vector<std::string> result;
+    for (const auto& entry : factories) {
+        result.push_back(entry.first);
+    }
+    return result;
+}
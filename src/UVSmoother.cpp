@@ -0,0 +1,124 @@
+#include "UVSmoother.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+namespace {
+
+// Welded vertices per parallel task
+const size_t kGrainSize = 1 << 14;
+
+// Fans with more half-edges than this are treated as broken and pinned
+const int kMaxValence = 1024;
+
+bool isSeam(const glm::vec2& a, const glm::vec2& b, float threshold) {
+    return std::abs(a.x - b.x) > threshold || std::abs(a.y - b.y) > threshold;
+}
+
+} // namespace
+
+UVSmoothingReport UVSmoother::smooth(const MeshTopology& topology, const std::vector<unsigned int>& indices,
+                                     std::vector<glm::vec2>& uvs, const UVSmoothingOptions& options) {
+    auto smoothStart = std::chrono::high_resolution_clock::now();
+    UVSmoothingReport report;
+    const size_t weldedTotal = topology.vertexCount();
+    if (options.iterations == 0 || weldedTotal == 0 || topology.halfEdgeCount() != indices.size() / 3 * 3 ||
+        topology.meshVertexCount() != uvs.size()) {
+        return report;
+    }
+    ThreadPool& pool = ThreadPool::global();
+
+    // UV of every welded vertex from one of its corners, and whether it may move
+    std::vector<glm::vec2> current(weldedTotal, glm::vec2(0.0f));
+    std::vector<unsigned char> pinned(weldedTotal, 1);
+    const size_t taskCount = (weldedTotal + kGrainSize - 1) / kGrainSize;
+    std::vector<size_t> freeCounts(taskCount, 0);
+    pool.parallelFor(weldedTotal, kGrainSize, [&](size_t begin, size_t end) {
+        size_t freeCount = 0;
+        for (size_t w = begin; w < end; w++) {
+            const int32_t start = topology.outgoingHalfEdge(static_cast<int32_t>(w));
+            if (start < 0) {
+                continue;
+            }
+            const glm::vec2 uv = uvs[indices[start]];
+            current[w] = uv;
+            bool closed = false, seam = false;
+            int32_t h = start;
+            for (int step = 0; step < kMaxValence && h >= 0 && !seam; step++) {
+                seam = uvs[indices[h]] != uv || isSeam(uv, uvs[indices[MeshTopology::next(h)]], options.seamThreshold);
+                h = topology.nextAroundVertex(h);
+                closed = h == start;
+                if (closed) {
+                    break;
+                }
+            }
+            if (closed && !seam) {
+                pinned[w] = 0;
+                freeCount++;
+            }
+        }
+        freeCounts[begin / kGrainSize] = freeCount;
+    });
+    for (size_t count : freeCounts) {
+        report.freeVertices += count;
+    }
+    report.pinnedVertices = weldedTotal - report.freeVertices;
+    if (report.freeVertices == 0) {
+        return report;
+    }
+
+    // Jacobi sweeps between two buffers; the sweep is built once and reads
+    // through pointers that swap every iteration
+    std::vector<glm::vec2> next(current);
+    glm::vec2* source = current.data();
+    glm::vec2* target = next.data();
+    std::vector<float> taskSteps(taskCount, 0.0f);
+    const std::function<void(size_t, size_t)> sweep = [&](size_t begin, size_t end) {
+        float largest = 0.0f;
+        for (size_t w = begin; w < end; w++) {
+            if (pinned[w]) {
+                continue;
+            }
+            const int32_t start = topology.outgoingHalfEdge(static_cast<int32_t>(w));
+            glm::vec2 sum(0.0f);
+            int valence = 0;
+            int32_t h = start;
+            do {
+                // A pinned neighbor may carry several UVs; take the one of this corner
+                const int32_t h1 = MeshTopology::next(h);
+                const int32_t neighbor = topology.origin(h1);
+                sum += pinned[neighbor] ? uvs[indices[h1]] : source[neighbor];
+                valence++;
+                h = topology.nextAroundVertex(h);
+            } while (h != start);
+            const glm::vec2 moved = source[w] + options.strength * (sum / static_cast<float>(valence) - source[w]);
+            largest = std::max(largest, std::max(std::abs(moved.x - source[w].x), std::abs(moved.y - source[w].y)));
+            target[w] = moved;
+        }
+        taskSteps[begin / kGrainSize] = largest;
+    };
+    for (unsigned int iteration = 0; iteration < options.iterations; iteration++) {
+        pool.parallelFor(weldedTotal, kGrainSize, sweep);
+        std::swap(source, target);
+        report.iterations++;
+        report.lastStep = *std::max_element(taskSteps.begin(), taskSteps.end());
+        if (report.lastStep <= options.tolerance) {
+            break;
+        }
+    }
+
+    // Copies of a free vertex all carried its UV, so they all take the result
+    pool.parallelFor(uvs.size(), 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            const int32_t w = topology.weldedVertex(v);
+            if (!pinned[w]) {
+                uvs[v] = source[w];
+            }
+        }
+    });
+    report.smoothMs =
+        std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - smoothStart).count();
+    return report;
+}
@@ -0,0 +1,456 @@
+#include "VertexFormat.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+/**
+ * IEEE 754 binary32 -> binary16 with round-to-nearest-even; overflow
+ * becomes infinity and tiny values become subnormals or zero.
+ */
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFFu) {
+        // Inf stays inf, NaN stays a quiet NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    }
+
+    int halfExponent = static_cast<int>(exponent) - 127 + 15;
+    if (halfExponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (halfExponent <= 0) {
+        if (halfExponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        // Subnormal: shift the implicit leading one into the mantissa
+        mantissa |= 0x800000u;
+        const int shift = 14 - halfExponent;
+        uint32_t halfMantissa = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (halfMantissa & 1u))) {
+            halfMantissa++;
+        }
+        return static_cast<uint16_t>(sign | halfMantissa);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        half++;  // May carry into the exponent, which is the correct rounding
+    }
+    return static_cast<uint16_t>(half);
+}
+
+float halfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Normalize the subnormal
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400u) == 0) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+    } else if (exponent == 0x1Fu) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline uint16_t toUnorm16(float value) {
+    return static_cast<uint16_t>(std::lround(glm::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+inline int16_t toSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(glm::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+inline float signNotZero(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+/**
+ * Octahedral normal encoding (Meyer et al. / Cigolle et al.).
+ */
+glm::vec2 octahedralEncode(const glm::vec3& normal) {
+    float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    if (l1 == 0.0f) {
+        return glm::vec2(0.0f);
+    }
+    glm::vec2 p(normal.x / l1, normal.y / l1);
+    if (normal.z < 0.0f) {
+        p = glm::vec2((1.0f - std::fabs(p.y)) * signNotZero(p.x), (1.0f - std::fabs(p.x)) * signNotZero(p.y));
+    }
+    return p;
+}
+
+glm::vec3 octahedralDecode(const glm::vec2& encoded) {
+    glm::vec3 n(encoded.x, encoded.y, 1.0f - std::fabs(encoded.x) - std::fabs(encoded.y));
+    float t = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    float length = glm::length(n);
+    return length > 0.0f ? n / length : glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+inline uint32_t packSnorm10(float value) {
+    int v = static_cast<int>(std::lround(glm::clamp(value, -1.0f, 1.0f) * 511.0f));
+    return static_cast<uint32_t>(v) & 0x3FFu;
+}
+
+inline float unpackSnorm10(uint32_t bits) {
+    int v = static_cast<int>(bits & 0x3FFu);
+    if (v & 0x200) {
+        v -= 0x400;
+    }
+    return std::max(static_cast<float>(v) / 511.0f, -1.0f);
+}
+
+inline float safeInverse(float value) {
+    return value > 0.0f ? 1.0f / value : 0.0f;
+}
+
+} // namespace
+
+VertexFormat VertexFormat::full() {
+    return VertexFormat();
+}
+
+VertexFormat VertexFormat::compact() {
+    VertexFormat format;
+    format.position = PositionEncoding::Unorm16;
+    format.texcoord = TexcoordEncoding::Unorm16;
+    format.normal = NormalEncoding::Octahedral16;
+    return format;
+}
+
+VertexFormat VertexFormat::half() {
+    VertexFormat format;
+    format.position = PositionEncoding::Half16;
+    format.texcoord = TexcoordEncoding::Unorm16;
+    format.normal = NormalEncoding::Snorm1010102;
+    return format;
+}
+
+bool VertexFormat::fromName(const std::string& name, VertexFormat& format) {
+    if (name == "full" || name == "float") {
+        format = full();
+    } else if (name == "compact") {
+        format = compact();
+    } else if (name == "half") {
+        format = half();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool VertexFormat::tangentFromName(const std::string& name, TangentEncoding& encoding) {
+    if (name == "none") {
+        encoding = TangentEncoding::None;
+    } else if (name == "float") {
+        encoding = TangentEncoding::Float32;
+    } else if (name == "packed") {
+        encoding = TangentEncoding::Snorm1010102;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+unsigned int VertexFormat::texcoordOffset() const {
+    return position == PositionEncoding::Float32 ? 12 : 8;
+}
+
+unsigned int VertexFormat::normalOffset() const {
+    return texcoordOffset() + (texcoord == TexcoordEncoding::Float32 ? 8 : 4);
+}
+
+unsigned int VertexFormat::tangentOffset() const {
+    return normalOffset() + (normal == NormalEncoding::Float32 ? 12 : 4);
+}
+
+unsigned int VertexFormat::stride() const {
+    static const unsigned int tangentSizes[] = { 0, 16, 4 };
+    return tangentOffset() + tangentSizes[static_cast<int>(tangent)];
+}
+
+unsigned int VertexFormat::attributeOffset(unsigned int attribute) const {
+    switch (attribute) {
+    case 0:
+        return 0;
+    case 1:
+        return texcoordOffset();
+    case 2:
+        return normalOffset();
+    default:
+        return tangentOffset();
+    }
+}
+
+unsigned int VertexFormat::attributeSize(unsigned int attribute) const {
+    switch (attribute) {
+    case 0:
+        return texcoordOffset();
+    case 1:
+        return normalOffset() - texcoordOffset();
+    case 2:
+        return tangentOffset() - normalOffset();
+    default:
+        return stride() - tangentOffset();
+    }
+}
+
+uint32_t VertexFormat::key() const {
+    return static_cast<uint32_t>(position) | (static_cast<uint32_t>(texcoord) << 4) | (static_cast<uint32_t>(normal) << 8)
+         | (static_cast<uint32_t>(tangent) << 12);
+}
+
+std::string VertexFormat::describe() const {
+    static const char* positionNames[] = { "float", "half", "unorm16" };
+    static const char* texcoordNames[] = { "float", "unorm16" };
+    static const char* normalNames[] = { "float", "oct16", "snorm10" };
+    static const char* tangentNames[] = { "", "/float", "/snorm10" };
+    return std::string(positionNames[static_cast<int>(position)]) + "/"
+         + texcoordNames[static_cast<int>(texcoord)] + "/"
+         + normalNames[static_cast<int>(normal)] + tangentNames[static_cast<int>(tangent)]
+         + " (" + std::to_string(stride()) + " B"
+         + (layout == VertexLayout::Split ? ", split)" : ")");
+}
+
+VertexPacker::VertexPacker(const VertexFormat& format, const glm::vec3& positionMin, const glm::vec3& positionMax,
+                           const glm::vec2& uvMin, const glm::vec2& uvMax)
+    : vertexFormat(format) {
+    if (format.position == PositionEncoding::Unorm16) {
+        vertexDecode.positionOffset = positionMin;
+        vertexDecode.positionScale = positionMax - positionMin;
+    }
+    if (format.texcoord == TexcoordEncoding::Unorm16) {
+        vertexDecode.uvOffset = uvMin;
+        vertexDecode.uvScale = uvMax - uvMin;
+    }
+    vertexDecode.octahedralNormals = format.normal == NormalEncoding::Octahedral16;
+
+    positionInverseScale = glm::vec3(safeInverse(vertexDecode.positionScale.x),
+                                     safeInverse(vertexDecode.positionScale.y),
+                                     safeInverse(vertexDecode.positionScale.z));
+    uvInverseScale = glm::vec2(safeInverse(vertexDecode.uvScale.x), safeInverse(vertexDecode.uvScale.y));
+}
+
+VertexPacker::VertexPacker(const VertexFormat& format, const VertexDecode& decode)
+    : vertexFormat(format), vertexDecode(decode) {
+    positionInverseScale = glm::vec3(safeInverse(decode.positionScale.x),
+                                     safeInverse(decode.positionScale.y),
+                                     safeInverse(decode.positionScale.z));
+    uvInverseScale = glm::vec2(safeInverse(decode.uvScale.x), safeInverse(decode.uvScale.y));
+}
+
+void VertexPacker::pack(const glm::vec3& position, const glm::vec2& uv, const glm::vec3& normal,
+                        const glm::vec4& tangent, unsigned char* destination) const {
+    packPosition(position, destination);
+    packTexcoord(uv, destination + vertexFormat.texcoordOffset());
+    packNormal(normal, destination + vertexFormat.normalOffset());
+    packTangent(tangent, destination + vertexFormat.tangentOffset());
+}
+
+void VertexPacker::packPosition(const glm::vec3& position, unsigned char* destination) const {
+    switch (vertexFormat.position) {
+    case PositionEncoding::Float32:
+        std::memcpy(destination, &position, sizeof(glm::vec3));
+        break;
+    case PositionEncoding::Half16: {
+        uint16_t halves[4] = { floatToHalf(position.x), floatToHalf(position.y), floatToHalf(position.z), 0 };
+        std::memcpy(destination, halves, sizeof(halves));
+        break;
+    }
+    case PositionEncoding::Unorm16: {
+        glm::vec3 normalized = (position - vertexDecode.positionOffset) * positionInverseScale;
+        uint16_t values[4] = { toUnorm16(normalized.x), toUnorm16(normalized.y), toUnorm16(normalized.z), 0 };
+        std::memcpy(destination, values, sizeof(values));
+        break;
+    }
+    }
+}
+
+void VertexPacker::packTexcoord(const glm::vec2& uv, unsigned char* destination) const {
+    if (vertexFormat.texcoord == TexcoordEncoding::Float32) {
+        std::memcpy(destination, &uv, sizeof(glm::vec2));
+    } else {
+        glm::vec2 normalized = (uv - vertexDecode.uvOffset) * uvInverseScale;
+        uint16_t values[2] = { toUnorm16(normalized.x), toUnorm16(normalized.y) };
+        std::memcpy(destination, values, sizeof(values));
+    }
+}
+
+void VertexPacker::packNormal(const glm::vec3& normal, unsigned char* destination) const {
+    switch (vertexFormat.normal) {
+    case NormalEncoding::Float32:
+        std::memcpy(destination, &normal, sizeof(glm::vec3));
+        break;
+    case NormalEncoding::Octahedral16: {
+        glm::vec2 encoded = octahedralEncode(normal);
+        int16_t values[2] = { toSnorm16(encoded.x), toSnorm16(encoded.y) };
+        std::memcpy(destination, values, sizeof(values));
+        break;
+    }
+    case NormalEncoding::Snorm1010102: {
+        uint32_t packed = packSnorm10(normal.x) | (packSnorm10(normal.y) << 10) | (packSnorm10(normal.z) << 20);
+        std::memcpy(destination, &packed, sizeof(packed));
+        break;
+    }
+    }
+}
+
+void VertexPacker::packTangent(const glm::vec4& tangent, unsigned char* destination) const {
+    switch (vertexFormat.tangent) {
+    case TangentEncoding::None:
+        break;
+    case TangentEncoding::Float32:
+        std::memcpy(destination, &tangent, sizeof(glm::vec4));
+        break;
+    case TangentEncoding::Snorm1010102: {
+        // The 2-bit w holds the sign as 1 or -1 (binary 11)
+        uint32_t packed = packSnorm10(tangent.x) | (packSnorm10(tangent.y) << 10) | (packSnorm10(tangent.z) << 20)
+                        | ((tangent.w < 0.0f ? 3u : 1u) << 30);
+        std::memcpy(destination, &packed, sizeof(packed));
+        break;
+    }
+    }
+}
+
+void VertexPacker::unpack(const unsigned char* source, glm::vec3& position, glm::vec2& uv, glm::vec3& normal,
+                          glm::vec4& tangent) const {
+    switch (vertexFormat.position) {
+    case PositionEncoding::Float32:
+        std::memcpy(&position, source, sizeof(glm::vec3));
+        break;
+    case PositionEncoding::Half16: {
+        uint16_t halves[4];
+        std::memcpy(halves, source, sizeof(halves));
+        position = glm::vec3(halfToFloat(halves[0]), halfToFloat(halves[1]), halfToFloat(halves[2]));
+        break;
+    }
+    case PositionEncoding::Unorm16: {
+        uint16_t values[4];
+        std::memcpy(values, source, sizeof(values));
+        glm::vec3 normalized(values[0] / 65535.0f, values[1] / 65535.0f, values[2] / 65535.0f);
+        position = normalized * vertexDecode.positionScale + vertexDecode.positionOffset;
+        break;
+    }
+    }
+
+    const unsigned char* texcoordSource = source + vertexFormat.texcoordOffset();
+    if (vertexFormat.texcoord == TexcoordEncoding::Float32) {
+        std::memcpy(&uv, texcoordSource, sizeof(glm::vec2));
+    } else {
+        uint16_t values[2];
+        std::memcpy(values, texcoordSource, sizeof(values));
+        uv = glm::vec2(values[0] / 65535.0f, values[1] / 65535.0f) * vertexDecode.uvScale + vertexDecode.uvOffset;
+    }
+
+    const unsigned char* normalSource = source + vertexFormat.normalOffset();
+    switch (vertexFormat.normal) {
+    case NormalEncoding::Float32:
+        std::memcpy(&normal, normalSource, sizeof(glm::vec3));
+        break;
+    case NormalEncoding::Octahedral16: {
+        int16_t values[2];
+        std::memcpy(values, normalSource, sizeof(values));
+        normal = octahedralDecode(glm::vec2(std::max(values[0] / 32767.0f, -1.0f), std::max(values[1] / 32767.0f, -1.0f)));
+        break;
+    }
+    case NormalEncoding::Snorm1010102: {
+        uint32_t packed;
+        std::memcpy(&packed, normalSource, sizeof(packed));
+        normal = glm::vec3(unpackSnorm10(packed), unpackSnorm10(packed >> 10), unpackSnorm10(packed >> 20));
+        break;
+    }
+    }
+
+    const unsigned char* tangentSource = source + vertexFormat.tangentOffset();
+    switch (vertexFormat.tangent) {
+    case TangentEncoding::None:
+        tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+        break;
+    case TangentEncoding::Float32:
+        std::memcpy(&tangent, tangentSource, sizeof(glm::vec4));
+        break;
+    case TangentEncoding::Snorm1010102: {
+        uint32_t packed;
+        std::memcpy(&packed, tangentSource, sizeof(packed));
+        tangent = glm::vec4(unpackSnorm10(packed), unpackSnorm10(packed >> 10), unpackSnorm10(packed >> 20),
+                            (packed >> 31) ? -1.0f : 1.0f);
+        break;
+    }
+    }
+}
+
+void VertexPacker::setupAttribute(unsigned int attribute) const {
+    const bool split = vertexFormat.layout == VertexLayout::Split;
+    const GLsizei stride = static_cast<GLsizei>(split ? vertexFormat.attributeSize(attribute) : vertexFormat.stride());
+    const size_t byteOffset = split ? 0 : vertexFormat.attributeOffset(attribute);
+    const void* offset = reinterpret_cast<const void*>(byteOffset);
+    glEnableVertexAttribArray(attribute);
+    switch (attribute) {
+    case 0:
+        switch (vertexFormat.position) {
+        case PositionEncoding::Float32:
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, offset);
+            break;
+        case PositionEncoding::Half16:
+            glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, stride, offset);
+            break;
+        case PositionEncoding::Unorm16:
+            glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, offset);
+            break;
+        }
+        break;
+    case 1:
+        if (vertexFormat.texcoord == TexcoordEncoding::Float32) {
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, offset);
+        } else {
+            glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, offset);
+        }
+        break;
+    case 2:
+        switch (vertexFormat.normal) {
+        case NormalEncoding::Float32:
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, offset);
+            break;
+        case NormalEncoding::Octahedral16:
+            glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE, stride, offset);
+            break;
+        case NormalEncoding::Snorm1010102:
+            glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, offset);
+            break;
+        }
+        break;
+    default:
+        if (vertexFormat.tangent == TangentEncoding::Float32) {
+            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, offset);
+        } else {
+            glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, offset);
+        }
+        break;
+    }
+}